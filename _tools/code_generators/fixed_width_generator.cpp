@@ -55,15 +55,20 @@ void FixedWidthGenerator::generateCode(const std::string filename,
     else  throw(runtime_error("Character is too high for code generation."
                 " Maximum allowed is 32bit"));
     if(aa) roundedHeight*=2;
+
+    //Compress glyphs even if not required, to report the size difference
+    vector<vector<unsigned char>> compressedData=compressGlyphs(
+        glyphs.size()*width*roundedHeight/8);
     
     //Write font info data
     std::vector<UnicodeBlock> blocks = UnicodeBlockManager::getAvailableBlocks();
     file<<"const bool "<<fontName<<"IsAntialiased="<<(aa?"true;\n":"false;\n")<<
           "const bool "<<fontName<<"IsFixedWidth=true;\n"<<
+          "const bool "<<fontName<<"IsCompressed="<<(compressed?"true;\n":"false;\n")<<
           "const unsigned char "<<fontName<<"Height="<<height<<";\n"<<
           "const unsigned char "<<fontName<<"Width="<<width<<";\n"<<
-          "const unsigned char "<<fontName<<"DataSize="<<roundedHeight<<";\n"<<
-          "const unsigned char "<<fontName<<"NumBlocks="<<blocks.size()<<";\n\n";
+          "const unsigned char "<<fontName<<"DataSize="<<(compressed?8:roundedHeight)<<";\n"<<
+          "const unsigned short "<<fontName<<"NumBlocks="<<blocks.size()<<";\n\n";
 
     //Write range array
     file<<"// The start of range i is blocks[2*i], its size is at blocks[2*i+1]\n";
@@ -77,6 +82,13 @@ void FixedWidthGenerator::generateCode(const std::string filename,
             file<<",\n";
     }
     file<<"\n};\n\n"<<dec;
+    writeBlockStart(file,fontName);
+
+    if(compressed)
+    {
+        writeCompressedData(file,fontName,compressedData);
+        return;
+    }
 
     //Write font look up table
     switch(roundedHeight)
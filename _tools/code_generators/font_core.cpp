@@ -178,7 +178,7 @@ shared_ptr<CodeGenerator>
 }
 
 CodeGenerator::CodeGenerator(shared_ptr<FontParser> parser): logStream(),
-        log(false), glyphs(parser->getGlyphs()) {}
+        log(false), compressed(false), glyphs(parser->getGlyphs()) {}
 
 void CodeGenerator::setLogStream(std::ostream& output)
 {
@@ -235,6 +235,238 @@ void CodeGenerator::generateRendering(const std::string& filename) const
     img.write(filename);
 }
 
+void CodeGenerator::generateBinary(const std::string& filename) const
+{
+    vector<UnicodeBlock> blocks=UnicodeBlockManager::getAvailableBlocks();
+    for(int i=1;i<blocks.size()-1;i++)
+        if(blocks[i].getStartCodepoint()<=blocks[i-1].getEndCodepoint())
+            throw(runtime_error("Binary fonts require sorted Unicode blocks"));
+    if(blocks.size()>65535)
+        throw(runtime_error("Too many blocks for a binary font"));
+    if(glyphs.size()>65535)
+        throw(runtime_error("Too many glyphs, maximum allowed is 65535"));
+    unsigned int height=glyphs.at(0).getHeight();
+    if(height>32) throw(runtime_error("Character is too high for code "
+            "generation. Maximum allowed is 32pixels"));
+    unsigned int width=glyphs.at(0).getWidth();
+    for(int i=1;i<glyphs.size();i++)
+        if(glyphs.at(i).getWidth()!=width) width=0;
+    if(width>255) throw(runtime_error("Glyph too wide for a binary font"));
+
+    //Each glyph is its width followed by the glyph in the compressed format
+    vector<vector<unsigned char>> data;
+    unsigned int maxGlyphSize=0;
+    for(int i=0;i<glyphs.size();i++)
+    {
+        if(glyphs.at(i).getWidth()>255)
+            throw(runtime_error("Glyph too wide for a binary font"));
+        vector<unsigned char> glyph=compressGlyph(glyphs.at(i));
+        glyph.insert(glyph.begin(),glyphs.at(i).getWidth());
+        maxGlyphSize=max<unsigned int>(maxGlyphSize,glyph.size());
+        data.push_back(glyph);
+    }
+    if(maxGlyphSize>65535) throw(runtime_error("Glyph too large"));
+
+    vector<unsigned char> file;
+    auto put16=[&](unsigned int x)
+    {
+        file.push_back(x & 0xff);
+        file.push_back(x>>8 & 0xff);
+    };
+    auto put32=[&](unsigned int x)
+    {
+        put16(x & 0xffff);
+        put16(x>>16);
+    };
+    const char magic[]="MXGF";
+    file.insert(file.end(),magic,magic+4);
+    file.push_back(1); //Version
+    file.push_back(glyphs.at(0).isAntialiased() ? 1 : 0);
+    file.push_back(height);
+    file.push_back(width);
+    put16(blocks.size());
+    put16(maxGlyphSize);
+    put32(glyphs.size());
+    for(auto& block : blocks)
+    {
+        put32(block.getStartCodepoint());
+        put32(block.size());
+    }
+    unsigned int start=0;
+    for(auto& block : blocks)
+    {
+        put16(start);
+        start+=block.size();
+    }
+    if(start!=glyphs.size())
+        throw(runtime_error("Glyphs don't match the Unicode blocks"));
+    unsigned int offset=file.size()+4*(glyphs.size()+1);
+    for(auto& glyph : data)
+    {
+        put32(offset);
+        offset+=glyph.size();
+    }
+    put32(offset);
+    for(auto& glyph : data) file.insert(file.end(),glyph.begin(),glyph.end());
+
+    ofstream out(filename.c_str(),ios::binary);
+    out.write(reinterpret_cast<const char*>(file.data()),file.size());
+    if(!out) throw(runtime_error("Error writing binary font file"));
+    if(log) *logStream<<"Binary font: "<<file.size()<<" bytes, largest glyph "
+                      <<maxGlyphSize<<" bytes"<<endl;
+}
+
+void CodeGenerator::setCompressed(bool compressed)
+{
+    this->compressed=compressed;
+}
+
+vector<vector<unsigned char>> CodeGenerator::compressGlyphs(
+        unsigned int rawSize) const
+{
+    vector<vector<unsigned char>> result;
+    unsigned int compressedSize=4*(glyphs.size()+1);
+    //The offset table, if any, is still required to compute glyph widths
+    unsigned int width=glyphs.at(0).getWidth();
+    for(int i=0;i<glyphs.size();i++)
+        if(glyphs.at(i).getWidth()!=width)
+        {
+            compressedSize+=2*(glyphs.size()+1);
+            break;
+        }
+    for(int i=0;i<glyphs.size();i++)
+    {
+        result.push_back(compressGlyph(glyphs.at(i)));
+        compressedSize+=result.back().size();
+    }
+    if(log)
+    {
+        *logStream<<"Font data: "<<rawSize<<" bytes, "<<compressedSize
+                  <<" bytes if compressed ("<<showpos
+                  <<static_cast<int>(compressedSize)-static_cast<int>(rawSize)
+                  <<noshowpos<<" bytes, ratio "
+                  <<static_cast<double>(rawSize)/compressedSize<<")"<<endl;
+        if(compressed && compressedSize>=rawSize)
+            *logStream<<"Warning: compression makes this font larger"<<endl;
+    }
+    return result;
+}
+
+void CodeGenerator::writeBlockStart(ostream& file, const string& fontName) const
+{
+    //The last block, containing the replacement character, is out of order
+    vector<UnicodeBlock> blocks=UnicodeBlockManager::getAvailableBlocks();
+    for(int i=1;i<blocks.size()-1;i++)
+        if(blocks[i].getStartCodepoint()<=blocks[i-1].getEndCodepoint())
+        {
+            if(log) *logStream<<"Blocks not sorted, no binary search"<<endl;
+            return;
+        }
+    unsigned int numGlyphs=UnicodeBlockManager::numSupportedCharacters();
+    if(numGlyphs>65535)
+        throw(runtime_error("Too many glyphs, maximum allowed is 65535"));
+
+    file<<"// Glyphs of range i start from glyph number blockStart[i]\n";
+    file<<"const unsigned short "<<fontName<<"BlockStart[]={\n ";
+    int blockNewline=0;
+    unsigned int start=0;
+    for(int i=0;i<blocks.size();i++)
+    {
+        file<<dec<<start;
+        start+=blocks[i].size();
+        if(i!=blocks.size()-1) file<<",";
+        if(++blockNewline==8 && i!=blocks.size()-1)
+        {
+            blockNewline=0;
+            file<<"\n ";
+        }
+    }
+    file<<"\n};\n\n";
+}
+
+void CodeGenerator::writeCompressedData(ostream& file, const string& fontName,
+        const vector<vector<unsigned char>>& data) const
+{
+    file<<"//Glyph i is stored at "<<fontName<<"Data["<<fontName
+        <<"CompressedOffset[i]] as vertical runs of pixels\n";
+    file<<"const unsigned int "<<fontName<<"CompressedOffset[]={\n ";
+    int offsetNewline=0;
+    unsigned int offsetCalculated=0;
+    for(int i=0;i<data.size();i++)
+    {
+        file<<dec<<offsetCalculated<<",";
+        offsetCalculated+=data.at(i).size();
+        if(++offsetNewline==8) { offsetNewline=0; file<<"\n "; }
+    }
+    //NOTE: like the offset table, it has one more entry than the glyphs
+    file<<dec<<offsetCalculated;
+    file<<"\n};\n\n";
+
+    file<<"const unsigned char "<<fontName<<"Data[]={\n";
+    for(int i=0;i<data.size();i++)
+    {
+        file<<" ";
+        for(int j=0;j<data.at(i).size();j++)
+        {
+            file<<showbase<<hex<<static_cast<int>(data.at(i).at(j))<<dec;
+            if(j!=data.at(i).size()-1 || i!=data.size()-1) file<<",";
+        }
+        file<<" //U+"<<noshowbase<<hex<<glyphs.at(i).getCodepointValue()<<" ( "
+            <<UnicodeBlockManager::codepointToString(glyphs.at(i).getCodepoint())
+            <<" )"<<dec;
+        if(i!=data.size()-1) file<<"\n";
+    }
+    file<<"\n};\n";
+}
+
+vector<unsigned char> CodeGenerator::compressGlyph(const Glyph& glyph)
+{
+    vector<unsigned char> result;
+    const int height=glyph.getHeight();
+    const bool aa=glyph.isAntialiased();
+    vector<unsigned char> previous;
+    int repeat=0;
+    for(int i=0;i<glyph.getWidth();i++)
+    {
+        vector<unsigned char> column;
+        for(int j=0;j<height;j++)
+        {
+            unsigned char pixel=glyph.getPixelAt(i,j);
+            column.push_back(aa ? pixel : (pixel ? 3 : 0));
+        }
+        //Columns equal to the previous one are encoded as a repeat count,
+        //but never across glyphs, since each glyph is decoded on its own
+        if(column==previous && repeat<32)
+        {
+            repeat++;
+            continue;
+        }
+        if(repeat>0) result.push_back(0x80 | (repeat-1));
+        repeat=0;
+        previous=column;
+
+        vector<pair<unsigned char,int>> runs;
+        for(int j=0;j<height;j++)
+        {
+            if(runs.empty() || runs.back().first!=column[j])
+                runs.push_back(make_pair(column[j],1));
+            else runs.back().second++;
+        }
+        //A trailing background run is implicit, just mark the previous one
+        //as the last. Runs are at most 32 pixels since height is at most 32
+        bool last=runs.size()>1 && runs.back().first==0;
+        if(last) runs.pop_back();
+        for(int j=0;j<runs.size();j++)
+        {
+            unsigned char b=(runs[j].first<<5) | (runs[j].second-1);
+            if(last && j==runs.size()-1) b|=0x80;
+            result.push_back(b);
+        }
+    }
+    if(repeat>0) result.push_back(0x80 | (repeat-1));
+    return result;
+}
+
 CodeGenerator::~CodeGenerator() {}
 
 } //namespace fontcore
@@ -249,6 +249,20 @@ public:
      */
     void generateRendering(const std::string& filename) const;
 
+    /**
+     * Generate a binary font file, that can be loaded at runtime with
+     * mxgui::FontFile. See font_file.cpp for the format
+     * \param filename name of the binary font file
+     */
+    void generateBinary(const std::string& filename) const;
+
+    /**
+     * Store glyphs in the compressed format, as vertical runs of pixels of
+     * the same level. See mxgui::Font::getCompressedOffset() for the format.
+     * \param compressed true to generate a compressed font
+     */
+    void setCompressed(bool compressed);
+
     /**
      * Generate the .h file with the look up tables
      * \param filename name of the .h file
@@ -262,11 +276,46 @@ public:
     virtual ~CodeGenerator();
     
 protected:
+    /**
+     * Compress all the glyphs, and log the size of the font data with and
+     * without compression
+     * \param rawSize size in bytes of the uncompressed font data, including
+     * the offset table if any
+     * \return the compressed glyphs
+     */
+    std::vector<std::vector<unsigned char>> compressGlyphs(
+        unsigned int rawSize) const;
+
+    /**
+     * If the Unicode blocks are sorted, write a table with the index of the
+     * first glyph of each block, to allow a binary search of codepoints
+     * \param file where to write
+     * \param fontName font name
+     */
+    void writeBlockStart(std::ostream& file, const std::string& fontName) const;
+
+    /**
+     * Write the compressed offset table and font data
+     * \param file where to write
+     * \param fontName font name
+     * \param data compressed glyphs, as returned by compressGlyphs()
+     */
+    void writeCompressedData(std::ostream& file, const std::string& fontName,
+        const std::vector<std::vector<unsigned char>>& data) const;
+
     std::ostream *logStream; ///< Valid only if debugFlag is true
     bool log; ///< True if debugMode has been called
+    bool compressed; ///< True if the font has to be compressed
     std::vector<Glyph> glyphs; ///< List of glyphs
 
 private:
+    /**
+     * Compress a glyph
+     * \param glyph glyph to compress
+     * \return the compressed glyph
+     */
+    static std::vector<unsigned char> compressGlyph(const Glyph& glyph);
+
     CodeGenerator(const CodeGenerator&);
     CodeGenerator& operator= (const CodeGenerator&);
 };
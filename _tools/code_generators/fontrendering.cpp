@@ -51,7 +51,7 @@ using namespace boost::program_options;
 
 int main(int argc, char *argv[])
 {
-    options_description desc("FontRendering utility v1.2\n"
+    options_description desc("FontRendering utility v1.3\n"
         "Designed by TFT : Terraneo Federico Technologies\nOptions");
     desc.add_options()
         ("help", "Prints this.")
@@ -60,10 +60,15 @@ int main(int argc, char *argv[])
         ("replacement-char", value<string>(), "Specify a replacement character different from '�'")
         ("image", value<string>(), "Filename of image to be generated")
         ("header", value<string>(), "Filename of .h file to be generated")
+        ("binary", value<string>(), "Filename of binary font file to be generated, "
+            "to load the font at runtime")
         ("name", value<string>(), "Font name, to give a name to the tables")
         ("height", value<int>(), "Rendering height (for TrueType only)")
         ("pad", value<int>(), "Additional pixels padding (for TrueType only)")
         ("fixes", value<string>(), "Fixes file for kerning issues (TTF only)")
+        ("compress", "Store glyphs run length encoded, smaller but slower to draw")
+        ("subset", value<vector<string>>(), "Only add the codepoints used by a "
+            "text file, or by the string literals of a C/C++ source file")
     ;
 
     variables_map vm;
@@ -71,7 +76,8 @@ int main(int argc, char *argv[])
     notify(vm);
 
     if(vm.empty() || vm.count("help") || (!vm.count("font")) ||
-       (!vm.count("image")) || (!vm.count("header")) || (!vm.count("name")))
+       (!vm.count("image")) || (!vm.count("name")) ||
+       (!vm.count("header") && !vm.count("binary")))
     {
         cerr<<desc<<endl;
         return 1;
@@ -101,11 +107,12 @@ int main(int argc, char *argv[])
         parser->setFixesFile(vm["fixes"].as<string>());
     }
 
-    if(vm.count("add-range"))
+    if(vm.count("add-range") || vm.count("subset"))
     {
         // convert the list into a an array of pairs and give it to the Manager
-        vector<string> rangeList=vm["add-range"].as<vector<string>>();
-        vector<pair<char32_t,char32_t>> ranges;
+        CodepointCollector collector;
+        vector<string> rangeList;
+        if(vm.count("add-range")) rangeList=vm["add-range"].as<vector<string>>();
         unsigned int start,end;
 
         for(string s : rangeList)
@@ -122,11 +129,27 @@ int main(int argc, char *argv[])
             if(start>end)
                 throw(runtime_error("Start of range is greater than end of range"));
 
-            ranges.push_back({start,end});
+            collector.addRange(start,end);
         }
 
-        // it's important for the ranges to be sorted!
-        sort(ranges.begin(),ranges.end());
+        if(vm.count("subset"))
+        {
+            const vector<string> sourceExtensions={".c",".cc",".cpp",".cxx",
+                                                   ".h",".hh",".hpp"};
+            for(string s : vm["subset"].as<vector<string>>())
+            {
+                string extension=s.substr(min(s.size(),s.rfind('.')));
+                if(find(sourceExtensions.begin(),sourceExtensions.end(),
+                        extension)!=sourceExtensions.end())
+                    collector.addSourceFile(s);
+                else collector.addTextFile(s);
+            }
+        }
+
+        // it's important for the ranges to be sorted and non overlapping!
+        vector<pair<char32_t,char32_t>> ranges=collector.getRanges();
+        cout<<"Converting "<<collector.size()<<" codepoints in "<<ranges.size()
+            <<" ranges"<<endl;
 
         // add the replacement character (it's always the last range,
         // regardless of the ordering)
@@ -150,8 +173,11 @@ int main(int argc, char *argv[])
     parser->parse();
     shared_ptr<CodeGenerator> generator=CodeGenerator::getGenerator(parser);
     generator->setLogStream(cout);
+    generator->setCompressed(vm.count("compress")>0);
     generator->generateRendering(vm["image"].as<string>());
-    generator->generateCode(vm["header"].as<string>(),vm["name"].as<string>());
+    if(vm.count("header"))
+        generator->generateCode(vm["header"].as<string>(),vm["name"].as<string>());
+    if(vm.count("binary")) generator->generateBinary(vm["binary"].as<string>());
     cout<<"Success"<<endl;
     return 0;
 }
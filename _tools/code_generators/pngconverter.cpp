@@ -25,6 +25,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
 #include "pngconverter.h"
 
 using namespace std;
@@ -65,6 +68,106 @@ static string toUpper(const string& x)
     return result;
 }
 
+/**
+ * \param x a file name
+ * \return the file name without path and extension
+ */
+static string baseName(const string& x)
+{
+    string result=x;
+    size_t lastSlash=result.find_last_of('/');
+    if(lastSlash!=string::npos) result=result.substr(lastSlash+1);
+    return result.substr(0,result.find('.'));
+}
+
+/**
+ * \param x a string
+ * \return the same string with characters not allowed in C++ identifiers
+ * replaced by '_'
+ */
+static string toIdentifier(const string& x)
+{
+    string result(x);
+    for(int i=0;i<result.length();i++)
+        if(!isalnum(result[i])) result[i]='_';
+    return result;
+}
+
+png::image<png::rgb_pixel> packAtlas(vector<AtlasImage>& images, int width)
+{
+    int area=0, maxWidth=0;
+    for(auto& i : images)
+    {
+        area+=i.img.get_width()*i.img.get_height();
+        maxWidth=max<int>(maxWidth,i.img.get_width());
+    }
+    if(width==0) width=max<int>(maxWidth,ceil(sqrt(area)));
+    if(width<maxWidth)
+        throw(runtime_error("Atlas width is less than the widest image"));
+
+    //Shelf packing: images sorted by decreasing height are placed left to
+    //right, starting a new row when one is full. Sorting by height keeps the
+    //space wasted below shorter images in a row small
+    vector<int> order(images.size());
+    iota(order.begin(),order.end(),0);
+    stable_sort(order.begin(),order.end(),[&](int a, int b) {
+        return images[a].img.get_height()>images[b].img.get_height();
+    });
+    int x=0, y=0, rowHeight=0;
+    for(int i : order)
+    {
+        AtlasImage& ai=images[i];
+        if(x+ai.img.get_width()>width)
+        {
+            x=0;
+            y+=rowHeight;
+            rowHeight=0;
+        }
+        ai.x=x;
+        ai.y=y;
+        x+=ai.img.get_width();
+        rowHeight=max<int>(rowHeight,ai.img.get_height());
+    }
+
+    image<rgb_pixel> result(width,y+rowHeight);
+    for(auto& ai : images)
+        for(int i=0;i<ai.img.get_height();i++)
+            for(int j=0;j<ai.img.get_width();j++)
+                result.set_pixel(ai.x+j,ai.y+i,ai.img.get_pixel(j,i));
+    return result;
+}
+
+png::image<png::rgb_pixel> encodeSprite(png::image<png::rgb_pixel>& img,
+        const vector<vector<bool>>& opaque, vector<unsigned short>& runs)
+{
+    vector<rgb_pixel> pixels;
+    for(int y=0;y<img.get_height();y++)
+    {
+        int numRuns=runs.size();
+        runs.push_back(0);
+        int x=0, runEnd=0;
+        while(x<img.get_width())
+        {
+            if(opaque[y][x]==false)
+            {
+                x++;
+                continue;
+            }
+            int runStart=x;
+            while(x<img.get_width() && opaque[y][x])
+                pixels.push_back(img.get_pixel(x++,y));
+            runs.push_back(runStart-runEnd);
+            runs.push_back(x-runStart);
+            runEnd=x;
+            runs[numRuns]++;
+        }
+    }
+    if(pixels.empty()) throw(runtime_error("Sprite has no opaque pixels"));
+    image<rgb_pixel> result(pixels.size(),1);
+    for(int i=0;i<pixels.size();i++) result.set_pixel(i,0,pixels[i]);
+    return result;
+}
+
 //
 // class ImageWriter
 //
@@ -249,15 +352,20 @@ void ImageWriter24bit::writePixel(int x, int y, ofstream& out,
 int main(int argc, char *argv[])
 {
     //Check args
-    options_description desc("PngConverter utility v1.22\n"
+    options_description desc("PngConverter utility v1.23\n"
         "Designed by TFT : Terraneo Federico Technologies\nOptions");
     desc.add_options()
         ("help", "Prints this.")
-        ("in", value<string>(), "Input png file (required)")
+        ("in", value<vector<string>>()->multitoken(),
+            "Input png file (required), more than one with --atlas")
         ("depth", value<string>(), "Color depth, 1bitlinear,8,16,18 or 24 bits (required)")
         ("out", value<string>(), "Output png file for validation")
         ("outdir", value<string>(), "Directory where to generate files (default is src dir)")
         ("binary", "Generate a binary file instead of a .cpp/.h file")
+        ("atlas", value<string>(), "Pack all input files in an atlas with this name")
+        ("atlaswidth", value<int>(), "Atlas width (default makes it roughly square)")
+        ("sprite", "Generate a sprite, transparent where the png is transparent")
+        ("colorkey", value<string>(), "Generate a sprite, transparent where the png has this color, as RRGGBB")
     ;
 
     variables_map vm;
@@ -271,8 +379,24 @@ int main(int argc, char *argv[])
     }
     
     //Load image
-    image<rgb_pixel> img(vm["in"].as<string>());
-    cout<<"Loaded image \""<<vm["in"].as<string>()<<"\". Info:"<<endl;
+    vector<string> inputs=vm["in"].as<vector<string>>();
+    const bool atlas=vm.count("atlas");
+    if(atlas==false && inputs.size()!=1)
+        throw(runtime_error("More than one input file requires --atlas"));
+    image<rgb_pixel> img;
+    vector<AtlasImage> images;
+    if(atlas)
+    {
+        for(auto& in : inputs)
+            images.push_back(AtlasImage(toIdentifier(baseName(in)),
+                                        image<rgb_pixel>(in)));
+        img=packAtlas(images,vm.count("atlaswidth") ?
+                             vm["atlaswidth"].as<int>() : 0);
+        cout<<"Packed "<<images.size()<<" images. Atlas info:"<<endl;
+    } else {
+        img=image<rgb_pixel>(inputs.front());
+        cout<<"Loaded image \""<<inputs.front()<<"\". Info:"<<endl;
+    }
     cout<<"Height  = "<<img.get_height()<<endl;
     cout<<"Width   = "<<img.get_width()<<endl;
 
@@ -302,6 +426,44 @@ int main(int argc, char *argv[])
     } else
     throw runtime_error("Unsupported pixel depth (not 1bitlinear,8,16,18,24)");
 
+    const bool binary=vm.count("binary");
+    //Image views don't support 1bpp images, whose lines are byte aligned
+    if(atlas && (binary || pixDepth==_1bitlinear))
+        throw(runtime_error("Atlas not supported for binary or 1bitlinear"));
+
+    //Sprites only store their opaque pixels, that are written in place of
+    //the image, with the run data to find where they go
+    const bool sprite=vm.count("sprite") || vm.count("colorkey");
+    vector<unsigned short> runs;
+    image<rgb_pixel> pixels=img;
+    if(sprite)
+    {
+        if(atlas || binary || pixDepth==_1bitlinear)
+            throw(runtime_error("Sprite not supported for atlas, binary or 1bitlinear"));
+        vector<vector<bool>> opaque(img.get_height(),
+                                    vector<bool>(img.get_width(),true));
+        if(vm.count("sprite"))
+        {
+            image<rgba_pixel> alpha(inputs.front());
+            for(int y=0;y<img.get_height();y++)
+                for(int x=0;x<img.get_width();x++)
+                    if(alpha.get_pixel(x,y).alpha<128) opaque[y][x]=false;
+        }
+        if(vm.count("colorkey"))
+        {
+            unsigned int key=stoul(vm["colorkey"].as<string>(),0,16);
+            for(int y=0;y<img.get_height();y++)
+                for(int x=0;x<img.get_width();x++)
+                {
+                    rgb_pixel pix=img.get_pixel(x,y);
+                    if(pix.red==(key>>16 & 0xff) && pix.green==(key>>8 & 0xff)
+                        && pix.blue==(key & 0xff)) opaque[y][x]=false;
+                }
+        }
+        pixels=encodeSprite(img,opaque,runs);
+        cout<<"Opaque  = "<<pixels.get_width()<<endl;
+    }
+
     /*
      * Get output filemane from input filename
      * Example: if in is "/home/mypng.png"
@@ -309,26 +471,18 @@ int main(int argc, char *argv[])
      * path            is "/home/"
      * cppFilename     is "/home/mypng.cpp"
      * hFilename       is "/home/mypng.h"
-     * unless outdir is set
+     * unless outdir is set. Atlases are named after the --atlas option
      */
     string path="";
-    string filename=vm["in"].as<string>();
-    //Remove path
-    size_t lastSlash=filename.find_last_of('/');
-    if(lastSlash!=string::npos)
-    {
-        path=filename.substr(0,lastSlash+1);
-        filename=filename.substr(lastSlash+1,filename.length());
-    }
+    size_t lastSlash=inputs.front().find_last_of('/');
+    if(lastSlash!=string::npos) path=inputs.front().substr(0,lastSlash+1);
     //Override path if requested
     if(vm.count("outdir")) path=vm["outdir"].as<string>()+'/';
-    //Remove extension
-    filename=filename.substr(0,filename.find('.'));
+    string filename=atlas ? vm["atlas"].as<string>() : baseName(inputs.front());
     string cppFilename=path+filename+".cpp";
     string hFilename=path+filename+".h";
 
     //Convert image, step 1 (make .cpp file)
-    const bool binary=vm.count("binary");
     ofstream file(binary ? filename.c_str() : cppFilename.c_str(),ios::binary);
     if(!file.good())
         throw(runtime_error(string("Can't open file: ")+cppFilename));
@@ -338,7 +492,7 @@ int main(int argc, char *argv[])
     if(vm.count("out"))
     {
         outRequested=true;
-        outImage=image<rgb_pixel>(img.get_width(),img.get_height());
+        outImage=image<rgb_pixel>(pixels.get_width(),pixels.get_height());
     }
  
     if(binary==false)
@@ -350,6 +504,18 @@ int main(int argc, char *argv[])
                 <<"static const short int height="<<img.get_height()<<';'<<endl
                 <<"static const short int width ="<<img.get_width()<<';'<<endl
                 <<endl;
+        if(sprite)
+        {
+            //One line of the sprite per line of code
+            file<<"static const unsigned short runData[]={"<<endl;
+            for(int i=0;i<runs.size();i+=2*runs[i]+1)
+            {
+                file<<' ';
+                for(int j=0;j<=2*runs[i];j++) file<<runs[i+j]<<',';
+                file<<endl;
+            }
+            file<<"};"<<endl<<endl;
+        }
         //Optimization for 16 bit per pixel
         if(pixDepth==_16) 
             file<<"static const unsigned short pixelData[]={"<<endl<<' ';
@@ -362,7 +528,7 @@ int main(int argc, char *argv[])
         file.write(reinterpret_cast<char*>(&header),sizeof(header));
     }
 
-    shared_ptr<ImageWriter> imgw=ImageWriter::fromPixDepth(img,binary,pixDepth);
+    shared_ptr<ImageWriter> imgw=ImageWriter::fromPixDepth(pixels,binary,pixDepth);
     imgw->write(file, outRequested ? &outImage : 0);
 
     if(!binary)
@@ -393,12 +559,53 @@ int main(int argc, char *argv[])
                 throw runtime_error("TODO");
                 break;
         }
-        file<<endl<<"};"<<endl<<endl<<"const basic_image<"<<classname<<"> "
-            <<filename<<"(height,width,pixelData);";
+        file<<endl<<"};"<<endl<<endl;
+        if(sprite)
+            file<<"const basic_sprite<"<<classname<<"> "<<filename
+                <<"(height,width,runData,pixelData);";
+        else
+            file<<"const basic_image<"<<classname<<"> "<<filename
+                <<"(height,width,pixelData);";
+        if(atlas)
+        {
+            //Views into the atlas, and a table to access them by index
+            file<<endl<<endl;
+            for(auto& ai : images)
+                file<<"const basic_image_view<"<<classname<<"> "<<filename
+                    <<'_'<<ai.name<<"("<<ai.img.get_height()<<','
+                    <<ai.img.get_width()<<",width,pixelData+"
+                    <<ai.y*img.get_width()+ai.x<<");"<<endl;
+            file<<endl<<"const basic_image_view<"<<classname<<"> *const "
+                <<filename<<"_table[]="<<endl<<'{'<<endl;
+            for(auto& ai : images)
+                file<<"    &"<<filename<<'_'<<ai.name<<','<<endl;
+            file<<"};";
+        }
     }
     file.close();
 
-    if(outRequested) outImage.write(vm["out"].as<string>());
+    if(outRequested)
+    {
+        //Put the opaque pixels of a sprite back in place, transparent pixels
+        //are left black
+        if(sprite)
+        {
+            image<rgb_pixel> spriteImage(img.get_width(),img.get_height());
+            int r=0, i=0;
+            for(int y=0;y<img.get_height();y++)
+            {
+                int numRuns=runs[r++], x=0;
+                for(int j=0;j<numRuns;j++,r+=2)
+                {
+                    x+=runs[r];
+                    for(int k=0;k<runs[r+1];k++)
+                        spriteImage.set_pixel(x++,y,outImage.get_pixel(i++,0));
+                }
+            }
+            outImage=spriteImage;
+        }
+        outImage.write(vm["out"].as<string>());
+    }
 
     //Convert image, step 2 (make .h file)
     if(binary) return 0;
@@ -410,9 +617,23 @@ int main(int argc, char *argv[])
             "pngconverter utility"<<endl<<"//Please do not edit"<<endl
             <<"#ifndef "<<toUpper(filename)<<"_H"<<endl
             <<"#define "<<toUpper(filename)<<"_H"<<endl<<endl
-            <<"#include \"mxgui/image.h\""<<endl<<endl
-            <<"extern const mxgui::Image "<<filename<<";"<<endl<<endl
-            <<"#endif //"<<toUpper(filename)<<"_H"<<endl;
+            <<"#include \"mxgui/"<<(sprite ? "sprite.h" : "image.h")<<'"'
+            <<endl<<endl<<"extern const mxgui::"<<(sprite ? "Sprite " : "Image ")
+            <<filename<<";"<<endl<<endl;
+    if(atlas)
+    {
+        for(auto& ai : images)
+            file<<"extern const mxgui::ImageView "<<filename<<'_'<<ai.name
+                <<";"<<endl;
+        file<<endl<<"/// Index of the images in "<<filename<<"_table"<<endl
+            <<"enum"<<endl<<'{'<<endl;
+        for(auto& ai : images)
+            file<<"    "<<filename<<'_'<<ai.name<<"_index,"<<endl;
+        file<<"    "<<filename<<"_count"<<endl<<"};"<<endl<<endl
+            <<"extern const mxgui::ImageView *const "<<filename<<"_table["
+            <<filename<<"_count];"<<endl<<endl;
+    }
+    file<<"#endif //"<<toUpper(filename)<<"_H"<<endl;
     file.close();
     return 0;
 }
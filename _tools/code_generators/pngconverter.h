@@ -5,6 +5,7 @@
 #include <string>
 #include <ostream>
 #include <memory>
+#include <vector>
 #include "libs/png++/png.hpp"
 
 /**
@@ -238,4 +239,47 @@ protected:
             png::image<png::rgb_pixel> *outImage, png::rgb_pixel pix);
 };
 
+/**
+ * An image packed into an atlas
+ */
+struct AtlasImage
+{
+    /**
+     * Constructor
+     * \param name name of the image in the generated code
+     * \param img the image
+     */
+    AtlasImage(const std::string& name, const png::image<png::rgb_pixel>& img)
+            : name(name), img(img), x(0), y(0) {}
+
+    std::string name;               ///< Name in the generated code
+    png::image<png::rgb_pixel> img; ///< Image
+    int x, y;                       ///< Position within the atlas
+};
+
+/**
+ * Pack images into an atlas, placing them in rows sorted by height
+ * \param images images to pack, their position within the atlas is written
+ * in their x and y fields
+ * \param width width of the atlas, or 0 to choose one that makes the atlas
+ * roughly square
+ * \return the atlas image
+ */
+png::image<png::rgb_pixel> packAtlas(std::vector<AtlasImage>& images,
+        int width);
+
+/**
+ * Encode the transparency of a sprite as runs of transparent pixels to skip
+ * and opaque pixels to copy
+ * \param img the sprite image
+ * \param opaque opacity of each pixel, indexed as opaque[y][x]
+ * \param runs the run data is appended here, in the format expected by
+ * mxgui::basic_sprite
+ * \return an image one pixel high with the opaque pixels, in the order they
+ * are drawn
+ */
+png::image<png::rgb_pixel> encodeSprite(png::image<png::rgb_pixel>& img,
+        const std::vector<std::vector<bool>>& opaque,
+        std::vector<unsigned short>& runs);
+
 #endif //PNGCONVERTER_H
@@ -17,6 +17,11 @@
 
 #include "unicode_blocks.h"
 #include <boost/locale.hpp>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 using namespace std;
 using namespace fontcore;
@@ -115,3 +120,118 @@ std::vector<UnicodeBlock> UnicodeBlockManager::knownUnicodeBlocks =
     UnicodeBlock(0x00000020,0x0000007E),
     UnicodeBlock(0x0000FFFD,0x0000FFFD)
 };
+
+//
+// class CodepointCollector
+//
+
+void CodepointCollector::addRange(char32_t start, char32_t end)
+{
+    ranges.push_back({start,end});
+}
+
+void CodepointCollector::addTextFile(const std::string& filename)
+{
+    ifstream file(filename.c_str());
+    if(!file) throw(runtime_error(string("Can't open ")+filename));
+    stringstream ss;
+    ss<<file.rdbuf();
+    addString(ss.str());
+}
+
+void CodepointCollector::addSourceFile(const std::string& filename)
+{
+    ifstream file(filename.c_str());
+    if(!file) throw(runtime_error(string("Can't open ")+filename));
+    stringstream ss;
+    ss<<file.rdbuf();
+    const string src=ss.str();
+    //Start of the identifier or number that ends right before position i,
+    //used to tell apart literal prefixes from digit separators
+    auto tokenStart=[&src](size_t i)
+    {
+        while(i>0 && (isalnum(static_cast<unsigned char>(src[i-1]))
+            || src[i-1]=='_' || src[i-1]=='.' || src[i-1]=='\'')) i--;
+        return i;
+    };
+    auto isRawPrefix=[](const string& prefix)
+    {
+        return prefix=="R" || prefix=="u8R" || prefix=="uR" || prefix=="UR"
+            || prefix=="LR";
+    };
+    string literal;
+    for(size_t i=0;i<src.size();i++)
+    {
+        if(src.compare(i,2,"//")==0)
+        {
+            i=src.find('\n',i);
+            if(i==string::npos) break;
+        } else if(src.compare(i,2,"/*")==0) {
+            i=src.find("*/",i+2);
+            if(i==string::npos) break;
+            i++;
+        } else if(src[i]=='\'' && i>0 && isdigit(static_cast<unsigned char>(
+                src[tokenStart(i)]))) {
+            //Digit separator, such as in 1'000'000
+            continue;
+        } else if(src[i]=='"' && isRawPrefix(src.substr(tokenStart(i),
+                i-tokenStart(i)))) {
+            //Raw string literal, R"delimiter(text)delimiter", also with an
+            //encoding prefix. The text is taken as is, without escapes
+            size_t open=src.find('(',i);
+            if(open==string::npos) break;
+            string close=")"+src.substr(i+1,open-i-1)+"\"";
+            size_t end=src.find(close,open);
+            if(end==string::npos) break;
+            addString(src.substr(open+1,end-open-1));
+            i=end+close.size()-1;
+        } else if(src[i]=='\'' || src[i]=='"') {
+            char quote=src[i];
+            for(i++;i<src.size() && src[i]!=quote;i++)
+            {
+                if(src[i]!='\\')
+                {
+                    literal+=src[i];
+                    continue;
+                }
+                if(++i>=src.size()) break;
+                int digits=src[i]=='u' ? 4 : src[i]=='U' ? 8 : 0;
+                if(digits==0 || i+digits>=src.size()) continue;
+                char32_t c=stoul(src.substr(i+1,digits),nullptr,16);
+                literal+=UnicodeBlockManager::codepointToString(c);
+                i+=digits;
+            }
+            if(quote=='"') addString(literal);
+            literal.clear();
+        }
+    }
+}
+
+vector<pair<char32_t,char32_t>> CodepointCollector::getRanges() const
+{
+    vector<pair<char32_t,char32_t>> all=ranges;
+    for(char32_t c : codepoints) all.push_back({c,c});
+    sort(all.begin(),all.end());
+    //Merge overlapping and adjacent ranges
+    vector<pair<char32_t,char32_t>> result;
+    for(auto& r : all)
+    {
+        if(!result.empty() && r.first<=result.back().second+1)
+            result.back().second=max(result.back().second,r.second);
+        else result.push_back(r);
+    }
+    return result;
+}
+
+unsigned int CodepointCollector::size() const
+{
+    unsigned int result=0;
+    for(auto& r : getRanges()) result+=r.second-r.first+1;
+    return result;
+}
+
+void CodepointCollector::addString(const std::string& s)
+{
+    u32string converted=boost::locale::conv::utf_to_utf<char32_t>(s);
+    for(char32_t c : converted) if(c>=0x20 && c!=0x7f) codepoints.insert(c);
+}
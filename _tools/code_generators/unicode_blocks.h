@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include <set>
 
 /**
  * \file unicode_blocks.h
@@ -134,6 +135,60 @@ private:
     static std::vector<UnicodeBlock> knownUnicodeBlocks;
 };
 
+/**
+ * \ingroup pub_iface
+ * Collects the codepoints to include in a font, to generate a subset font
+ * with only the characters an application actually uses
+ */
+class CodepointCollector
+{
+public:
+    /**
+     * Add a range of codepoints
+     * \param start first codepoint of the range
+     * \param end last codepoint of the range
+     */
+    void addRange(char32_t start, char32_t end);
+
+    /**
+     * Add all the codepoints in an UTF-8 text file, such as a string catalogue
+     * or a translation file. Control characters are ignored
+     * \param filename file name
+     */
+    void addTextFile(const std::string& filename);
+
+    /**
+     * Add the codepoints of the string literals in an UTF-8 C or C++ source
+     * file. Comments and character literals are ignored, \\u and \\U escapes
+     * are decoded, other escape sequences are ignored. Raw string literals
+     * are taken as is, and digit separators are skipped. Preprocessing is not
+     * done, so strings in disabled code or built by macros are not handled
+     * \param filename file name
+     */
+    void addSourceFile(const std::string& filename);
+
+    /**
+     * \return the collected codepoints, as sorted and non overlapping ranges
+     * of consecutive codepoints, suitable for UnicodeBlockManager::updateBlocks
+     */
+    std::vector<std::pair<char32_t,char32_t>> getRanges() const;
+
+    /**
+     * \return the number of collected codepoints
+     */
+    unsigned int size() const;
+
+private:
+    /**
+     * Add the codepoints of an UTF-8 string
+     * \param s the string
+     */
+    void addString(const std::string& s);
+
+    std::set<char32_t> codepoints; ///< Codepoints added individually
+    std::vector<std::pair<char32_t,char32_t>> ranges; ///< Ranges added
+};
+
 } //namespace fontcore
 
 #endif //UNICODEBLOCKS_H
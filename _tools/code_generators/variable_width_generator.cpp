@@ -55,13 +55,20 @@ void VariableWidthGenerator::generateCode(const std::string filename,
                 " Maximum allowed is 32pixels"));
     if(aa) roundedHeight*=2;
 
+    //Compress glyphs even if not required, to report the size difference
+    unsigned int columns=0;
+    for(int i=0;i<glyphs.size();i++) columns+=glyphs.at(i).getWidth();
+    vector<vector<unsigned char>> compressedData=compressGlyphs(
+        columns*roundedHeight/8+2*(glyphs.size()+1));
+
     //Write font info data
     std::vector<UnicodeBlock> blocks = UnicodeBlockManager::getAvailableBlocks();
     file<<"const bool "<<fontName<<"IsAntialiased="<<(aa?"true;\n":"false;\n")<<
           "const bool "<<fontName<<"IsFixedWidth=false;\n"<<
+          "const bool "<<fontName<<"IsCompressed="<<(compressed?"true;\n":"false;\n")<<
           "const unsigned char "<<fontName<<"Height="<<height<<";\n"<<
-          "const unsigned char "<<fontName<<"DataSize="<<roundedHeight<<";\n"<<
-          "const unsigned char "<<fontName<<"""NumBlocks="<<blocks.size()<<";\n\n";
+          "const unsigned char "<<fontName<<"DataSize="<<(compressed?8:roundedHeight)<<";\n"<<
+          "const unsigned short "<<fontName<<"NumBlocks="<<blocks.size()<<";\n\n";
 
     //Write range array
     file<<"// The start of range i is blocks[2*i], its size is at blocks[2*i+1]\n";
@@ -76,9 +83,12 @@ void VariableWidthGenerator::generateCode(const std::string filename,
             file<<",\n";
     }
     file<<"\n};\n\n"<<dec;
+    writeBlockStart(file,fontName);
 
     //Write offsets look up table
-    file<<"//The first byte of character i is "<<fontName<<"Data["<<
+    if(compressed) file<<"//Glyph i is "<<fontName<<"Offset[i+1]-"<<
+            fontName<<"Offset[i] pixels wide\n";
+    else file<<"//The first byte of character i is "<<fontName<<"Data["<<
             fontName<<"Offset[i]]\n";
     
     file<<"const unsigned short "<<fontName<<"Offset[]={\n ";
@@ -96,6 +106,12 @@ void VariableWidthGenerator::generateCode(const std::string filename,
     file<<offsetCalculated;
     file<<"\n};\n\n";
 
+    if(compressed)
+    {
+        writeCompressedData(file,fontName,compressedData);
+        return;
+    }
+
     //Write font look up table
     switch(roundedHeight)
     {
@@ -17,7 +17,9 @@
 
 #include "qtbackend.h"
 #include <cstdlib>
+#include <algorithm>
 #include <thread>
+#include <chrono>
 
 /**
  * The mxgui application is started here.
@@ -53,3 +55,39 @@ void QTBackend::start(std::shared_ptr<UpdateSignalSender> sender)
     std::thread t(appThread);
     t.detach();
 }
+
+void QTBackend::startHeadless()
+{
+    start(std::shared_ptr<UpdateSignalSender>());
+}
+
+void QTBackend::frameUpdated()
+{
+    using namespace std::chrono;
+    long long now=duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count();
+    std::unique_lock<std::mutex> l(statsMutex);
+    if(stats.frames==0) stats.first=now;
+    else stats.maxInterval=std::max(stats.maxInterval,now-stats.last);
+    stats.last=now;
+    stats.frames++;
+}
+
+QTBackend::FrameStats QTBackend::getFrameStats()
+{
+    std::unique_lock<std::mutex> l(statsMutex);
+    return stats;
+}
+
+unsigned long long QTBackend::hashFrameBuffer()
+{
+    const unsigned char *data=
+        reinterpret_cast<const unsigned char*>(fb.getData());
+    unsigned long long result=0xcbf29ce484222325ULL;
+    for(unsigned int i=0;i<fb.getDataSize();i++)
+    {
+        result^=data[i];
+        result*=0x100000001b3ULL;
+    }
+    return result;
+}
@@ -19,6 +19,7 @@
 
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include "config/mxgui_settings.h"
 #include "color.h"
 
@@ -77,6 +78,11 @@ public:
      */
     void *getData() { return &data[0][0]; }
 
+    /**
+     * \return the size in bytes of the framebuffer data
+     */
+    unsigned int getDataSize() const { return sizeof(data); }
+
 private:
     ///Pixel data, stored as [M][N] because matches QImage's representation
     T data[M][N];
@@ -142,6 +148,11 @@ public:
      */
     void *getData() { return &data[0][0]; }
 
+    /**
+     * \return the size in bytes of the framebuffer data
+     */
+    unsigned int getDataSize() const { return sizeof(data); }
+
 private:
     ///Pixel data, stored as [M][N] because matches QImage's representation
     unsigned char data[M][(N+7)/8];
@@ -173,6 +184,39 @@ public:
      */
     void start(std::shared_ptr<UpdateSignalSender> sender);
 
+    /**
+     * Start application without a GUI. The framebuffer is updated but never
+     * shown, used to replay recorded input for performance measurements.
+     */
+    void startHeadless();
+
+    /**
+     * Called by the display driver every time the display is updated, to
+     * collect frame timing statistics
+     */
+    void frameUpdated();
+
+    /**
+     * Frame timing statistics, times are in nanoseconds
+     */
+    struct FrameStats
+    {
+        unsigned int frames;   ///< Number of display updates
+        long long first;       ///< Time of the first update
+        long long last;        ///< Time of the last update
+        long long maxInterval; ///< Longest time between two updates
+    };
+
+    /**
+     * \return the frame timing statistics
+     */
+    FrameStats getFrameStats();
+
+    /**
+     * \return a 64 bit FNV-1a hash of the framebuffer content
+     */
+    unsigned long long hashFrameBuffer();
+
     /**
      * Allows access to the framebuffer object
      * \return the framebuffer
@@ -192,9 +236,11 @@ private:
     /**
      * Constructor
      */
-    QTBackend(): started(false) {}
+    QTBackend(): started(false), stats() {}
 
     FrameBuffer fb; ///< Framebuffer object
     bool started; ///< True if the background thread has already been started
     std::shared_ptr<UpdateSignalSender> sender; ///< Object to update GUI
+    std::mutex statsMutex; ///< Protects stats
+    FrameStats stats; ///< Frame timing statistics
 };
@@ -1,14 +1,111 @@
 
 #include <QtWidgets/QApplication>
 #include <filesystem>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
 #include "window.h"
+#include "qtbackend.h"
+#include "mxgui_settings.h"
+#include "level2/input.h"
+#include "level2/latency_tracker.h"
 
 using namespace std::filesystem;
 
+#ifdef MXGUI_LEVEL_2
+
+/**
+ * Replay recorded input without showing the GUI, then print frame timing
+ * statistics and a hash of the final framebuffer content
+ * \param filename file with the recorded input
+ * \param realTime true to replay with the recorded timing
+ * \return the exit code
+ */
+static int headlessReplay(const char *filename, bool realTime)
+{
+    using namespace std::chrono;
+    //Time without display updates after the replay ends to consider the
+    //application done with drawing
+    const long long settleTime=500000000LL;
+    auto now=[]{
+        return duration_cast<nanoseconds>(
+            steady_clock::now().time_since_epoch()).count();
+    };
+    mxgui::InputHandler& input=mxgui::InputHandler::instance();
+    if(input.startReplay(filename,realTime)==false)
+    {
+        fprintf(stderr,"Error: can't open %s\n",filename);
+        return 1;
+    }
+    QTBackend& qb=QTBackend::instance();
+    long long start=now();
+    qb.startHeadless();
+    input.waitReplayEnd();
+    long long replayEnd=now();
+    for(;;)
+    {
+        QTBackend::FrameStats s=qb.getFrameStats();
+        long long t=now();
+        if(t-replayEnd>=settleTime && (s.frames==0 || t-s.last>=settleTime))
+            break;
+        std::this_thread::sleep_for(milliseconds(50));
+    }
+    QTBackend::FrameStats s=qb.getFrameStats();
+    long long duration=s.frames==0 ? 0 : s.last-start;
+    long long mean=s.frames<2 ? 0 : (s.last-s.first)/(s.frames-1);
+    printf("frames=%u duration=%lldus mean_interval=%lldus max_interval=%lldus\n",
+           s.frames,duration/1000,mean/1000,s.maxInterval/1000);
+    printf("framebuffer_hash=%016llx\n",qb.hashFrameBuffer());
+    #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+    mxgui::LatencyTracker::instance().dumpToFile("latency.txt");
+    #endif //MXGUI_ENABLE_LATENCY_TRACKING
+    return 0;
+}
+
+#endif //MXGUI_LEVEL_2
+
+/*
+ * Usage: qtsimulator [--record file] [--replay file [--fast]]
+ * --record records input events to a file
+ * --replay replays recorded input without GUI, printing frame timing and a
+ *          hash of the final framebuffer, to be used as a regression test
+ * --fast   replays input as fast as possible instead of in real time
+ */
 int main(int argc, char *argv[])
 {
     current_path(path(argv[0]).parent_path()); //chdir() to executable's path
+    #ifdef MXGUI_LEVEL_2
+    const char *replay=nullptr;
+    bool realTime=true;
+    for(int i=1;i<argc;i++)
+    {
+        if(strcmp(argv[i],"--fast")==0) realTime=false;
+        else if(strcmp(argv[i],"--replay")==0 && i+1<argc) replay=argv[++i];
+        else if(strcmp(argv[i],"--record")==0 && i+1<argc)
+        {
+            if(mxgui::InputHandler::instance().startRecording(argv[++i])==false)
+                fprintf(stderr,"Error: can't record to %s\n",argv[i]);
+        }
+    }
+    if(replay)
+    {
+        int result=headlessReplay(replay,realTime);
+        mxgui::InputHandler::instance().stopRecording();
+        //The application thread may still be running, so don't return
+        fflush(stdout);
+        _Exit(result);
+    }
+    #endif //MXGUI_LEVEL_2
     QApplication a(argc,argv);
     Window window;
-    return a.exec();
+    int result=a.exec();
+    #if defined(MXGUI_LEVEL_2) && defined(MXGUI_ENABLE_LATENCY_TRACKING)
+    mxgui::LatencyTracker::instance().dumpToFile("latency.txt");
+    #endif //MXGUI_LEVEL_2 && MXGUI_ENABLE_LATENCY_TRACKING
+    #ifdef MXGUI_LEVEL_2
+    mxgui::InputHandler::instance().stopRecording();
+    #endif //MXGUI_LEVEL_2
+    return result;
 }
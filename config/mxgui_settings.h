@@ -32,7 +32,7 @@
 
 #pragma once
 
-#define MXGUI_SETTINGS_VERSION 102
+#define MXGUI_SETTINGS_VERSION 103
 
 namespace mxgui {
 
@@ -53,11 +53,52 @@ namespace mxgui {
 ///
 static const unsigned int level2MaxNumApps=4;
 
+///
+/// Period in milliseconds of the frame clock used to pace animations
+/// (valid only if MXGUI_LEVEL_2 is defined)
+///
+static const unsigned int level2FramePeriod=20;
+
 ///
 /// Enable or disable ResourceFs, only some targets support it
 ///
 //#define MXGUI_ENABLE_RESOURCEFS
 
+///
+/// Enable performance counters. When enabled, each Display keeps count of
+/// calls, pixels and time spent in the drawing primitives, see
+/// DrawingContext::getPerformanceCounters(). Disabled by default as it adds
+/// overhead to every graphic primitive call
+///
+//#define MXGUI_ENABLE_PERF_COUNTERS
+
+///
+/// Enable the trace recorder. When enabled, a timeline of drawing activity
+/// and events is recorded in a ring buffer that can be dumped in Chrome
+/// trace JSON format, see Tracer. Disabled by default
+///
+//#define MXGUI_ENABLE_TRACE
+
+///
+/// Number of events kept by the trace recorder
+/// (valid only if MXGUI_ENABLE_TRACE is defined)
+///
+static const unsigned int traceBufferSize=512;
+
+///
+/// Enable input to photon latency tracking. When enabled, the time from
+/// when an input event is queued to when the redraw it causes is flushed
+/// to the display is recorded, see LatencyTracker. Disabled by default
+/// (valid only if MXGUI_LEVEL_2 is defined)
+///
+//#define MXGUI_ENABLE_LATENCY_TRACKING
+
+///
+/// Number of latency samples kept
+/// (valid only if MXGUI_ENABLE_LATENCY_TRACKING is defined)
+///
+static const unsigned int latencyBufferSize=64;
+
 ///
 /// Choose color depth. Three options are provided for 1, 8 or 16 bit per pixel
 ///
@@ -94,6 +135,13 @@ static const unsigned int level2MaxNumApps=4;
 //Default font
 #define defaultFont droid11
 
+///
+/// Enable TrueTypeFont, that renders fonts from TrueType files at runtime,
+/// at any size. Disabled by default as it requires more RAM and CPU than
+/// the fonts generated by fontrendering
+///
+//#define MXGUI_ENABLE_TRUETYPE
+
 #else //_MIOSIX
 
 // Enable or disable level 2.
@@ -110,11 +158,52 @@ static const unsigned int level2MaxNumApps=4;
 ///
 static const int level2MaxNumApps=4;
 
+//
+// Period in milliseconds of the frame clock used to pace animations
+// (valid only if MXGUI_LEVEL_2 is defined)
+//
+static const unsigned int level2FramePeriod=20;
+
 //
 // Enable or disable ResourceFs, only some targets support it
 //
 //#define MXGUI_ENABLE_RESOURCEFS
 
+//
+// Enable performance counters. When enabled, each Display keeps count of
+// calls, pixels and time spent in the drawing primitives, see
+// DrawingContext::getPerformanceCounters(). Disabled by default as it adds
+// overhead to every graphic primitive call
+//
+//#define MXGUI_ENABLE_PERF_COUNTERS
+
+//
+// Enable the trace recorder. When enabled, a timeline of drawing activity
+// and events is recorded in a ring buffer that can be dumped in Chrome
+// trace JSON format, see Tracer. Disabled by default
+//
+//#define MXGUI_ENABLE_TRACE
+
+//
+// Number of events kept by the trace recorder
+// (valid only if MXGUI_ENABLE_TRACE is defined)
+//
+static const unsigned int traceBufferSize=4096;
+
+//
+// Enable input to photon latency tracking. When enabled, the time from
+// when an input event is queued to when the redraw it causes is flushed
+// to the display is recorded, see LatencyTracker. Disabled by default
+// (valid only if MXGUI_LEVEL_2 is defined)
+//
+//#define MXGUI_ENABLE_LATENCY_TRACKING
+
+//
+// Number of latency samples kept
+// (valid only if MXGUI_ENABLE_LATENCY_TRACKING is defined)
+//
+static const unsigned int latencyBufferSize=1024;
+
 //
 // Choose color depth.
 //
@@ -148,6 +237,13 @@ static const unsigned int SIMULATOR_BGCOLOR=0;
 //Default font
 #define defaultFont droid11
 
+//
+// Enable TrueTypeFont, that renders fonts from TrueType files at runtime,
+// at any size. Disabled by default as it requires more RAM and CPU than
+// the fonts generated by fontrendering
+//
+//#define MXGUI_ENABLE_TRUETYPE
+
 #endif //_MIOSIX
 
 } //namespace mxgui
@@ -28,8 +28,9 @@
 #include "display.h"
 #include "misc_inst.h"
 #include "pthread_lock.h"
+#include <algorithm>
 
-#if MXGUI_SETTINGS_VERSION != 102
+#if MXGUI_SETTINGS_VERSION != 103
 #error Wrong mxgui_settings.h version. You need to upgrade it.
 #endif
 
@@ -66,11 +67,60 @@ DisplayManager::DisplayManager()
     registerDisplayHook(*this);
 }
 
+//
+// class Display::TransparentSpanWriter
+//
+
+class Display::TransparentSpanWriter
+{
+public:
+    TransparentSpanWriter(Display *d) : d(d), lastBg(d->textColor[0]),
+            pixelMode(false)
+    {
+        copy(d->textColor,d->textColor+4,palette);
+    }
+
+    void operator()(Point s, short len, unsigned char level)
+    {
+        if(level==3 && len>1)
+        {
+            d->line(s,Point(s.x(),s.y()+len-1),d->textColor[3]);
+            pixelMode=false;
+            return;
+        }
+        if(pixelMode==false)
+        {
+            d->beginPixel();
+            pixelMode=true;
+        }
+        for(short i=0;i<len;i++)
+        {
+            Point q(s.x(),s.y()+i);
+            Color bg;
+            if(level!=3 && d->getPixel(q,bg) && bg!=lastBg)
+            {
+                Font::generatePalette(palette,d->textColor[3],bg);
+                lastBg=bg;
+            }
+            d->setPixel(q,palette[level]);
+        }
+    }
+
+private:
+    Display *d;
+    //Palette cache, blending the foreground with the same background color
+    //is common when drawing over flat areas
+    Color palette[4];
+    Color lastBg;
+    bool pixelMode;
+};
+
 //
 // class Display
 //
 
-Display::Display() : isDisplayOn(true), font(defaultFont)
+Display::Display() : isDisplayOn(true), transparentText(false),
+        font(defaultFont)
 {
     pthread_mutexattr_t temp;
     pthread_mutexattr_init(&temp);
@@ -101,6 +151,102 @@ void Display::setBrightness(int brt)
     doSetBrightness(brt);
 }
 
+void Display::transparentWrite(Point p, const char *text)
+{
+    short int yEnd=min<short>(p.y()+font.getHeight(),getHeight())-1;
+    if(p.x()<0 || p.y()<0 || p.x()>=getWidth() || p.y()>yEnd) return;
+    clippedTransparentWrite(p,p,Point(getWidth()-1,yEnd),text);
+}
+
+void Display::clippedTransparentWrite(Point p, Point a, Point b,
+        const char *text)
+{
+    font.clippedDrawSpans(p,a,b,text,TransparentSpanWriter(this));
+}
+
+void Display::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    //Background pixels are the most, clear them all at once
+    short xa=max(p.x(),a.x());
+    short xb=min<short>(p.x()+run.getWidth()-1,b.x());
+    short ya=max(p.y(),a.y());
+    short yb=min<short>(p.y()+run.getHeight()-1,b.y());
+    if(xa>xb || ya>yb) return;
+    clear(Point(xa,ya),Point(xb,yb),textColor[0]);
+    bool pixelMode=false;
+    run.clippedDrawSpans(p,a,b,[&](Point s, short len, unsigned char level)
+    {
+        if(len>1)
+        {
+            line(s,Point(s.x(),s.y()+len-1),textColor[level]);
+            pixelMode=false;
+            return;
+        }
+        if(pixelMode==false)
+        {
+            beginPixel();
+            pixelMode=true;
+        }
+        setPixel(s,textColor[level]);
+    });
+}
+
+void Display::clippedTransparentWriteRun(Point p, Point a, Point b,
+        const TextRun& run)
+{
+    run.clippedDrawSpans(p,a,b,TransparentSpanWriter(this));
+}
+
+void Display::clippedDrawSprite(Point p, Point a, Point b,
+        const Sprite& sprite)
+{
+    sprite.clippedDrawSpans(p,a,b,[this](Point s, const Color *pixels,
+                                         short length)
+    {
+        scanLine(s,pixels,length);
+    });
+}
+
+bool Display::getPixel(Point, Color&) { return false; }
+
+bool Display::copyArea(Point a, Point b, Point dst)
+{
+    short int width=b.x()-a.x()+1;
+    short int height=b.y()-a.y()+1;
+    if(width<=0 || height<=0 || a.x()<0 || a.y()<0 || dst.x()<0 || dst.y()<0
+        || b.x()>=getWidth() || b.y()>=getHeight()
+        || dst.x()+width>getWidth() || dst.y()+height>getHeight()) return false;
+    Color c;
+    if(getPixel(a,c)==false) return false;
+    //When copying downwards start from the last line, not to overwrite lines
+    //yet to be copied. Each line is read entirely before being written, so
+    //horizontal overlap is not an issue
+    bool down=dst.y()>a.y();
+    for(short int i=0;i<height;i++)
+    {
+        short int y=down ? height-1-i : i;
+        Color *buffer=getScanLineBuffer();
+        for(short int x=0;x<width;x++)
+            getPixel(Point(a.x()+x,a.y()+y),buffer[x]);
+        scanLineBuffer(Point(dst.x(),dst.y()+y),width);
+    }
+    return true;
+}
+
+#ifdef MXGUI_ENABLE_PERF_COUNTERS
+PerformanceCounters Display::getPerformanceCounters()
+{
+    PthreadLock lock(dispMutex);
+    return perf;
+}
+
+void Display::resetPerformanceCounters()
+{
+    PthreadLock lock(dispMutex);
+    perf.reset();
+}
+#endif //MXGUI_ENABLE_PERF_COUNTERS
+
 void Display::setTextColor(pair<Color,Color> colors)
 {
     Font::generatePalette(textColor,colors.first,colors.second);
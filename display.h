@@ -35,7 +35,11 @@
 #include "point.h"
 #include "color.h"
 #include "font.h"
+#include "text_run.h"
 #include "image.h"
+#include "sprite.h"
+#include "perf_counters.h"
+#include "trace.h"
 
 namespace mxgui {
 
@@ -156,6 +160,20 @@ public:
      * \return the display's width
      */
     short int getWidth() const { return doGetSize().second; }
+
+    #ifdef MXGUI_ENABLE_PERF_COUNTERS
+    /**
+     * \return a snapshot of the display performance counters. Only available
+     * if MXGUI_ENABLE_PERF_COUNTERS is defined in mxgui_settings.h
+     */
+    PerformanceCounters getPerformanceCounters();
+
+    /**
+     * Reset the display performance counters. Only available if
+     * MXGUI_ENABLE_PERF_COUNTERS is defined in mxgui_settings.h
+     */
+    void resetPerformanceCounters();
+    #endif //MXGUI_ENABLE_PERF_COUNTERS
     
     /**
      * Destructor
@@ -297,6 +315,100 @@ protected:
      */
     virtual void drawRectangle(Point a, Point b, Color c)=0;
 
+    /**
+     * Write text to the display without drawing the background color, only
+     * the foreground and antialiasing pixels are written. The default
+     * implementation is built on top of clippedTransparentWrite().
+     * \param p point where the upper left corner of the text will be printed
+     * \param text, text to print.
+     */
+    virtual void transparentWrite(Point p, const char *text);
+
+    /**
+     * Write part of text to the display without drawing the background color.
+     * Antialiasing pixels are blended with the pixels already on screen if
+     * the display supports getPixel(), otherwise they are drawn with the
+     * colors blended against the text background color. The default
+     * implementation draws vertical runs of pixels through line() and
+     * setPixel(), backends may override it with a faster version.
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param text text to write
+     */
+    virtual void clippedTransparentWrite(Point p, Point a, Point b,
+            const char *text);
+
+    /**
+     * Write part of a TextRun to the display, with the font of the run.
+     * The default implementation clears the background and then draws
+     * vertical runs of pixels through line() and setPixel(), backends may
+     * override it to draw through pixel iterators with
+     * TextRun::clippedDraw().
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    virtual void clippedWriteRun(Point p, Point a, Point b, const TextRun& run);
+
+    /**
+     * Write part of a TextRun to the display without drawing the background
+     * color, with the font of the run, see clippedTransparentWrite()
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    virtual void clippedTransparentWriteRun(Point p, Point a, Point b,
+            const TextRun& run);
+
+    /**
+     * Draw part of a sprite on the screen, leaving transparent pixels as
+     * they are. The default implementation draws each run of opaque pixels
+     * with scanLine(), backends may override it with a faster version.
+     * \param p point of the upper left corner where the sprite will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param sprite sprite to draw
+     */
+    virtual void clippedDrawSprite(Point p, Point a, Point b,
+            const Sprite& sprite);
+
+    /**
+     * Read back the color of a pixel. Only displays that keep their
+     * framebuffer in the microcontroller memory can implement this, the
+     * default implementation always fails.
+     * \param p point of the pixel to read
+     * \param color the pixel color is returned here
+     * \return true if the color could be read
+     */
+    virtual bool getPixel(Point p, Color& color);
+
+    /**
+     * Copy a rectangular area of the screen to another position, used to
+     * scroll. Source and destination areas can overlap. The default
+     * implementation copies one line at a time through getPixel() and
+     * scanLineBuffer(), displays that keep their framebuffer in the
+     * microcontroller memory may override it with a faster version.
+     * \param a upper left corner of the area to copy
+     * \param b lower right corner of the area to copy
+     * \param dst where the upper left corner of the area is copied. Both the
+     * source and destination areas must be within the screen
+     * \return false if the display can't read back pixels or the areas are
+     * not within the screen. In this case nothing is copied, and the caller
+     * has to redraw the destination area
+     */
+    virtual bool copyArea(Point a, Point b, Point dst);
+
     /**
      * Set colors used for writing text
      * \param colors a pair with the text foreground and background colors
@@ -319,6 +431,18 @@ protected:
      * \return the current font used to draw text
      */
     Font getFont() const;
+
+    /**
+     * Select whether text is written with a transparent background
+     * \param transparent if true write() and clippedWrite() only draw the
+     * text foreground and antialiasing pixels, leaving the background as is
+     */
+    void setTransparentText(bool transparent) { transparentText=transparent; }
+
+    /**
+     * \return true if text is written with a transparent background
+     */
+    bool getTransparentText() const { return transparentText; }
     
     /**
      * Make all changes done to the display since the last call to update()
@@ -329,9 +453,18 @@ protected:
 private:
     Display(const Display&)=delete;
     Display& operator=(const Display&)=delete;
+
+    /// Functor passed to clippedDrawSpans() to draw text without its
+    /// background, common to clippedTransparentWrite() and
+    /// clippedTransparentWriteRun()
+    class TransparentSpanWriter;
     
     pthread_mutex_t dispMutex; ///< To lock concurrent access to the display
     bool isDisplayOn;          ///< True if display is on
+    bool transparentText;      ///< True if text background is not drawn
+    #ifdef MXGUI_ENABLE_PERF_COUNTERS
+    PerformanceCounters perf;  ///< Performance counters
+    #endif //MXGUI_ENABLE_PERF_COUNTERS
     
 protected:
     Font font;                 ///< Current font selected for writing text
@@ -360,7 +493,20 @@ public:
      */
     DrawingContext(Display& display) : display(display)
     {
+        #if defined(MXGUI_ENABLE_PERF_COUNTERS) || defined(MXGUI_ENABLE_TRACE)
+        long long t=perfTime();
         pthread_mutex_lock(&display.dispMutex);
+        lockTime=perfTime();
+        #ifdef MXGUI_ENABLE_PERF_COUNTERS
+        display.perf.drawingContexts++;
+        display.perf.mutexWaitTime+=lockTime-t;
+        #endif //MXGUI_ENABLE_PERF_COUNTERS
+        #ifdef MXGUI_ENABLE_TRACE
+        Tracer::instance().complete("dispMutex wait",t,lockTime-t);
+        #endif //MXGUI_ENABLE_TRACE
+        #else //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
+        pthread_mutex_lock(&display.dispMutex);
+        #endif //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
     }
     
     /**
@@ -394,7 +540,13 @@ public:
      */
     void write(Point p, const char *text)
     {
-        display.write(p,text);
+        MXGUI_TRACE_SCOPE("write");
+        //Measuring the text length decodes it again, so it is not timed
+        MXGUI_PERF_SCOPE_LAZY(display.perf,Write,
+            area(p,Point(p.x()+display.font.calculateLength(text)-1,
+                         p.y()+display.font.getHeight()-1)));
+        if(display.transparentText) display.transparentWrite(p,text);
+        else display.write(p,text);
     }
     
     /**
@@ -404,7 +556,7 @@ public:
      */
     void write(Point p, const std::string& text)
     {
-        display.write(p,text.c_str());
+        write(p,text.c_str());
     }
 
     /**
@@ -418,7 +570,10 @@ public:
      */
     void clippedWrite(Point p, Point a, Point b, const char *text)
     {
-        display.clippedWrite(p,a,b,text);
+        MXGUI_TRACE_SCOPE("write");
+        MXGUI_PERF_SCOPE(display.perf,Write,area(a,b));
+        if(display.transparentText) display.clippedTransparentWrite(p,a,b,text);
+        else display.clippedWrite(p,a,b,text);
     }
     
     /**
@@ -432,7 +587,39 @@ public:
      */
     void clippedWrite(Point p, Point a, Point b, const std::string& text)
     {
-        display.clippedWrite(p,a,b,text.c_str());
+        clippedWrite(p,a,b,text.c_str());
+    }
+
+    /**
+     * Write a TextRun to the display, with the font of the run. If text is
+     * too long it will be truncated
+     * \param p point where the upper left corner of the text will be printed
+     * \param run text to print
+     */
+    void write(Point p, const TextRun& run)
+    {
+        short int yEnd=std::min<short>(p.y()+run.getHeight(),getHeight())-1;
+        if(p.x()<0 || p.y()<0 || p.x()>=getWidth() || p.y()>yEnd) return;
+        clippedWrite(p,p,Point(getWidth()-1,yEnd),run);
+    }
+
+    /**
+     * Write part of a TextRun to the display, with the font of the run
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    void clippedWrite(Point p, Point a, Point b, const TextRun& run)
+    {
+        MXGUI_TRACE_SCOPE("write");
+        MXGUI_PERF_SCOPE(display.perf,Write,
+            clippedArea(p,run.getWidth(),run.getHeight(),a,b));
+        if(display.transparentText)
+            display.clippedTransparentWriteRun(p,a,b,run);
+        else display.clippedWriteRun(p,a,b,run);
     }
 
     /**
@@ -441,6 +628,9 @@ public:
      */
     void clear(Color color)
     {
+        MXGUI_TRACE_SCOPE("clear");
+        MXGUI_PERF_SCOPE(display.perf,Clear,
+            area(Point(0,0),Point(getWidth()-1,getHeight()-1)));
         display.clear(color);
     }
 
@@ -452,6 +642,8 @@ public:
      */
     void clear(Point p1, Point p2, Color color)
     {
+        MXGUI_TRACE_SCOPE("clear");
+        MXGUI_PERF_SCOPE(display.perf,Clear,area(p1,p2));
         display.clear(p1,p2,color);
     }
 
@@ -477,6 +669,7 @@ public:
      */
     void setPixel(Point p, Color color)
     {
+        MXGUI_PERF_COUNT(display.perf,SetPixel,1);
         display.setPixel(p,color);
     }
 
@@ -488,6 +681,9 @@ public:
      */
     void line(Point a, Point b, Color color)
     {
+        MXGUI_TRACE_SCOPE("line");
+        MXGUI_PERF_SCOPE(display.perf,Line,
+            std::max(std::abs(b.x()-a.x()),std::abs(b.y()-a.y()))+1);
         display.line(a,b,color);
     }
 
@@ -502,6 +698,8 @@ public:
      */
     void scanLine(Point p, const Color *colors, unsigned short length)
     {
+        MXGUI_TRACE_SCOPE("scanLine");
+        MXGUI_PERF_SCOPE(display.perf,ScanLine,length);
         display.scanLine(p,colors,length);
     }
     
@@ -523,6 +721,8 @@ public:
      */
     void scanLineBuffer(Point p, unsigned short length)
     {
+        MXGUI_TRACE_SCOPE("scanLine");
+        MXGUI_PERF_SCOPE(display.perf,ScanLine,length);
         display.scanLineBuffer(p,length);
     }
 
@@ -533,6 +733,9 @@ public:
      */
     void drawImage(Point p, const ImageBase& img)
     {
+        MXGUI_TRACE_SCOPE("drawImage");
+        MXGUI_PERF_SCOPE(display.perf,DrawImage,
+            area(p,Point(p.x()+img.getWidth()-1,p.y()+img.getHeight()-1)));
         display.drawImage(p,img);
     }
 
@@ -547,9 +750,43 @@ public:
      */
     void clippedDrawImage(Point p, Point a, Point b, const ImageBase& img)
     {
+        MXGUI_TRACE_SCOPE("drawImage");
+        MXGUI_PERF_SCOPE(display.perf,DrawImage,
+            clippedArea(p,img.getWidth(),img.getHeight(),a,b));
         display.clippedDrawImage(p,a,b,img);
     }
 
+    /**
+     * Draw a sprite on the screen, leaving transparent pixels as they are.
+     * Unlike images, sprites are clipped to the screen, so they can move
+     * partially out of it
+     * \param p point of the upper left corner where the sprite will be drawn
+     * \param sprite sprite to draw
+     */
+    void drawSprite(Point p, const Sprite& sprite)
+    {
+        clippedDrawSprite(p,Point(0,0),Point(getWidth()-1,getHeight()-1),
+                          sprite);
+    }
+
+    /**
+     * Draw part of a sprite on the screen, leaving transparent pixels as
+     * they are
+     * \param p point of the upper left corner where the sprite will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param sprite sprite to draw
+     */
+    void clippedDrawSprite(Point p, Point a, Point b, const Sprite& sprite)
+    {
+        MXGUI_TRACE_SCOPE("drawImage");
+        MXGUI_PERF_SCOPE(display.perf,DrawImage,
+            clippedArea(p,sprite.getWidth(),sprite.getHeight(),a,b));
+        display.clippedDrawSprite(p,a,b,sprite);
+    }
+
     /**
      * Draw a rectangle (not filled) with the desired color
      * \param a upper left corner of the rectangle
@@ -558,9 +795,39 @@ public:
      */
     void drawRectangle(Point a, Point b, Color c)
     {
+        MXGUI_TRACE_SCOPE("drawRectangle");
+        MXGUI_PERF_SCOPE(display.perf,DrawRectangle,
+            2*(std::abs(b.x()-a.x())+std::abs(b.y()-a.y())));
         display.drawRectangle(a,b,c);
     }
 
+    /**
+     * Read back the color of a pixel. Only supported by displays that keep
+     * their framebuffer in the microcontroller memory.
+     * \param p point of the pixel to read
+     * \param color the pixel color is returned here
+     * \return true if the color could be read
+     */
+    bool getPixel(Point p, Color& color)
+    {
+        return display.getPixel(p,color);
+    }
+
+    /**
+     * Copy a rectangular area of the screen to another position, used to
+     * scroll. Source and destination areas can overlap.
+     * \param a upper left corner of the area to copy
+     * \param b lower right corner of the area to copy
+     * \param dst where the upper left corner of the area is copied
+     * \return false if the display does not support it, in this case nothing
+     * is copied and the destination area has to be redrawn
+     */
+    bool copyArea(Point a, Point b, Point dst)
+    {
+        MXGUI_TRACE_SCOPE("copyArea");
+        return display.copyArea(a,b,dst);
+    }
+
     /**
      * Set colors used for writing text
      * \param fgcolor text color
@@ -623,13 +890,72 @@ public:
     {
         return display.getFont();
     }
+
+    /**
+     * Select whether text is written with a transparent background
+     * \param transparent if true write() and clippedWrite() only draw the
+     * text foreground and antialiasing pixels, leaving the background as is
+     */
+    void setTransparentText(bool transparent)
+    {
+        display.setTransparentText(transparent);
+    }
+
+    /**
+     * \return true if text is written with a transparent background
+     */
+    bool getTransparentText() const
+    {
+        return display.getTransparentText();
+    }
+
+    #ifdef MXGUI_ENABLE_PERF_COUNTERS
+    /**
+     * \return the display performance counters. Only available if
+     * MXGUI_ENABLE_PERF_COUNTERS is defined in mxgui_settings.h.
+     * The time spent in update() and holding the display mutex by this
+     * DrawingContext is accounted when the DrawingContext is destroyed
+     */
+    const PerformanceCounters& getPerformanceCounters() const
+    {
+        return display.perf;
+    }
+
+    /**
+     * Reset the display performance counters. Only available if
+     * MXGUI_ENABLE_PERF_COUNTERS is defined in mxgui_settings.h
+     */
+    void resetPerformanceCounters()
+    {
+        display.perf.reset();
+    }
+    #endif //MXGUI_ENABLE_PERF_COUNTERS
     
     /**
      * Destructor
      */
     ~DrawingContext()
     {
+        #if defined(MXGUI_ENABLE_PERF_COUNTERS) || defined(MXGUI_ENABLE_TRACE)
+        long long t=perfTime();
+        display.update();
+        long long unlockTime=perfTime();
+        #ifdef MXGUI_ENABLE_PERF_COUNTERS
+        display.perf.update.calls++;
+        display.perf.update.time+=unlockTime-t;
+        long long hold=unlockTime-lockTime;
+        display.perf.mutexHoldTime+=hold;
+        if(hold>display.perf.maxMutexHoldTime)
+            display.perf.maxMutexHoldTime=hold;
+        #endif //MXGUI_ENABLE_PERF_COUNTERS
+        #ifdef MXGUI_ENABLE_TRACE
+        Tracer::instance().complete("update",t,unlockTime-t);
+        Tracer::instance().complete("DrawingContext",lockTime,
+                                    unlockTime-lockTime);
+        #endif //MXGUI_ENABLE_TRACE
+        #else //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
         display.update();
+        #endif //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
         pthread_mutex_unlock(&display.dispMutex);
     }
 
@@ -637,7 +963,39 @@ private:
     DrawingContext(const DrawingContext&)=delete;
     DrawingContext& operator=(DrawingContext&)=delete;
 
+    #ifdef MXGUI_ENABLE_PERF_COUNTERS
+    /**
+     * \param a upper left corner
+     * \param b lower right corner
+     * \return the number of pixels in the rectangle
+     */
+    static unsigned int area(Point a, Point b)
+    {
+        if(b.x()<a.x() || b.y()<a.y()) return 0;
+        return (b.x()-a.x()+1)*(b.y()-a.y()+1);
+    }
+
+    /**
+     * \param p upper left corner of a rectangle
+     * \param width rectangle width
+     * \param height rectangle height
+     * \param a upper left corner of the clipping rectangle
+     * \param b lower right corner of the clipping rectangle
+     * \return the number of pixels of the rectangle within the clipping one
+     */
+    static unsigned int clippedArea(Point p, short width, short height,
+            Point a, Point b)
+    {
+        return area(Point(std::max(p.x(),a.x()),std::max(p.y(),a.y())),
+            Point(std::min<short>(p.x()+width-1,b.x()),
+                  std::min<short>(p.y()+height-1,b.y())));
+    }
+    #endif //MXGUI_ENABLE_PERF_COUNTERS
+
     Display& display; ///< Underlying display object
+    #if defined(MXGUI_ENABLE_PERF_COUNTERS) || defined(MXGUI_ENABLE_TRACE)
+    long long lockTime; ///< When the display mutex was locked
+    #endif //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
 };
 
 } //namespace mxgui
@@ -35,18 +35,21 @@ namespace mxgui {
 class StateSaver
 {
 public:
-    StateSaver(DrawingContext& dc) : dc(dc), savedFont(dc.getFont()), savedColor(dc.getTextColor())
+    StateSaver(DrawingContext& dc) : dc(dc), savedFont(dc.getFont()), savedColor(dc.getTextColor()),
+        savedTransparent(dc.getTransparentText())
     {}
     
     ~StateSaver()
     {
         dc.setFont(savedFont);
         dc.setTextColor(savedColor);
+        dc.setTransparentText(savedTransparent);
     }
 private:
     DrawingContext& dc;
     Font savedFont;
     std::pair<Color,Color> savedColor;
+    bool savedTransparent;
 };
 
 } //namespace mxgui
@@ -155,6 +155,14 @@ void DisplayImpl::clippedWrite(Point p, Point a, Point b, const char *text)
     font.clippedDraw(*this,textColor,p,a,b,text);
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    if(a.x()<0 || a.y()<0 || b.x()<0 || b.y()<0) return;
+    if(a.x()>=width || a.y()>=height || b.x()>=width || b.y()>=height) return;
+
+    run.clippedDraw(*this,textColor,p,a,b);
+}
+
 void DisplayImpl::clear(Color color)
 {
     memset(framebuffer,color ? 0x00 : 0xff,256*128/8);
@@ -59,6 +59,12 @@ void DisplayGeneric1BPP::clippedWrite(Point p, Point a, Point b, const char *tex
     font.clippedDraw(*this,textColor,p,a,b,text);
 }
 
+void DisplayGeneric1BPP::clippedWriteRun(Point p, Point a, Point b,
+        const TextRun& run)
+{
+    run.clippedDraw(*this,textColor,p,a,b);
+}
+
 void DisplayGeneric1BPP::clear(Color color)
 {
     memset(backbuffer,conv2(color),fbSize);
@@ -145,6 +145,11 @@ void DisplayImpl::clippedWrite(Point p, Point a, Point b, const char *text)
     font.clippedDraw(*this,textColor,p,a,b,text);
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    run.clippedDraw(*this,textColor,p,a,b);
+}
+
 void DisplayImpl::clear(Color color)
 {
     clear(Point(0,0),Point(width-1,height-1),color);
@@ -293,6 +298,13 @@ void DisplayImpl::drawRectangle(Point a, Point b, Color c)
     line(Point(a.x(),b.y()),a,c);
 }
 
+bool DisplayImpl::getPixel(Point p, Color& color)
+{
+    if(p.x()<0 || p.y()<0 || p.x()>=width || p.y()>=height) return false;
+    color=*(framebuffer1+p.x()+p.y()*width);
+    return true;
+}
+
 DisplayImpl::pixel_iterator DisplayImpl::begin(Point p1, Point p2,
         IteratorDirection d)
 {
@@ -106,6 +106,26 @@ void DisplayImpl::clippedWrite(Point p, Point a, Point b, const char *text)
     beginPixelCalled=false;
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    //Qt backend is meant to catch errors, so be bastard
+    if(a.x()<0 || a.y()<0 || b.x()<0 || b.y()<0)
+        throw(logic_error("DisplayImpl::clippedWriteRun:"
+                " negative value in point"));
+    if(a.x()>=width || a.y()>=height || b.x()>=width || b.y()>=height)
+        throw(logic_error("DisplayImpl::clippedWriteRun:"
+                " point outside display bounds"));
+    if(a.x()>b.x() || a.y()>b.y())
+        throw(logic_error("DisplayImpl::clippedWriteRun: reversed points"));
+
+    #ifndef PEDANTIC_ITERATORS_CHECK
+    run.clippedDraw(*this,textColor,p,a,b);
+    #else //PEDANTIC_ITERATORS_CHECK
+    run.clippedDraw<DisplayImpl,true>(*this,textColor,p,a,b);
+    #endif //PEDANTIC_ITERATORS_CHECK
+    beginPixelCalled=false;
+}
+
 void DisplayImpl::clear(Color color)
 {
     clear(Point(0,0),Point(width-1,height-1),color);
@@ -220,9 +240,18 @@ void DisplayImpl::drawRectangle(Point a, Point b, Color c)
     line(Point(a.x(),b.y()),a,c);
 }
 
+bool DisplayImpl::getPixel(Point p, Color& color)
+{
+    if(p.x()<0 || p.y()<0 || p.x()>=width || p.y()>=height) return false;
+    color=backend.getFrameBuffer().getPixel(p.x(),p.y());
+    return true;
+}
+
 void DisplayImpl::update()
 {  
-    backend.getSender()->update();
+    //When running headless there is no GUI to update
+    if(backend.getSender()) backend.getSender()->update();
+    backend.frameUpdated();
     beginPixelCalled=false;
 }
 
@@ -121,6 +121,18 @@ public:
      */
     void clippedWrite(Point p, Point a, Point b, const char *text) override;
 
+    /**
+     * Write part of a TextRun to the display, with the font of the run
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    void clippedWriteRun(Point p, Point a, Point b,
+            const TextRun& run) override;
+
     /**
      * Clear the Display. The screen will be filled with the desired color
      * \param color fill color
@@ -134,6 +134,11 @@ void DisplayImpl::clippedWrite(Point p, Point a,  Point b, const char *text)
     font.clippedDraw(*this, textColor, p, a, b, text);
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    run.clippedDraw(*this, textColor, p, a, b);
+}
+
 void DisplayImpl::clear(Color color)
 {
     clear(Point(0,0), Point(width-1,height-1), color);
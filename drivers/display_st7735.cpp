@@ -98,6 +98,11 @@ void DisplayGenericST7735::clippedWrite(Point p, Point a,  Point b, const char *
     font.clippedDraw(*this, textColor, p, a, b, text);
 }
 
+void DisplayGenericST7735::clippedWriteRun(Point p, Point a, Point b,
+        const TextRun& run) {
+    run.clippedDraw(*this, textColor, p, a, b);
+}
+
 void DisplayGenericST7735::clear(Color color) {
     clear(Point(0,0), Point(width-1, height-1), color);
 }
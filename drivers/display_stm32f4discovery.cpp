@@ -154,6 +154,11 @@ void DisplayImpl::clippedWrite(Point p, Point a, Point b, const char *text)
     font.clippedDraw(*this,textColor,p,a,b,text);
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    run.clippedDraw(*this,textColor,p,a,b);
+}
+
 void DisplayImpl::clear(Color color)
 {
     clear(Point(0,0),Point(width-1,height-1),color);
@@ -275,23 +280,45 @@ void DisplayImpl::drawImage(Point p, const ImageBase& img)
     if(p.x()<0 || p.y()<0 || xEnd<p.x() || yEnd<p.y()
         ||xEnd >= width || yEnd >= height) return;
 
-//    const unsigned short *imgData=img.getData();
-//    if(imgData!=0)
-//    {
-//        //TODO Optimized version for in-memory images
-//    } else
-    img.draw(*this,p);
+    short int stride;
+    const Color *imgData=img.getStridedData(stride);
+    if(imgData!=0)
+    {
+        //Optimized version for in-memory images and views into them, one
+        //memcpy per line
+        Color *ptr=framebuffer1+p.x()+width*p.y();
+        for(short int i=0;i<img.getHeight();i++)
+        {
+            memcpy(ptr,imgData,img.getWidth()*bpp);
+            ptr+=width;
+            imgData+=stride;
+        }
+    } else img.draw(*this,p);
 }
 
 void DisplayImpl::clippedDrawImage(Point p, Point a, Point b, const ImageBase& img)
 {
-//    if(img.getData()==0)
-//    {
-    img.clippedDraw(*this,p,a,b);
-    return;
-//    } //else optimized version for memory-loaded images
-//        //TODO: optimize
-//    }
+    short int stride;
+    const Color *imgData=img.getStridedData(stride);
+    if(imgData==0)
+    {
+        img.clippedDraw(*this,p,a,b);
+        return;
+    }
+    //Optimized version for in-memory images, one memcpy per line
+    short int xa=max(p.x(),a.x());
+    short int xb=min<short>(p.x()+img.getWidth()-1,b.x());
+    short int ya=max(p.y(),a.y());
+    short int yb=min<short>(p.y()+img.getHeight()-1,b.y());
+    if(xa>xb || ya>yb) return; //Empty intersection
+    imgData+=(xa-p.x())+(ya-p.y())*stride;
+    Color *ptr=framebuffer1+xa+width*ya;
+    for(short int i=ya;i<=yb;i++)
+    {
+        memcpy(ptr,imgData,(xb-xa+1)*bpp);
+        ptr+=width;
+        imgData+=stride;
+    }
 }
 
 
@@ -303,6 +330,32 @@ void DisplayImpl::drawRectangle(Point a, Point b, Color c)
     line(Point(a.x(),b.y()),a,c);
 }
 
+bool DisplayImpl::getPixel(Point p, Color& color)
+{
+    if(p.x()<0 || p.y()<0 || p.x()>=width || p.y()>=height) return false;
+    color=*(framebuffer1+p.x()+p.y()*width);
+    return true;
+}
+
+bool DisplayImpl::copyArea(Point a, Point b, Point dst)
+{
+    short int w=b.x()-a.x()+1;
+    short int h=b.y()-a.y()+1;
+    if(w<=0 || h<=0 || a.x()<0 || a.y()<0 || dst.x()<0 || dst.y()<0
+        || b.x()>=width || b.y()>=height
+        || dst.x()+w>width || dst.y()+h>height) return false;
+    //When copying downwards start from the last line, not to overwrite lines
+    //yet to be copied
+    bool down=dst.y()>a.y();
+    for(short int i=0;i<h;i++)
+    {
+        short int y=down ? h-1-i : i;
+        memmove(framebuffer1+dst.x()+(dst.y()+y)*width,
+                framebuffer1+a.x()+(a.y()+y)*width,w*bpp);
+    }
+    return true;
+}
+
 DisplayImpl::pixel_iterator DisplayImpl::begin(Point p1, Point p2,
         IteratorDirection d)
 {
@@ -612,6 +665,11 @@ void DisplayImpl::clippedWrite(Point p, Point a, Point b, const char *text)
     font.clippedDraw(*this,textColor,p,a,b,text);
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    run.clippedDraw(*this,textColor,p,a,b);
+}
+
 void DisplayImpl::clear(Color color)
 {
     clear(Point(0,0),Point(width-1,height-1),color);
@@ -733,23 +791,45 @@ void DisplayImpl::drawImage(Point p, const ImageBase& img)
     if(p.x()<0 || p.y()<0 || xEnd<p.x() || yEnd<p.y()
         ||xEnd >= width || yEnd >= height) return;
 
-//    const unsigned short *imgData=img.getData();
-//    if(imgData!=0)
-//    {
-//        //TODO Optimized version for in-memory images
-//    } else
-    img.draw(*this,p);
+    short int stride;
+    const Color *imgData=img.getStridedData(stride);
+    if(imgData!=0)
+    {
+        //Optimized version for in-memory images and views into them, one
+        //memcpy per line
+        Color *ptr=framebuffer1+p.x()+width*p.y();
+        for(short int i=0;i<img.getHeight();i++)
+        {
+            memcpy(ptr,imgData,img.getWidth()*bpp);
+            ptr+=width;
+            imgData+=stride;
+        }
+    } else img.draw(*this,p);
 }
 
 void DisplayImpl::clippedDrawImage(Point p, Point a, Point b, const ImageBase& img)
 {
-//    if(img.getData()==0)
-//    {
-    img.clippedDraw(*this,p,a,b);
-    return;
-//    } //else optimized version for memory-loaded images
-//        //TODO: optimize
-//    }
+    short int stride;
+    const Color *imgData=img.getStridedData(stride);
+    if(imgData==0)
+    {
+        img.clippedDraw(*this,p,a,b);
+        return;
+    }
+    //Optimized version for in-memory images, one memcpy per line
+    short int xa=max(p.x(),a.x());
+    short int xb=min<short>(p.x()+img.getWidth()-1,b.x());
+    short int ya=max(p.y(),a.y());
+    short int yb=min<short>(p.y()+img.getHeight()-1,b.y());
+    if(xa>xb || ya>yb) return; //Empty intersection
+    imgData+=(xa-p.x())+(ya-p.y())*stride;
+    Color *ptr=framebuffer1+xa+width*ya;
+    for(short int i=ya;i<=yb;i++)
+    {
+        memcpy(ptr,imgData,(xb-xa+1)*bpp);
+        ptr+=width;
+        imgData+=stride;
+    }
 }
 
 void DisplayImpl::drawRectangle(Point a, Point b, Color c)
@@ -760,6 +840,32 @@ void DisplayImpl::drawRectangle(Point a, Point b, Color c)
     line(Point(a.x(),b.y()),a,c);
 }
 
+bool DisplayImpl::getPixel(Point p, Color& color)
+{
+    if(p.x()<0 || p.y()<0 || p.x()>=width || p.y()>=height) return false;
+    color=*(framebuffer1+p.x()+p.y()*width);
+    return true;
+}
+
+bool DisplayImpl::copyArea(Point a, Point b, Point dst)
+{
+    short int w=b.x()-a.x()+1;
+    short int h=b.y()-a.y()+1;
+    if(w<=0 || h<=0 || a.x()<0 || a.y()<0 || dst.x()<0 || dst.y()<0
+        || b.x()>=width || b.y()>=height
+        || dst.x()+w>width || dst.y()+h>height) return false;
+    //When copying downwards start from the last line, not to overwrite lines
+    //yet to be copied
+    bool down=dst.y()>a.y();
+    for(short int i=0;i<h;i++)
+    {
+        short int y=down ? h-1-i : i;
+        memmove(framebuffer1+dst.x()+(dst.y()+y)*width,
+                framebuffer1+a.x()+(a.y()+y)*width,w*bpp);
+    }
+    return true;
+}
+
 void DisplayImpl::update()
 {
     DSI->WCR |= DSI_WCR_LTDCEN;
@@ -104,6 +104,18 @@ public:
      */
     void clippedWrite(Point p, Point a, Point b, const char *text) override;
 
+    /**
+     * Write part of a TextRun to the display, with the font of the run
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    void clippedWriteRun(Point p, Point a, Point b,
+            const TextRun& run) override;
+
     /**
      * Clear the Display. The screen will be filled with the desired color
      * \param color fill color
@@ -190,6 +202,24 @@ public:
      * \param c color of the line
      */
     void drawRectangle(Point a, Point b, Color c) override;
+
+    /**
+     * Read back the color of a pixel from the framebuffer
+     * \param p point of the pixel to read
+     * \param color the pixel color is returned here
+     * \return true if the color could be read
+     */
+    bool getPixel(Point p, Color& color) override;
+
+    /**
+     * Copy a rectangular area of the screen to another position, used to
+     * scroll. Source and destination areas can overlap.
+     * \param a upper left corner of the area to copy
+     * \param b lower right corner of the area to copy
+     * \param dst where the upper left corner of the area is copied
+     * \return false if the areas are not within the screen
+     */
+    bool copyArea(Point a, Point b, Point dst) override;
     
     /**
      * Pixel iterator. A pixel iterator is an output iterator that allows to
@@ -432,6 +462,18 @@ public:
      */
     void clippedWrite(Point p, Point a, Point b, const char *text) override;
 
+    /**
+     * Write part of a TextRun to the display, with the font of the run
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    void clippedWriteRun(Point p, Point a, Point b,
+            const TextRun& run) override;
+
     /**
      * Clear the Display. The screen will be filled with the desired color
      * \param color fill color
@@ -518,6 +560,24 @@ public:
      * \param c color of the line
      */
     void drawRectangle(Point a, Point b, Color c) override;
+
+    /**
+     * Read back the color of a pixel from the framebuffer
+     * \param p point of the pixel to read
+     * \param color the pixel color is returned here
+     * \return true if the color could be read
+     */
+    bool getPixel(Point p, Color& color) override;
+
+    /**
+     * Copy a rectangular area of the screen to another position, used to
+     * scroll. Source and destination areas can overlap.
+     * \param a upper left corner of the area to copy
+     * \param b lower right corner of the area to copy
+     * \param dst where the upper left corner of the area is copied
+     * \return false if the areas are not within the screen
+     */
+    bool copyArea(Point a, Point b, Point dst) override;
     
     /**
      * Make all changes done to the display since the last call to update()
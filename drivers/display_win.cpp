@@ -99,6 +99,22 @@ void DisplayImpl::clippedWrite(Point p, Point a, Point b, const char *text)
     beginPixelCalled=false;
 }
 
+void DisplayImpl::clippedWriteRun(Point p, Point a, Point b, const TextRun& run)
+{
+    //backend is meant to catch errors, so be bastard
+    if(a.x()<0 || a.y()<0 || b.x()<0 || b.y()<0)
+        throw(logic_error("DisplayImpl::clippedWriteRun:"
+                " negative value in point"));
+    if(a.x()>=width || a.y()>=height || b.x()>=width || b.y()>=height)
+        throw(logic_error("DisplayImpl::clippedWriteRun:"
+                " point outside display bounds"));
+    if(a.x()>b.x() || a.y()>b.y())
+        throw(logic_error("DisplayImpl::clippedWriteRun: reversed points"));
+
+    run.clippedDraw(*this,textColor,p,a,b);
+    beginPixelCalled=false;
+}
+
 void DisplayImpl::clear(Color color)
 {
     beginPixel();
@@ -28,7 +28,7 @@
 #ifndef _MIOSIX
 
 #include "event_qt.h"
-#include <list>
+#include "level2/event_ring.h"
 #include <mutex>
 #include <condition_variable>
 
@@ -36,17 +36,19 @@ using namespace std;
 
 namespace mxgui {
 
-static mutex eqMutex; ///< Mutex to guard the event queue
+static mutex eqMutex; ///< Mutex to serialize consumers and block getEvent
 static condition_variable eqCond; ///< Condvar for blocking getEvent
-static std::list<Event> eventQueue; ///< Queue of events from the GUI
+static EventRing<128> eventQueue; ///< Queue of events from the GUI
 static std::function<void ()> eventCallback;
 
 void addEvent(Event e)
 {
+    //Only the Qt GUI thread adds events, so there is a single producer.
+    //TouchMove events are coalesced and use at most half of the queue, so
+    //the other events are lost only if the application stops consuming them
+    if(eventQueue.put(e)==false) return;
     {
         unique_lock<mutex> l(eqMutex);
-        if(eventQueue.size()>=100) return;
-        eventQueue.push_back(e); //Drop if queue too long
         eqCond.notify_one();
     }
     if(eventCallback) eventCallback();
@@ -59,18 +61,16 @@ void addEvent(Event e)
 Event InputHandlerImpl::getEvent()
 {
     unique_lock<mutex> l(eqMutex);
-    while(eventQueue.empty()) eqCond.wait(l);
-    Event result=eventQueue.front();
-    eventQueue.pop_front();
+    Event result;
+    while(eventQueue.get(result)==false) eqCond.wait(l);
     return result;
 }
 
 Event InputHandlerImpl::popEvent()
 {
     unique_lock<mutex> l(eqMutex);
-    if(eventQueue.empty()) return Event(); //Default constructed event
-    Event result=eventQueue.front();
-    eventQueue.pop_front();
+    Event result; //Default constructed event if queue empty
+    eventQueue.get(result);
     return result;
 }
 
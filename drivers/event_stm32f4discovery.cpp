@@ -31,6 +31,7 @@
 #if defined(_BOARD_STM32F429ZI_STM32F4DISCOVERY) && defined(MXGUI_LEVEL_2)
 
 #include "event_stm32f4discovery.h"
+#include "level2/event_ring.h"
 #include "miosix.h"
 #include "util/software_i2c.h"
 #include <algorithm>
@@ -177,15 +178,16 @@ static Point getTouchData()
     }
 }
 
-static Queue<Event,10> eventQueue;
+static EventRing<16> eventQueue; ///< Producer is eventThread
+static Semaphore eventSema;       ///< Signaled for each queued event
 static std::function<void ()> eventCallback;
 
 static void callback(Event e)
 {
-    {
-        FastGlobalIrqLock dLock;
-        if(eventQueue.IRQput(e)==false) return;
-    }
+    //TouchMove events are coalesced and use at most half of the queue, so
+    //the other events are lost only if the application stops consuming them
+    if(eventQueue.put(e)==false) return;
+    eventSema.signal();
     if(eventCallback) eventCallback();
 }
 
@@ -299,16 +301,17 @@ InputHandlerImpl::InputHandlerImpl()
 
 Event InputHandlerImpl::getEvent()
 {
+    //Coalesced events leave the semaphore count higher than the number of
+    //queued events, so retry till an event is found
     Event result;
-    eventQueue.get(result);
+    while(eventQueue.get(result)==false) eventSema.wait();
     return result;
 }
 
 Event InputHandlerImpl::popEvent()
 {
-    FastGlobalIrqLock dLock;
     Event result;
-    if(eventQueue.isEmpty()==false) eventQueue.IRQget(result);
+    eventQueue.get(result);
     return result;
 }
 
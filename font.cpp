@@ -39,6 +39,11 @@ namespace mxgui {
 
 bool Font::isInRange(char32_t c) const
 {
+    if(blockStart)
+    {
+        int block=findBlock(c);
+        return block>=0 && c<blocks[2*block]+blocks[2*block+1];
+    }
     const int lastBlock=2*(numBlocks-1);
     for(int block=0;block<lastBlock;block+=2)
         if(c>=blocks[block] && c<blocks[block]+blocks[block+1]) return true;
@@ -47,6 +52,14 @@ bool Font::isInRange(char32_t c) const
 
 unsigned int Font::getVirtualCodepoint(char32_t codepoint) const
 {
+    if(blockStart)
+    {
+        int block=findBlock(codepoint);
+        if(block>=0 && codepoint<blocks[2*block]+blocks[2*block+1])
+            return blockStart[block]+codepoint-blocks[2*block];
+        //Last block always only contains the missing codepoint glyph
+        return blockStart[numBlocks-1];
+    }
     unsigned int virtualCodepoint=0;
     const int lastBlock=2*(numBlocks-1);
     for(int block=0;block<lastBlock;block+=2)
@@ -61,13 +74,63 @@ unsigned int Font::getVirtualCodepoint(char32_t codepoint) const
 
 short int Font::calculateLength(const char *s) const
 {
-    if(isFixedWidth()) return miosix::Unicode::countCodePoints(s)*width;
+    if(isFixedWidth()) return miosix::Unicode::countCodePoints(s)*width*scale;
     else {
         short int result=0;
-        while(char32_t c=miosix::Unicode::nextUtf8(s))
-            result+=variableWidthGetWidth(getVirtualCodepoint(c));
-        return result;
+        if(source)
+        {
+            while(char32_t c=miosix::Unicode::nextUtf8(s))
+                result+=sourceGetWidth(getVirtualCodepoint(c));
+        } else {
+            while(char32_t c=miosix::Unicode::nextUtf8(s))
+                result+=variableWidthGetWidth(getVirtualCodepoint(c));
+        }
+        return result*scale;
+    }
+}
+
+Font Font::scaled(unsigned char factor, bool smooth) const
+{
+    Font result(*this);
+    result.scale=max<unsigned char>(1,min<unsigned char>(factor,8));
+    //getHeight() and getWidth() return an unsigned char
+    while(result.scale>1 && max(height,width)*result.scale>255) result.scale--;
+    result.smooth=smooth;
+    return result;
+}
+
+const unsigned char *Font::sourceGetGlyph(unsigned int virtualCodepoint,
+        unsigned short& glyphWidth) const
+{
+    const unsigned char *glyph=source->getGlyph(virtualCodepoint,height);
+    if(glyph==nullptr)
+    {
+        glyphWidth=width;
+        return nullptr;
+    }
+    glyphWidth=width ? width : glyph[0];
+    return glyph+1;
+}
+
+unsigned short Font::sourceGetWidth(unsigned int virtualCodepoint) const
+{
+    unsigned short result;
+    sourceGetGlyph(virtualCodepoint,result);
+    return result;
+}
+
+int Font::findBlock(char32_t codepoint) const
+{
+    //Find the first block starting after codepoint, the last block is not
+    //part of the search as it is out of order
+    int lo=0, hi=numBlocks-1;
+    while(lo<hi)
+    {
+        int mid=(lo+hi)/2;
+        if(blocks[2*mid]<=codepoint) lo=mid+1;
+        else hi=mid;
     }
+    return lo-1;
 }
 
 void Font::generatePalette(Color out[4], Color fgcolor, Color bgcolor)
@@ -97,4 +160,84 @@ void Font::generatePalette(Color out[4], Color fgcolor, Color bgcolor)
     #endif
 }
 
+//
+// Class Font::GlyphReader
+//
+
+Font::GlyphReader::GlyphReader(const Font *font, unsigned int virtualCodepoint)
+    : font(font), glyphData(nullptr), decoder(nullptr,font->height), width(0)
+{
+    if(font->source)
+    {
+        const unsigned char *glyph=font->sourceGetGlyph(virtualCodepoint,width);
+        decoder=CompressedGlyphDecoder(glyph,font->height);
+        glyphData=glyph;
+    } else if(font->compressedOffset) {
+        const unsigned char *fontData=
+            reinterpret_cast<const unsigned char*>(font->data);
+        glyphData=fontData+font->compressedOffset[virtualCodepoint];
+        decoder=CompressedGlyphDecoder(fontData+
+            font->compressedOffset[virtualCodepoint],font->height);
+        width=font->isFixedWidth() ? font->width :
+            font->variableWidthGetWidth(virtualCodepoint);
+    } else {
+        unsigned int column;
+        if(font->isFixedWidth())
+        {
+            column=virtualCodepoint*font->width;
+            width=font->width;
+        } else {
+            column=font->offset[virtualCodepoint];
+            width=font->variableWidthGetWidth(virtualCodepoint);
+        }
+        glyphData=reinterpret_cast<const char*>(font->data)+
+            column*(font->dataSize/8);
+    }
+}
+
+void Font::GlyphReader::nextColumn(unsigned char *levels)
+{
+    if(glyphData==nullptr)
+    {
+        memset(levels,0,font->height);
+        return;
+    }
+    if(font->isCompressed())
+    {
+        decoder.nextColumn([levels](short y, short length, unsigned char level)
+        {
+            memset(levels+y,level,length);
+        });
+        return;
+    }
+    unsigned long long column;
+    switch(font->dataSize)
+    {
+        case 8:
+            column=*reinterpret_cast<const unsigned char*>(glyphData);
+            break;
+        case 16:
+            column=*reinterpret_cast<const unsigned short*>(glyphData);
+            break;
+        case 32:
+            column=*reinterpret_cast<const unsigned int*>(glyphData);
+            break;
+        default:
+            column=*reinterpret_cast<const unsigned long long*>(glyphData);
+            break;
+    }
+    glyphData=reinterpret_cast<const char*>(glyphData)+font->dataSize/8;
+    for(int i=0;i<font->height;i++)
+    {
+        if(font->antialiased)
+        {
+            levels[i]=column & 0x3;
+            column>>=2;
+        } else {
+            levels[i]=(column & 0x1)*3;
+            column>>=1;
+        }
+    }
+}
+
 }  //namespace mxgui
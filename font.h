@@ -31,6 +31,7 @@
 #include "point.h"
 #include "iterator_direction.h"
 #include <algorithm>
+#include <cstring>
 #ifdef _MIOSIX
 #include <util/unicode.h>
 #else //_MIOSIX
@@ -39,6 +40,28 @@
 
 namespace mxgui {
 
+/**
+ * \internal
+ * Interface of the objects that provide the glyphs of a Font at runtime,
+ * such as FontFile and TrueTypeFont, instead of from tables compiled in
+ */
+class GlyphSource
+{
+public:
+    /**
+     * Get a glyph. The returned pointer is valid till the next call
+     * \param virtualCodepoint glyph virtual codepoint
+     * \param height font height, as a source may provide more than a size
+     * \return a pointer to the glyph width, followed by the glyph data in
+     * the Font compressed format, or nullptr if the glyph is not available
+     */
+    virtual const unsigned char *getGlyph(unsigned int virtualCodepoint,
+            unsigned char height)=0;
+
+protected:
+    ~GlyphSource() {}
+};
+
 /**
  * \ingroup pub_iface
  * A Font that can be used to draw text. Fonts are immutable except they can be
@@ -59,12 +82,20 @@ public:
      * \param dataSize can be 8,16 or 32, it is the size of one element of data
      * \param data pinter to the font data. This must point to a static array
      * so that no memory leak problems occur
+     * \param blockStart optional table with the index of the first glyph of
+     * each block. If given, blocks except the last one must be sorted by
+     * codepoint, and codepoints are looked up with a binary search. Required
+     * for speed by fonts with many blocks, like the ones generated by
+     * fontrendering --subset
      */
-    constexpr Font(const unsigned int *blocks, unsigned char numBlocks,
+    constexpr Font(const unsigned int *blocks, unsigned short numBlocks,
         unsigned char height, unsigned char width, bool antialiased,
-        unsigned char dataSize, const void *data): blocks(blocks),
-        numBlocks(numBlocks), height(height), width(width), offset(nullptr),
-        antialiased(antialiased), dataSize(dataSize), data(data) {}
+        unsigned char dataSize, const void *data,
+        const unsigned short *blockStart=nullptr): blocks(blocks),
+        blockStart(blockStart), numBlocks(numBlocks), height(height),
+        width(width), offset(nullptr), compressedOffset(nullptr),
+        antialiased(antialiased), dataSize(dataSize), data(data),
+        source(nullptr), scale(1), smooth(false) {}
 
     /**
      * Creates a variable width font.
@@ -78,12 +109,51 @@ public:
      * This must point to a static array so that no memory leak problems occur
      * \param data pinter to the font data. This must point to a static array
      * so that no memory leak problems occur
+     * \param blockStart optional table with the index of the first glyph of
+     * each block. If given, blocks except the last one must be sorted by
+     * codepoint, and codepoints are looked up with a binary search. Required
+     * for speed by fonts with many blocks, like the ones generated by
+     * fontrendering --subset
      */
-    constexpr Font(const unsigned int *blocks, unsigned char numBlocks,
+    constexpr Font(const unsigned int *blocks, unsigned short numBlocks,
         unsigned char height, const unsigned short *offset, bool antialiased,
-        unsigned char dataSize, const void *data): blocks(blocks),
-        numBlocks(numBlocks), height(height), width(0), offset(offset),
-        antialiased(antialiased), dataSize(dataSize), data(data) {}
+        unsigned char dataSize, const void *data,
+        const unsigned short *blockStart=nullptr): blocks(blocks),
+        blockStart(blockStart), numBlocks(numBlocks), height(height),
+        width(0), offset(offset), compressedOffset(nullptr),
+        antialiased(antialiased), dataSize(dataSize), data(data),
+        source(nullptr), scale(1), smooth(false) {}
+
+    /**
+     * Creates a compressed font, whose glyphs are stored as vertical runs of
+     * pixels of the same level, as generated by fontrendering --compress.
+     * Compressed fonts are smaller but slightly slower to draw.
+     * \param blocks list of unicode blocks included in the font, (base, size) pairs
+     * \param numBlocks number of unicode blocks
+     * \param height the height of the glyphs
+     * \param width the width of the glyphs if fixed width, 0 otherwise
+     * \param offset if variable width, table that contains at which column
+     * each glyph begins, used to compute glyph widths. nullptr if fixed width
+     * \param antialiased true if font is antialiased
+     * \param compressedOffset table that contains where in data each glyph
+     * begins (data[compressedOffset[c]])
+     * \param data pointer to the compressed font data. This must point to a
+     * static array so that no memory leak problems occur
+     * \param blockStart optional table with the index of the first glyph of
+     * each block. If given, blocks except the last one must be sorted by
+     * codepoint, and codepoints are looked up with a binary search. Required
+     * for speed by fonts with many blocks, like the ones generated by
+     * fontrendering --subset
+     */
+    constexpr Font(const unsigned int *blocks, unsigned short numBlocks,
+        unsigned char height, unsigned char width,
+        const unsigned short *offset, bool antialiased,
+        const unsigned int *compressedOffset, const unsigned char *data,
+        const unsigned short *blockStart=nullptr): blocks(blocks),
+        blockStart(blockStart), numBlocks(numBlocks), height(height),
+        width(width), offset(offset), compressedOffset(compressedOffset),
+        antialiased(antialiased), dataSize(8), data(data),
+        source(nullptr), scale(1), smooth(false) {}
 
     /**
      * Draw a string on a surface.
@@ -97,7 +167,10 @@ public:
      * \param s string to write
      */
     template<typename T, bool pedantic=false>
-    void draw(T& surface, Color colors[4], Point p, const char *s) const;
+    void draw(T& surface, Color colors[4], Point p, const char *s) const
+    {
+        drawGlyphs<T,pedantic>(surface,colors,p,StringGlyphs(this,s));
+    }
 
     /**
      * Draw part of a string on a surface
@@ -115,7 +188,34 @@ public:
      */
     template<typename T, bool pedantic=false>
     void clippedDraw(T& surface, Color colors[4],
-        Point p, Point a, Point b, const char *s) const;
+        Point p, Point a, Point b, const char *s) const
+    {
+        clippedDrawGlyphs<T,pedantic>(surface,colors,p,a,b,
+                StringGlyphs(this,s));
+    }
+
+    /**
+     * Walk part of a string and call a functor for each vertical run of
+     * non background pixels. Background pixels are skipped entirely, so this
+     * is the building block for drawing text with a transparent background.
+     * \param p point of the upper left corner where the string will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param s string to draw
+     * \param span functor called as span(Point start, short length,
+     * unsigned char level) for each vertical run of pixels with the same
+     * level. Level is 3 for the foreground color and 1 or 2 for the
+     * intermediate antialiasing colors, the same indices of the palette
+     * computed by generatePalette()
+     */
+    template<typename F>
+    void clippedDrawSpans(Point p, Point a, Point b, const char *s,
+        F&& span) const
+    {
+        clippedDrawSpansGlyphs(p,a,b,StringGlyphs(this,s),span);
+    }
 
     /**
      * Given a string, determine the length in pixels required to draw it.
@@ -132,7 +232,9 @@ public:
      */
     short int calculateLength(char32_t c) const
     {
-        return width ? width : variableWidthGetWidth(getVirtualCodepoint(c));
+        if(width) return width*scale;
+        if(source) return sourceGetWidth(getVirtualCodepoint(c))*scale;
+        return variableWidthGetWidth(getVirtualCodepoint(c))*scale;
     }
 
     /**
@@ -145,6 +247,14 @@ public:
      */
     bool isAntialiased() const { return antialiased; }
 
+    /**
+     * \return true if the Font is compressed
+     */
+    bool isCompressed() const
+    {
+        return compressedOffset!=nullptr || source!=nullptr;
+    }
+
     /**
        \return true if the codepoint is included in the Font
     */
@@ -160,13 +270,31 @@ public:
     /**
      * \return the Font's height
      */
-    unsigned char getHeight() const { return height; }
+    unsigned char getHeight() const { return height*scale; }
 
     /**
      * \return the Font's width. Use this member function only if the Font is
      * fixed width, otherwise use calculateLength()
      */
-    unsigned char getWidth() const { return width; }
+    unsigned char getWidth() const { return width*scale; }
+
+    /**
+     * Return a copy of this Font that draws glyphs scaled by an integer
+     * factor, for example to draw large numbers without the need of a large
+     * font. Scaled glyphs are drawn pixel by pixel through a generic path,
+     * so they are slower to draw than unscaled ones.
+     * \param factor the scale factor, from 1 to 8. It is reduced if needed,
+     * as the scaled height and width can't exceed 255 pixels
+     * \param smooth if true and factor is 2, the edges of the glyphs are
+     * smoothed using the intermediate antialiasing colors
+     * \return the scaled Font
+     */
+    Font scaled(unsigned char factor, bool smooth=false) const;
+
+    /**
+     * \return the scale factor of the Font, 1 if not scaled
+     */
+    unsigned char getScale() const { return scale; }
 
     /**
      * \return the size in bits of the data's data type.
@@ -184,6 +312,23 @@ public:
      */
     const unsigned short *getOffset() const { return offset; }
 
+    /**
+     * \return a table with the offset within data where a compressed glyph
+     * starts, or nullptr if the Font is not compressed or its glyphs are
+     * loaded at runtime, as with FontFile. In a compressed font
+     * data is an unsigned char array, and each glyph column is a sequence of
+     * bytes, each encoding a vertical run of pixels of the same level
+     * - bits 0 to 4 are the run length minus one
+     * - bits 5 and 6 are the pixel level, 0 for background and 3 for foreground
+     * - bit 7, if set, marks the last run of the column, the remaining pixels
+     *   down to the font height are background
+     *
+     * A column also ends when its runs add up to the font height. The byte
+     * 0x80 | (n-1), that would be a background run marked as last, is instead
+     * used at the start of a column to repeat the previous column n times.
+     */
+    const unsigned int *getCompressedOffset() const { return compressedOffset; }
+
     /**
      * \return a pointer to the font data, that can be used to draw a font.
      * The real datatype depends on getDataType()
@@ -203,6 +348,58 @@ public:
     //without problems since there is no member function to modify them
     //nor to return a non-const pointer to them
 private:
+    /**
+     * Constructor used by FontFile and TrueTypeFont
+     * \param blocks list of unicode blocks included in the font, (base, size) pairs
+     * \param numBlocks number of unicode blocks
+     * \param blockStart table with the index of the first glyph of each
+     * block, or nullptr
+     * \param height the height of the glyphs
+     * \param width the width of the glyphs if fixed width, 0 otherwise
+     * \param antialiased true if font is antialiased
+     * \param source object from which glyphs are loaded
+     */
+    constexpr Font(const unsigned int *blocks, unsigned short numBlocks,
+        const unsigned short *blockStart, unsigned char height,
+        unsigned char width, bool antialiased, GlyphSource *source):
+        blocks(blocks), blockStart(blockStart), numBlocks(numBlocks),
+        height(height), width(width), offset(nullptr),
+        compressedOffset(nullptr), antialiased(antialiased), dataSize(8),
+        data(nullptr), source(source), scale(1),
+        smooth(false) {}
+
+    friend class FontFile;
+    friend class TrueTypeFont;
+    friend class TextRun;
+
+    /**
+     * Get a glyph of a Font loaded from a GlyphSource. The returned pointer
+     * is valid till the next call
+     * \param virtualCodepoint glyph virtual codepoint
+     * \param glyphWidth the glyph width is returned here
+     * \return the glyph data in the compressed format, or nullptr if it
+     * could not be read
+     */
+    const unsigned char *sourceGetGlyph(unsigned int virtualCodepoint,
+            unsigned short& glyphWidth) const;
+
+    /**
+     * Compute the glyph width of a variable width Font loaded from a
+     * GlyphSource
+     * \param virtualCodepoint glyph virtual codepoint
+     * \return glyph width
+     */
+    unsigned short sourceGetWidth(unsigned int virtualCodepoint) const;
+
+    /**
+     * Binary search the block that may contain a codepoint. Can only be used
+     * if blockStart is not nullptr
+     * \param codepoint the character codepoint
+     * \return the index of the last block starting at or before the codepoint,
+     * excluding the last block, or -1 if there is none
+     */
+    int findBlock(char32_t codepoint) const;
+
     /**
      * Compute the glyph width. Can only be used if the font is variable width
      * \param virtualCodePoint glyph virtual code point
@@ -230,6 +427,19 @@ private:
             it++;
         }
 
+        /**
+         * Extract the level of a pixel of a non-antialiased glyph
+         * \param col column of glyph pixels
+         * \return 0 for background, 3 for foreground
+         */
+        template<typename U>
+        static inline unsigned char nextLevel(U& col)
+        {
+            unsigned char result=(col & 0x1)*3;
+            col>>=1;
+            return result;
+        }
+
         /**
          * Compute the amount of vertical pixels to skip
          * when drawing the glyph. To be used ONLY in the case of
@@ -258,6 +468,20 @@ private:
             it++;
         }
 
+        /**
+         * Extract the level of a pixel of an antialiased glyph
+         * \param col column of glyph pixels
+         * \return 0 for background, 3 for foreground, 1 and 2 for the
+         * intermediate antialiasing levels
+         */
+        template<typename U>
+        static inline unsigned char nextLevel(U& col)
+        {
+            unsigned char result=col & 0x3;
+            col>>=2;
+            return result;
+        }
+
         /**
          * Compute the amount of vertical pixels to skip
          * when drawing the glyph. To be used ONLY in the case of
@@ -310,7 +534,203 @@ private:
             return ref->variableWidthGetWidth(virtualCodepoint);
         }
     };
-  
+
+    /**
+     * Decoder for the columns of a compressed glyph
+     */
+    class CompressedGlyphDecoder
+    {
+    public:
+        /**
+         * Constructor
+         * \param glyphData pointer to the first byte of the glyph
+         * \param height font height
+         */
+        CompressedGlyphDecoder(const unsigned char *glyphData,
+                unsigned char height)
+            : column(glyphData), next(glyphData), repeat(0), height(height) {}
+
+        /**
+         * Decode the next column of the glyph
+         * \param run functor called as run(short y, short length,
+         * unsigned char level) for each vertical run of pixels, background
+         * ones included, from top to bottom
+         */
+        template<typename F>
+        void nextColumn(F&& run)
+        {
+            bool repeated=true;
+            if(repeat>0) repeat--;
+            else if((*next & 0xe0)==0x80) repeat=*next++ & 0x1f;
+            else {
+                column=next;
+                repeated=false;
+            }
+            const unsigned char *p=column;
+            short y=0;
+            for(;;)
+            {
+                unsigned char b=*p++;
+                short length=(b & 0x1f)+1;
+                run(y,length,(b>>5) & 0x3);
+                y+=length;
+                if(b & 0x80)
+                {
+                    if(y<height) run(y,height-y,0);
+                    break;
+                }
+                if(y>=height) break;
+            }
+            if(repeated==false) next=p;
+        }
+
+    private:
+        const unsigned char *column; ///< Start of the current column
+        const unsigned char *next;   ///< Start of the next column
+        unsigned char repeat;        ///< Repetitions left of current column
+        unsigned char height;        ///< Font height
+    };
+
+    /**
+     * Reads the columns of a glyph as pixel levels, whatever the font format.
+     * Slower than the drawing engines, that are specialized for each format
+     */
+    class GlyphReader
+    {
+    public:
+        /**
+         * Constructor
+         * \param font font to read
+         * \param virtualCodepoint glyph virtual codepoint
+         */
+        GlyphReader(const Font *font, unsigned int virtualCodepoint);
+
+        /**
+         * \return the glyph width
+         */
+        unsigned short getWidth() const { return width; }
+
+        /**
+         * Read the next column of the glyph
+         * \param levels the levels of the column pixels are stored here,
+         * 0 for background and 3 for foreground, as many as the font height
+         */
+        void nextColumn(unsigned char *levels);
+
+    private:
+        const Font *font;
+        const void *glyphData; ///< Next column, or nullptr if not readable
+        CompressedGlyphDecoder decoder; ///< Used if the font is compressed
+        unsigned short width;
+    };
+
+    /**
+     * The glyphs of a nul terminated UTF-8 string, as walked by the drawing
+     * engines, that decode the string as they draw it
+     */
+    class StringGlyphs
+    {
+    public:
+        /**
+         * Constructor
+         * \param font font whose glyphs are walked
+         * \param s string
+         */
+        StringGlyphs(const Font *font, const char *s) : font(font), s(s) {}
+
+        /**
+         * \param vc the virtual codepoint of the next glyph is stored here
+         * \return false if there are no more glyphs
+         */
+        bool next(unsigned int& vc)
+        {
+            char32_t c=miosix::Unicode::nextUtf8(s);
+            if(c==0) return false;
+            vc=font->getVirtualCodepoint(c);
+            return true;
+        }
+
+        /**
+         * \return the length in pixels of the glyphs not yet walked
+         */
+        short int length() const { return font->calculateLength(s); }
+
+    private:
+        const Font *font;
+        const char *s;
+    };
+
+    /**
+     * Glyphs already resolved to virtual codepoints, as stored by TextRun
+     */
+    class ResolvedGlyphs
+    {
+    public:
+        /**
+         * Constructor
+         * \param first first virtual codepoint
+         * \param last one past the last virtual codepoint
+         * \param len length in pixels of the glyphs
+         */
+        ResolvedGlyphs(const unsigned int *first, const unsigned int *last,
+                short int len) : first(first), last(last), len(len) {}
+
+        /**
+         * \param vc the virtual codepoint of the next glyph is stored here
+         * \return false if there are no more glyphs
+         */
+        bool next(unsigned int& vc)
+        {
+            if(first==last) return false;
+            vc=*first++;
+            return true;
+        }
+
+        /**
+         * \return the length in pixels of all the glyphs
+         */
+        short int length() const { return len; }
+
+    private:
+        const unsigned int *first, *last;
+        short int len;
+    };
+
+    /**
+     * Implementation of draw(), for any sequence of glyphs
+     * \param surface an object that provides pixel iterators
+     * \param colors colors for drawing antialiased text
+     * \param p point of the upper left corner where the glyphs will be drawn
+     * \param glyphs glyphs to draw, StringGlyphs or ResolvedGlyphs
+     */
+    template<typename T, bool pedantic, typename G>
+    void drawGlyphs(T& surface, Color colors[4], Point p, G glyphs) const;
+
+    /**
+     * Implementation of clippedDraw(), for any sequence of glyphs
+     * \param surface an object that provides pixel iterators
+     * \param colors colors for drawing antialiased text
+     * \param p point of the upper left corner where the glyphs will be drawn
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param glyphs glyphs to draw, StringGlyphs or ResolvedGlyphs
+     */
+    template<typename T, bool pedantic, typename G>
+    void clippedDrawGlyphs(T& surface, Color colors[4],
+        Point p, Point a, Point b, G glyphs) const;
+
+    /**
+     * Implementation of clippedDrawSpans(), for any sequence of glyphs
+     * \param p point of the upper left corner where the glyphs will be drawn
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param glyphs glyphs to walk, StringGlyphs or ResolvedGlyphs
+     * \param span functor called for each run of non background pixels
+     */
+    template<typename G, typename F>
+    void clippedDrawSpansGlyphs(Point p, Point a, Point b, G glyphs,
+        F& span) const;
+
     /*
      * This is one nifty use of C++ templates. For size optimization purposes,
      * the elements in the font tables can either be 8, 16 or 32 bytes. This
@@ -336,11 +756,11 @@ private:
      * \param x start x coord
      * \param xEnd end x coord
      * \param colors background/foregound color pair
-     * \param s string to write
+     * \param glyphs glyphs to write
      */
-    template<typename T, typename U, typename L, typename D>
+    template<typename T, typename U, typename L, typename D, typename G>
     void drawingEngine(typename T::pixel_iterator first,
-            short x, short xEnd, Color colors[], const char *s) const;
+            short x, short xEnd, Color colors[], G& glyphs) const;
 
     /**
      * Base algorithm for rendering a clipped font.
@@ -349,33 +769,96 @@ private:
      * \param a upper left corner of non empty intersection
      * \param b lower right corner of non empty intersection
      * \param colors palette for antialiased drawing
-     * \param s string to write
+     * \param glyphs glyphs to write
      */
-    template<typename T, typename U, typename L, typename D, bool pedantic>
+    template<typename T, typename U, typename L, typename D, bool pedantic,
+             typename G>
     void drawingEngineClipped(T& surface, Point p, Point a, Point b,
-            Color colors[], const char *s) const;
+            Color colors[], G& glyphs) const;
+
+    /**
+     * Base algorithm for walking a clipped string as vertical pixel runs.
+     * \param p point of the upper left corner where the string will be drawn
+     * \param a upper left corner of non empty intersection
+     * \param b lower right corner of non empty intersection
+     * \param glyphs glyphs to walk
+     * \param span functor called for each run of non background pixels
+     */
+    template<typename U, typename L, typename D, typename G, typename F>
+    void spanEngine(Point p, Point a, Point b, G& glyphs, F& span) const;
+
+    /**
+     * Base algorithm for walking a clipped string of a scaled font.
+     * \param p point of the upper left corner where the string will be drawn
+     * \param a upper left corner of non empty intersection
+     * \param b lower right corner of non empty intersection
+     * \param glyphs glyphs to walk
+     * \param run functor called as run(Point start, short length,
+     * unsigned char level) for each vertical run of pixels within the
+     * intersection, background ones included, column by column from left to
+     * right and from top to bottom
+     */
+    template<typename G, typename F>
+    void scaledEngine(Point p, Point a, Point b, G& glyphs, F&& run) const;
+
+    /**
+     * Base algorithm for walking a clipped string of a compressed font.
+     * \param p point of the upper left corner where the string will be drawn
+     * \param a upper left corner of non empty intersection
+     * \param b lower right corner of non empty intersection
+     * \param glyphs glyphs to walk
+     * \param run functor called as run(Point start, short length,
+     * unsigned char level) for each vertical run of pixels within the
+     * intersection, background ones included, column by column from left to
+     * right and from top to bottom
+     */
+    template<typename G, typename F>
+    void compressedEngine(Point p, Point a, Point b, G& glyphs,
+            F&& run) const;
 
     const unsigned int *blocks; // Codepoint ranges of the font
-    unsigned char numBlocks;
+    const unsigned short *blockStart;// First glyph of each block, or nullptr
+    unsigned short numBlocks;
     unsigned char height;
     unsigned char width;// set to zero if variable width font
     const unsigned short *offset;// set to nullptr if fixed width
+    const unsigned int *compressedOffset;// set to nullptr if not compressed
     bool antialiased;
     unsigned char dataSize;
     const void *data;
+    GlyphSource *source;// set to nullptr if glyphs are not loaded at runtime
+    unsigned char scale;// scale factor, 1 if not scaled
+    bool smooth;// smooth edges of 2x scaled glyphs
 };
 
-template<typename T, bool pedantic>
-void Font::draw(T& surface, Color colors[4], Point p, const char *s) const
+template<typename T, bool pedantic, typename G>
+void Font::drawGlyphs(T& surface, Color colors[4], Point p, G glyphs) const
 {
     //If no Y space to draw font, stop
-    if(p.y()+height>surface.getHeight()) return;
+    if(p.y()+getHeight()>surface.getHeight()) return;
     //If no X space to draw font, draw it until the screen margin reached
     typename T::pixel_iterator it;
 
     short xEnd=surface.getWidth()-1;
-    if(pedantic) xEnd=std::min<short>(xEnd,p.x()+calculateLength(s)-1);
-    it=surface.begin(p,Point(xEnd,p.y()+height-1),DR);
+    if(pedantic) xEnd=std::min<short>(xEnd,p.x()+glyphs.length()-1);
+    it=surface.begin(p,Point(xEnd,p.y()+getHeight()-1),DR);
+    if(isCompressed() || scale>1)
+    {
+        auto write=[&](Point, short length, unsigned char level)
+        {
+            Color c=colors[level];
+            for(short i=0;i<length;i++)
+            {
+                *it=c;
+                it++;
+            }
+        };
+        Point b(xEnd,p.y()+getHeight()-1);
+        if(scale>1) scaledEngine(p,p,b,glyphs,write);
+        else compressedEngine(p,p,b,glyphs,write);
+        if(!pedantic) it.invalidate(); //May not fill the requested window
+        return;
+    }
     // For code size minimization not all the combinations of 8,16,32,64 bit
     // fixed, variable width and antialiased fonts are supported, but only these
     //  8 bit : none (too small for large displays)
@@ -390,10 +873,10 @@ void Font::draw(T& surface, Color colors[4], Point p, const char *s) const
             if(isFixedWidth())
                 drawingEngine<T,unsigned short,
                         FixedWidthGlyphLookup,GlyphDrawer>(it,
-                        p.x(),surface.getWidth(),fgBgColors,s);
+                        p.x(),surface.getWidth(),fgBgColors,glyphs);
             else drawingEngine<T,unsigned short,
                         VariableWidthGlyphLookup,GlyphDrawer>(it,
-                        p.x(),surface.getWidth(),fgBgColors,s);
+                        p.x(),surface.getWidth(),fgBgColors,glyphs);
             break;
         case 32:
             if(isAntialiased())
@@ -401,30 +884,30 @@ void Font::draw(T& surface, Color colors[4], Point p, const char *s) const
                 if(isFixedWidth()) return;
                 drawingEngine<T,unsigned int,
                         VariableWidthGlyphLookup,GlyphDrawerAA>(it,
-                        p.x(),surface.getWidth(),colors,s);
+                        p.x(),surface.getWidth(),colors,glyphs);
             } else {
                 if(isFixedWidth())
                     drawingEngine<T,unsigned int,
                         FixedWidthGlyphLookup,GlyphDrawer>(it,p.x(),
-                        surface.getWidth(),fgBgColors,s);
+                        surface.getWidth(),fgBgColors,glyphs);
                 else drawingEngine<T,unsigned int,
                         VariableWidthGlyphLookup,GlyphDrawer>(it,
-                        p.x(),surface.getWidth(),fgBgColors,s);
+                        p.x(),surface.getWidth(),fgBgColors,glyphs);
             }
             break;
         case 64:
             if(isAntialiased()==false || isFixedWidth()) return;
             drawingEngine<T,unsigned long long,
                         VariableWidthGlyphLookup,GlyphDrawerAA>(it,
-                        p.x(),surface.getWidth(),colors,s);
+                        p.x(),surface.getWidth(),colors,glyphs);
             break;
     }
     if(!pedantic) it.invalidate(); //May not fill the requested window
 }
 
-template<typename T, bool pedantic>
-void Font::clippedDraw(T& surface, Color colors[4],
-        Point p, Point a, Point b, const char *s) const
+template<typename T, bool pedantic, typename G>
+void Font::clippedDrawGlyphs(T& surface, Color colors[4],
+        Point p, Point a, Point b, G glyphs) const
 {
     using namespace std;
     //Find rectangle which is the non-empty intersection of the image rectangle
@@ -435,9 +918,28 @@ void Font::clippedDraw(T& surface, Color colors[4],
 
     short xa=max(p.x(),a.x());
     short xb=b.x();
-    if(pedantic) xb=std::min<short>(xb,p.x()+calculateLength(s)-1);
+    if(pedantic) xb=std::min<short>(xb,p.x()+glyphs.length()-1);
     if(xa>xb) return; //Empty intersection
 
+    if(isCompressed() || scale>1)
+    {
+        typename T::pixel_iterator it=surface.begin(Point(xa,ya),
+                Point(xb,yb),DR);
+        auto write=[&](Point, short length, unsigned char level)
+        {
+            Color c=colors[level];
+            for(short i=0;i<length;i++)
+            {
+                *it=c;
+                it++;
+            }
+        };
+        if(scale>1) scaledEngine(p,Point(xa,ya),Point(xb,yb),glyphs,write);
+        else compressedEngine(p,Point(xa,ya),Point(xb,yb),glyphs,write);
+        if(!pedantic) it.invalidate(); //May not fill the requested window
+        return;
+    }
+
     // For code size minimization not all the combinations of 8,16,32,64 bit
     // fixed, variable width and antialiased fonts are supported, but only these
     //  8 bit : none (too small for large displays)
@@ -452,10 +954,10 @@ void Font::clippedDraw(T& surface, Color colors[4],
             if(isFixedWidth())
                 drawingEngineClipped<T,unsigned short,
                        FixedWidthGlyphLookup,GlyphDrawer,pedantic>(surface,p,
-                       Point(xa,ya),Point(xb,yb),fgBgColors,s);
+                       Point(xa,ya),Point(xb,yb),fgBgColors,glyphs);
             else drawingEngineClipped<T,unsigned short,
                        VariableWidthGlyphLookup,GlyphDrawer,pedantic>(surface,p,
-                       Point(xa,ya),Point(xb,yb),fgBgColors,s);
+                       Point(xa,ya),Point(xb,yb),fgBgColors,glyphs);
             break;
         case 32:
             if(isAntialiased())
@@ -463,33 +965,92 @@ void Font::clippedDraw(T& surface, Color colors[4],
                 if(isFixedWidth()) return;
                 drawingEngineClipped<T,unsigned int,
                        VariableWidthGlyphLookup,GlyphDrawerAA,pedantic>(surface,p,
-                       Point(xa,ya),Point(xb,yb),colors,s);
+                       Point(xa,ya),Point(xb,yb),colors,glyphs);
             } else {
                 if(isFixedWidth())
                     drawingEngineClipped<T,unsigned int,
                        FixedWidthGlyphLookup,GlyphDrawer,pedantic>(surface,p,
-                       Point(xa,ya),Point(xb,yb),fgBgColors,s);
+                       Point(xa,ya),Point(xb,yb),fgBgColors,glyphs);
                 else drawingEngineClipped<T,unsigned int,
                        VariableWidthGlyphLookup,GlyphDrawer,pedantic>(surface,p,
-                       Point(xa,ya),Point(xb,yb),fgBgColors,s);
+                       Point(xa,ya),Point(xb,yb),fgBgColors,glyphs);
             }
             break;
         case 64:
             if(isAntialiased()==false || isFixedWidth()) return;
             drawingEngineClipped<T,unsigned long long,
                        VariableWidthGlyphLookup,GlyphDrawerAA,pedantic>(surface,p,
-                       Point(xa,ya),Point(xb,yb),colors,s);
+                       Point(xa,ya),Point(xb,yb),colors,glyphs);
+            break;
+    }
+}
+
+template<typename G, typename F>
+void Font::clippedDrawSpansGlyphs(Point p, Point a, Point b, G glyphs,
+        F& span) const
+{
+    using namespace std;
+    //Find rectangle which is the non-empty intersection of the text rectangle
+    //with the clip rectangle
+    short ya=max(p.y(),a.y());
+    short yb=min<short>(p.y()+this->getHeight()-1,b.y());
+    if(ya>yb) return; //Empty intersection
+
+    short xa=max(p.x(),a.x());
+    short xb=b.x();
+    if(xa>xb) return; //Empty intersection
+
+    if(isCompressed() || scale>1)
+    {
+        auto visible=[&](Point start, short length, unsigned char level)
+        {
+            if(level) span(start,length,level);
+        };
+        if(scale>1) scaledEngine(p,Point(xa,ya),Point(xb,yb),glyphs,visible);
+        else compressedEngine(p,Point(xa,ya),Point(xb,yb),glyphs,visible);
+        return;
+    }
+
+    //Same combinations supported by draw() and clippedDraw()
+    switch(dataSize)
+    {
+        case 16:
+            if(isAntialiased()) return;
+            if(isFixedWidth())
+                spanEngine<unsigned short,FixedWidthGlyphLookup,GlyphDrawer>(
+                        p,Point(xa,ya),Point(xb,yb),glyphs,span);
+            else spanEngine<unsigned short,VariableWidthGlyphLookup,GlyphDrawer>(
+                        p,Point(xa,ya),Point(xb,yb),glyphs,span);
+            break;
+        case 32:
+            if(isAntialiased())
+            {
+                if(isFixedWidth()) return;
+                spanEngine<unsigned int,VariableWidthGlyphLookup,GlyphDrawerAA>(
+                        p,Point(xa,ya),Point(xb,yb),glyphs,span);
+            } else {
+                if(isFixedWidth())
+                    spanEngine<unsigned int,FixedWidthGlyphLookup,GlyphDrawer>(
+                        p,Point(xa,ya),Point(xb,yb),glyphs,span);
+                else spanEngine<unsigned int,VariableWidthGlyphLookup,GlyphDrawer>(
+                        p,Point(xa,ya),Point(xb,yb),glyphs,span);
+            }
+            break;
+        case 64:
+            if(isAntialiased()==false || isFixedWidth()) return;
+            spanEngine<unsigned long long,VariableWidthGlyphLookup,GlyphDrawerAA>(
+                        p,Point(xa,ya),Point(xb,yb),glyphs,span);
             break;
     }
 }
 
-template<typename T, typename U, typename L, typename D>
+template<typename T, typename U, typename L, typename D, typename G>
 void Font::drawingEngine(typename T::pixel_iterator first,
-            short x, short xEnd, Color colors[], const char *s) const
+            short x, short xEnd, Color colors[], G& glyphs) const
 {
-    while(char32_t c=miosix::Unicode::nextUtf8(s))
+    unsigned int vc;
+    while(glyphs.next(vc))
     {
-        unsigned int vc=getVirtualCodepoint(c);
         unsigned short width=L::getWidth(this,vc);
         const U *glyphData=L::template lookupGlyph<U>(this,vc);
         for(unsigned short i=0;i<width;i++)
@@ -502,9 +1063,10 @@ void Font::drawingEngine(typename T::pixel_iterator first,
     }
 }
 
-template<typename T, typename U, typename L, typename D, bool pedantic>
+template<typename T, typename U, typename L, typename D, bool pedantic,
+         typename G>
 void Font::drawingEngineClipped(T& surface, Point p, Point a, Point b,
-            Color colors[], const char *s) const
+            Color colors[], G& glyphs) const
 {
     //Walk the string till the first at least partially visible char
     unsigned int vc;
@@ -513,9 +1075,7 @@ void Font::drawingEngineClipped(T& surface, Point p, Point a, Point b,
     short x=p.x();
     while(x<a.x())
     {
-        char32_t c=miosix::Unicode::nextUtf8(s);
-        if(c==0) return; //String ends before draw area begins
-        vc=getVirtualCodepoint(c);
+        if(!glyphs.next(vc)) return; //String ends before draw area begins
         width=L::getWidth(this,vc);
         if(x+width>a.x())
         {
@@ -549,9 +1109,8 @@ void Font::drawingEngineClipped(T& surface, Point p, Point a, Point b,
     }
 
     //Draw the rest of the string
-    while(char32_t c=miosix::Unicode::nextUtf8(s))
+    while(glyphs.next(vc))
     {
-        unsigned int vc=getVirtualCodepoint(c);
         unsigned short width=L::getWidth(this,vc);
         const U *glyphData=L::template lookupGlyph<U>(this,vc);
         for(unsigned short i=0;i<width;i++)
@@ -567,4 +1126,189 @@ void Font::drawingEngineClipped(T& surface, Point p, Point a, Point b,
     if(!pedantic) it.invalidate(); //May not fill the requested window
 }
 
+template<typename U, typename L, typename D, typename G, typename F>
+void Font::spanEngine(Point p, Point a, Point b, G& glyphs, F& span) const
+{
+    const short ySkipped=D::computeySkip(a,p);
+    const short yHeight=b.y()-a.y()+1;
+    short x=p.x();
+    unsigned int vc;
+    while(glyphs.next(vc))
+    {
+        unsigned short width=L::getWidth(this,vc);
+        //Skip whole chars left of the clipping rectangle without looking at
+        //their data
+        if(x+width<=a.x())
+        {
+            x+=width;
+            continue;
+        }
+        const U *glyphData=L::template lookupGlyph<U>(this,vc);
+        for(unsigned short i=0;i<width;i++,x++)
+        {
+            if(x<a.x()) continue;
+            if(x>b.x()) return;
+            U col=glyphData[i];
+            col>>=ySkipped;
+            short runStart=0;
+            unsigned char runLevel=0;
+            for(short j=0;j<yHeight;j++)
+            {
+                //All the remaining pixels of this column are background
+                if(col==0)
+                {
+                    if(runLevel) span(Point(x,a.y()+runStart),j-runStart,runLevel);
+                    runLevel=0;
+                    break;
+                }
+                unsigned char level=D::template nextLevel<U>(col);
+                if(level==runLevel) continue;
+                if(runLevel) span(Point(x,a.y()+runStart),j-runStart,runLevel);
+                runStart=j;
+                runLevel=level;
+            }
+            if(runLevel) span(Point(x,a.y()+runStart),yHeight-runStart,runLevel);
+        }
+    }
+}
+
+template<typename G, typename F>
+void Font::compressedEngine(Point p, Point a, Point b, G& glyphs,
+        F&& run) const
+{
+    using namespace std;
+    const unsigned char *fontData=reinterpret_cast<const unsigned char*>(data);
+    const short yStart=a.y()-p.y();
+    const short yEnd=b.y()-p.y()+1;
+    short x=p.x();
+    unsigned int vc;
+    while(glyphs.next(vc))
+    {
+        unsigned short width;
+        const unsigned char *glyphData;
+        if(source) glyphData=sourceGetGlyph(vc,width);
+        else {
+            width=isFixedWidth() ? this->width : variableWidthGetWidth(vc);
+            glyphData=fontData+compressedOffset[vc];
+        }
+        //Skip whole chars left of the clipping rectangle without decoding them
+        if(x+width<=a.x())
+        {
+            x+=width;
+            continue;
+        }
+        CompressedGlyphDecoder decoder(glyphData,height);
+        for(unsigned short i=0;i<width;i++,x++)
+        {
+            if(x>b.x()) return;
+            if(glyphData==nullptr)
+            {
+                //Glyph that could not be loaded, draw background
+                if(x>=a.x()) run(Point(x,a.y()),yEnd-yStart,0);
+                continue;
+            }
+            if(x<a.x())
+            {
+                decoder.nextColumn([](short, short, unsigned char){});
+                continue;
+            }
+            decoder.nextColumn([&](short y, short length, unsigned char level)
+            {
+                short y0=max(y,yStart);
+                short y1=min<short>(y+length,yEnd);
+                if(y0<y1) run(Point(x,p.y()+y0),y1-y0,level);
+            });
+        }
+    }
+}
+
+template<typename G, typename F>
+void Font::scaledEngine(Point p, Point a, Point b, G& glyphs,
+        F&& run) const
+{
+    using namespace std;
+    const short yStart=a.y()-p.y();
+    const short yEnd=b.y()-p.y()+1;
+    const bool smoothing=smooth && scale==2;
+    //Emit the runs of a column of n pixel levels, each unit pixels high
+    auto emit=[&](short x, const unsigned char *levels, short n, short unit)
+    {
+        for(short j=0;j<n;)
+        {
+            short k=j+1;
+            while(k<n && levels[k]==levels[j]) k++;
+            short y0=max<short>(j*unit,yStart);
+            short y1=min<short>(k*unit,yEnd);
+            if(y0<y1) run(Point(x,p.y()+y0),y1-y0,levels[j]);
+            j=k;
+        }
+    };
+    //Previous, current and next column, the ones outside the glyph are
+    //background. Only smoothing needs the previous and next one
+    unsigned char columns[3][32];
+    unsigned char smoothed[64];
+    short x=p.x();
+    unsigned int vc;
+    while(glyphs.next(vc))
+    {
+        GlyphReader reader(this,vc);
+        unsigned short width=reader.getWidth();
+        //Skip whole chars left of the clipping rectangle without decoding them
+        if(x+width*scale<=a.x())
+        {
+            x+=width*scale;
+            continue;
+        }
+        unsigned char *prev=columns[0], *cur=columns[1], *next=columns[2];
+        memset(prev,0,height);
+        if(width>0) reader.nextColumn(cur);
+        for(unsigned short i=0;i<width;i++,x+=scale)
+        {
+            if(x>b.x()) return;
+            if(smoothing)
+            {
+                if(i+1<width) reader.nextColumn(next);
+                else memset(next,0,height);
+            }
+            for(short r=0;r<scale;r++)
+            {
+                short xr=x+r;
+                if(xr<a.x() || xr>b.x()) continue;
+                if(smoothing==false)
+                {
+                    emit(xr,cur,height,scale);
+                    continue;
+                }
+                //Each pixel becomes 2x2, and each of the four is blended with
+                //its two outer neighbours if they are equal, like EPX. Only
+                //hard edges are blended, antialiased ones are already smooth
+                const unsigned char *side=r ? next : prev;
+                const unsigned char *otherSide=r ? prev : next;
+                for(short j=0;j<height;j++)
+                {
+                    unsigned char up=j>0 ? cur[j-1] : 0;
+                    unsigned char down=j+1<height ? cur[j+1] : 0;
+                    for(short k=0;k<2;k++)
+                    {
+                        unsigned char level=cur[j];
+                        unsigned char v=k ? down : up;
+                        unsigned char otherV=k ? up : down;
+                        if(side[j]==v && (v^level)==3 && side[j]!=otherV
+                            && v!=otherSide[j]) level=(level+v+1)/2;
+                        smoothed[2*j+k]=level;
+                    }
+                }
+                emit(xr,smoothed,2*height,1);
+            }
+            if(smoothing)
+            {
+                unsigned char *temp=prev;
+                prev=cur;
+                cur=next;
+                next=temp;
+            } else if(i+1<width) reader.nextColumn(cur);
+        }
+    }
+}
+
 } //namespace mxgui
@@ -0,0 +1,222 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "font_file.h"
+#include "misc_inst.h"
+#include <cstring>
+
+using namespace std;
+
+/*
+ * Binary font file format, all fields are little endian
+ * offset  size  field
+ * 0       4     "MXGF"
+ * 4       1     version, currently 1
+ * 5       1     flags, bit 0 set if antialiased
+ * 6       1     height
+ * 7       1     width, 0 if variable width
+ * 8       2     number of unicode blocks, the last one is the replacement char
+ * 10      2     size in bytes of the largest glyph
+ * 12      4     number of glyphs
+ * 16            unicode blocks, (start, size) pairs of 4 bytes each, sorted
+ *               by codepoint except the last one
+ *               first glyph of each block, 2 bytes each
+ *               glyph index, where each glyph starts in the file, 4 bytes
+ *               each, with one more entry than the glyphs to compute the
+ *               size of the last one
+ *               glyphs, each one is a byte with its width followed by the
+ *               glyph columns in the Font compressed format
+ */
+
+namespace mxgui {
+
+static unsigned short read16(const unsigned char *p)
+{
+    return p[0] | p[1]<<8;
+}
+
+static unsigned int read32(const unsigned char *p)
+{
+    return p[0] | p[1]<<8 | p[2]<<16 | static_cast<unsigned int>(p[3])<<24;
+}
+
+//
+// class FontFile
+//
+
+FontFile::FontFile() : blocks(nullptr), blockStart(nullptr), image(nullptr),
+        f(nullptr), cache(nullptr), tags(nullptr), lastUsed(nullptr),
+        hits(0), misses(0) {}
+
+FontFile::FontFile(const char *filename, unsigned int cacheSize) : FontFile()
+{
+    open(filename,cacheSize);
+}
+
+FontFile::FontFile(const void *image) : FontFile()
+{
+    open(image);
+}
+
+bool FontFile::open(const char *filename, unsigned int cacheSize)
+{
+    close();
+    f=fopen(filename,"rb");
+    if(f==nullptr) return false;
+    unsigned char header[headerSize];
+    if(fread(header,1,headerSize,f)!=headerSize || !parseHeader(header))
+    {
+        close();
+        return false;
+    }
+    //The unicode blocks are the only part of the file kept in RAM
+    unsigned char *table=new unsigned char[10*numBlocks];
+    bool fail=fread(table,1,10*numBlocks,f)!=10*numBlocks;
+    if(!fail) loadBlocks(table);
+    delete[] table;
+    if(fail)
+    {
+        close();
+        return false;
+    }
+    numSets=max<unsigned int>(1,min<unsigned int>(cacheSize/slotSize/2,0xffff));
+    cache=new unsigned char[2*numSets*slotSize];
+    tags=new unsigned int[2*numSets];
+    lastUsed=new unsigned char[numSets];
+    memset(tags,0,2*numSets*sizeof(unsigned int));
+    memset(lastUsed,0,numSets);
+    return true;
+}
+
+bool FontFile::open(const void *image)
+{
+    close();
+    if(image==nullptr) return false;
+    this->image=reinterpret_cast<const unsigned char*>(image);
+    if(!parseHeader(this->image))
+    {
+        close();
+        return false;
+    }
+    loadBlocks(this->image+headerSize);
+    return true;
+}
+
+void FontFile::close()
+{
+    if(f) fclose(f);
+    delete[] blocks;
+    delete[] blockStart;
+    delete[] cache;
+    delete[] tags;
+    delete[] lastUsed;
+    blocks=nullptr;
+    blockStart=nullptr;
+    image=nullptr;
+    f=nullptr;
+    cache=nullptr;
+    tags=nullptr;
+    lastUsed=nullptr;
+    hits=misses=0;
+}
+
+Font FontFile::getFont()
+{
+    if(!isOpen()) return defaultFont;
+    return Font(blocks,numBlocks,blockStart,height,width,antialiased,this);
+}
+
+bool FontFile::parseHeader(const unsigned char *header)
+{
+    if(memcmp(header,"MXGF",4)!=0 || header[4]!=1) return false;
+    antialiased=header[5] & 1;
+    height=header[6];
+    width=header[7];
+    numBlocks=read16(header+8);
+    slotSize=read16(header+10);
+    numGlyphs=read32(header+12);
+    if(height==0 || height>32 || numBlocks==0 || numGlyphs==0 || slotSize==0)
+        return false;
+    indexOffset=headerSize+10*numBlocks;
+    blocks=new unsigned int[2*numBlocks];
+    blockStart=new unsigned short[numBlocks];
+    return true;
+}
+
+void FontFile::loadBlocks(const unsigned char *table)
+{
+    for(int i=0;i<numBlocks;i++)
+    {
+        blocks[2*i]=read32(table+8*i);
+        blocks[2*i+1]=read32(table+8*i+4);
+        blockStart[i]=read16(table+8*numBlocks+2*i);
+    }
+}
+
+const unsigned char *FontFile::getGlyph(unsigned int virtualCodepoint,
+        unsigned char)
+{
+    if(virtualCodepoint>=numGlyphs) virtualCodepoint=numGlyphs-1;
+    if(image)
+        return image+read32(image+indexOffset+4*virtualCodepoint);
+
+    //Two way set associative cache, replacing the least recently used way
+    unsigned int set=virtualCodepoint % numSets;
+    unsigned int *way=tags+2*set;
+    for(int i=0;i<2;i++)
+    {
+        if(way[i]!=virtualCodepoint+1) continue;
+        hits++;
+        lastUsed[set]=i;
+        return cache+(2*set+i)*slotSize;
+    }
+    misses++;
+    int victim=lastUsed[set]^1;
+    unsigned char *slot=cache+(2*set+victim)*slotSize;
+    lastUsed[set]=victim;
+    if(readGlyph(virtualCodepoint,slot))
+    {
+        way[victim]=virtualCodepoint+1;
+        return slot;
+    }
+    way[victim]=0;
+    return nullptr;
+}
+
+bool FontFile::readGlyph(unsigned int virtualCodepoint, unsigned char *slot)
+{
+    unsigned char index[8];
+    if(fseek(f,indexOffset+4*virtualCodepoint,SEEK_SET)!=0) return false;
+    if(fread(index,1,8,f)!=8) return false;
+    unsigned int start=read32(index);
+    unsigned int size=read32(index+4)-start;
+    if(size==0 || size>slotSize) return false;
+    if(fseek(f,start,SEEK_SET)!=0) return false;
+    return fread(slot,1,size,f)==size;
+}
+
+} //namespace mxgui
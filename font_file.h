@@ -0,0 +1,177 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "font.h"
+#include <cstdio>
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface
+ * A font loaded at runtime from a binary font file, as generated by
+ * fontrendering --binary. This allows to keep large fonts, such as CJK ones,
+ * on external storage instead of the internal FLASH.
+ * The font file can either be read from a file, in which case glyphs are
+ * loaded on demand in a cache of bounded size, or directly from memory, such
+ * as a file memory mapped with mmap or an external memory mapped FLASH.
+ * Only the list of unicode blocks of the font is kept in RAM.
+ *
+ * The FontFile must outlive all the Font objects returned by getFont().
+ * The glyph cache is not protected by a mutex, so the fonts of a FontFile
+ * read from a file should be used by only one Display at a time.
+ */
+class FontFile : private GlyphSource
+{
+public:
+    /**
+     * Default constructor
+     */
+    FontFile();
+
+    /**
+     * Construct from a file name
+     * \param filename font file name
+     * \param cacheSize size in bytes of the glyph cache. The cache has room
+     * for at least two glyphs, regardless of this parameter
+     */
+    FontFile(const char *filename, unsigned int cacheSize);
+
+    /**
+     * Construct from a font file already in memory
+     * \param image pointer to the font file, that must remain valid and
+     * unchanged as long as the font file is open
+     */
+    explicit FontFile(const void *image);
+
+    /**
+     * Open a font file
+     * \param filename font file name
+     * \param cacheSize size in bytes of the glyph cache. The cache has room
+     * for at least two glyphs, regardless of this parameter
+     * \return true on success
+     */
+    bool open(const char *filename, unsigned int cacheSize);
+
+    /**
+     * Open a font file already in memory
+     * \param image pointer to the font file, that must remain valid and
+     * unchanged as long as the font file is open
+     * \return true on success
+     */
+    bool open(const void *image);
+
+    /**
+     * Close the font file
+     */
+    void close();
+
+    /**
+     * \return true if the font file is open
+     */
+    bool isOpen() const { return blocks!=nullptr; }
+
+    /**
+     * \return a Font that draws with the glyphs of this font file, or the
+     * default font if the font file is not open
+     */
+    Font getFont();
+
+    /**
+     * \return number of glyphs found in the cache
+     */
+    unsigned int getCacheHits() const { return hits; }
+
+    /**
+     * \return number of glyphs that had to be read from the file
+     */
+    unsigned int getCacheMisses() const { return misses; }
+
+    /**
+     * Destructor
+     */
+    ~FontFile() { close(); }
+
+private:
+    FontFile(const FontFile&)=delete;
+    FontFile& operator=(const FontFile&)=delete;
+
+    /**
+     * Parse the font file header and load the unicode blocks
+     * \param header the first headerSize bytes of the file
+     * \return true on success
+     */
+    bool parseHeader(const unsigned char *header);
+
+    /**
+     * Load the unicode blocks and the first glyph of each block
+     * \param table the part of the file following the header
+     */
+    void loadBlocks(const unsigned char *table);
+
+    /**
+     * Get a glyph, reading it from the file if not in the cache.
+     * The returned pointer is valid till the next call
+     * \param virtualCodepoint glyph virtual codepoint
+     * \param height font height, unused as a font file has only one size
+     * \return a pointer to the glyph width, followed by the glyph data in
+     * the Font compressed format, or nullptr on read errors
+     */
+    const unsigned char *getGlyph(unsigned int virtualCodepoint,
+            unsigned char height) override;
+
+    /**
+     * Read a glyph from the file into a cache slot
+     * \param virtualCodepoint glyph virtual codepoint
+     * \param slot where to store the glyph
+     * \return true on success
+     */
+    bool readGlyph(unsigned int virtualCodepoint, unsigned char *slot);
+
+    static const int headerSize=16; ///< Size of the fixed part of the header
+
+    unsigned int *blocks;        ///< Unicode blocks, nullptr if not open
+    unsigned short *blockStart;  ///< First glyph of each block
+    unsigned short numBlocks;    ///< Number of unicode blocks
+    unsigned char height;        ///< Font height
+    unsigned char width;         ///< Font width, 0 if variable width
+    bool antialiased;            ///< True if the font is antialiased
+    unsigned int numGlyphs;      ///< Number of glyphs
+    unsigned int indexOffset;    ///< Where the glyph index starts in the file
+    const unsigned char *image;  ///< Font file, if in memory
+    FILE *f;                     ///< Font file, if read from a file
+    unsigned char *cache;        ///< Glyph cache, numSets*2 slots
+    unsigned int *tags;          ///< Virtual codepoint+1 of each slot, 0=empty
+    unsigned char *lastUsed;     ///< Last used way of each set
+    unsigned short slotSize;     ///< Size of a cache slot, the largest glyph
+    unsigned short numSets;      ///< Number of sets of two slots in the cache
+    unsigned int hits;           ///< Glyphs found in the cache
+    unsigned int misses;         ///< Glyphs read from the file
+};
+
+} //namespace mxgui
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "heat_map.h"
+
+using namespace std;
+
+namespace mxgui {
+
+/**
+ * \param rgb a color as 0xRRGGBB
+ * \return the nearest color in the configured color depth
+ */
+static Color fromRgb(unsigned int rgb)
+{
+    unsigned int r=(rgb>>16) & 0xff;
+    unsigned int g=(rgb>>8) & 0xff;
+    unsigned int b=rgb & 0xff;
+    #ifdef MXGUI_COLOR_DEPTH_16_BIT
+    return Color(((r & 0xf8)<<8) | ((g & 0xfc)<<3) | (b>>3));
+    #elif defined(MXGUI_COLOR_DEPTH_8_BIT)
+    return Color((r & 0xe0) | ((g & 0xe0)>>3) | (b>>6));
+    #elif defined(MXGUI_COLOR_DEPTH_1_BIT_LINEAR)
+    return Color(r*77+g*150+b*29>=128*256 ? 1 : 0);
+    #else
+    #error unsupported color depth
+    #endif
+}
+
+//
+// class Colormap
+//
+
+Colormap::Colormap(Predefined p)
+{
+    static const unsigned int grayscale[]={0x000000,0xffffff};
+    static const unsigned int iron[]=
+    {
+        0x000000,0x20008c,0x9100a7,0xda3b3b,0xf8920c,0xfdd62a,0xffffff
+    };
+    static const unsigned int jet[]=
+    {
+        0x00007f,0x0000ff,0x00ffff,0x7fff7f,0xffff00,0xff0000,0x7f0000
+    };
+    switch(p)
+    {
+        case IRON:
+            gradient(iron,sizeof(iron)/sizeof(iron[0]));
+            break;
+        case JET:
+            gradient(jet,sizeof(jet)/sizeof(jet[0]));
+            break;
+        default:
+            gradient(grayscale,sizeof(grayscale)/sizeof(grayscale[0]));
+            break;
+    }
+}
+
+Colormap::Colormap(const unsigned int *stops, unsigned int numStops)
+{
+    gradient(stops,numStops);
+}
+
+void Colormap::gradient(const unsigned int *stops, unsigned int numStops)
+{
+    if(numStops<2)
+    {
+        Color c=numStops==1 ? fromRgb(stops[0]) : Color(0);
+        for(int i=0;i<256;i++) lut[i]=c;
+        return;
+    }
+    for(unsigned int i=0;i<256;i++)
+    {
+        //Position in the gradient, in units of 1/255 of a segment
+        unsigned int pos=i*(numStops-1);
+        unsigned int seg=min(pos/255,numStops-2);
+        unsigned int frac=pos-seg*255;
+        unsigned int a=stops[seg];
+        unsigned int b=stops[seg+1];
+        unsigned int rgb=0;
+        for(int shift=0;shift<24;shift+=8)
+        {
+            int ca=(a>>shift) & 0xff;
+            int cb=(b>>shift) & 0xff;
+            rgb|=static_cast<unsigned int>(ca+(cb-ca)*static_cast<int>(frac)/255)<<shift;
+        }
+        lut[i]=fromRgb(rgb);
+    }
+}
+
+} //namespace mxgui
@@ -0,0 +1,233 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "mxgui_settings.h"
+#include "point.h"
+#include "color.h"
+#include <algorithm>
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface
+ * A colormap, that is a table of 256 colors used to draw scalar data such
+ * as temperatures or spectrograms as false color images
+ */
+class Colormap
+{
+public:
+    /**
+     * Predefined colormaps
+     */
+    enum Predefined
+    {
+        GRAYSCALE, ///< From black to white
+        IRON,      ///< Black, blue, magenta, orange, yellow, white
+        JET        ///< Blue, cyan, green, yellow, red
+    };
+
+    /**
+     * Constructor
+     * \param p predefined colormap
+     */
+    Colormap(Predefined p=GRAYSCALE);
+
+    /**
+     * Constructor, the colormap is a gradient between equally spaced colors
+     * \param stops colors as 0xRRGGBB values
+     * \param numStops number of colors, at least 2
+     */
+    Colormap(const unsigned int *stops, unsigned int numStops);
+
+    /**
+     * \param i index
+     * \return the color at that index
+     */
+    Color operator[](unsigned char i) const { return lut[i]; }
+
+    /**
+     * \param i index
+     * \return a reference to the color at that index, to modify it
+     */
+    Color& operator[](unsigned char i) { return lut[i]; }
+
+private:
+    /**
+     * Fill the table with a gradient
+     * \param stops colors as 0xRRGGBB values
+     * \param numStops number of colors, at least 2
+     */
+    void gradient(const unsigned int *stops, unsigned int numStops);
+
+    Color lut[256]; ///< Color table
+};
+
+namespace impl {
+
+/**
+ * \internal
+ * Converts a scalar value to a color, clamping values below lo to the first
+ * color of the colormap and values above hi to the last. Specialized for the
+ * supported data types.
+ */
+template<typename T>
+class HeatMapScaler;
+
+/**
+ * \internal
+ * Scaler for 8 bit data, maps all possible values in a table, so that
+ * converting a value is a single lookup
+ */
+template<>
+class HeatMapScaler<unsigned char>
+{
+public:
+    HeatMapScaler(float lo, float hi, const Colormap& cmap)
+    {
+        float k=hi>lo ? 255.f/(hi-lo) : 0.f;
+        for(int i=0;i<256;i++)
+        {
+            float x=(static_cast<float>(i)-lo)*k;
+            table[i]=cmap[x<=0.f ? 0 : x>=255.f ? 255 : static_cast<int>(x)];
+        }
+    }
+
+    Color operator()(unsigned char v) const { return table[v]; }
+
+private:
+    Color table[256];
+};
+
+/**
+ * \internal
+ * Scaler for 16 bit data, uses fixed point arithmetic
+ */
+template<>
+class HeatMapScaler<unsigned short>
+{
+public:
+    HeatMapScaler(float lo, float hi, const Colormap& cmap) : cmap(cmap),
+        offset(std::max(0,std::min(65535,static_cast<int>(lo)))),
+        range(std::max(1,std::min(65535,static_cast<int>(hi))-offset)),
+        k((255u<<16)/range) {}
+
+    Color operator()(unsigned short v) const
+    {
+        int d=static_cast<int>(v)-offset;
+        if(d<=0) return cmap[0];
+        if(d>=range) return cmap[255];
+        //d<range guarantees that d*k fits in 32 bits
+        return cmap[(static_cast<unsigned int>(d)*k)>>16];
+    }
+
+private:
+    const Colormap& cmap;
+    int offset, range;
+    unsigned int k;
+};
+
+/**
+ * \internal
+ * Scaler for floating point data. NaN values are drawn with the first color
+ */
+template<>
+class HeatMapScaler<float>
+{
+public:
+    HeatMapScaler(float lo, float hi, const Colormap& cmap) : cmap(cmap),
+        lo(lo), k(hi>lo ? 255.f/(hi-lo) : 0.f) {}
+
+    Color operator()(float v) const
+    {
+        float x=(v-lo)*k;
+        if(!(x>0.f)) return cmap[0]; //Also catches NaN
+        if(x>=255.f) return cmap[255];
+        return cmap[static_cast<int>(x)];
+    }
+
+private:
+    const Colormap& cmap;
+    float lo, k;
+};
+
+} //namespace impl
+
+/**
+ * \ingroup pub_iface
+ * Draw a matrix of scalar values as a false color image. Each row is
+ * converted to colors once, and written with scanLineBuffer() as many times
+ * as the scale factor. The image is clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param p upper left corner of the image
+ * \param data pointer to the first value of the first row, unsigned char,
+ * unsigned short or float
+ * \param width number of values in a row
+ * \param height number of rows
+ * \param stride distance in values between the start of two rows
+ * \param lo value drawn with the first color of the colormap
+ * \param hi value drawn with the last color of the colormap
+ * \param cmap colormap
+ * \param scale each value is drawn as a square of scale*scale pixels
+ */
+template<typename T, typename U>
+void drawHeatMap(U& surface, Point p, const T *data, short int width,
+        short int height, int stride, float lo, float hi, const Colormap& cmap,
+        short int scale=1)
+{
+    using namespace std;
+    if(width<=0 || height<=0 || scale<=0) return;
+    //Clip to the surface
+    int x0=max<int>(0,p.x());
+    int x1=min<int>(surface.getWidth()-1,p.x()+width*scale-1);
+    int y0=max<int>(0,p.y());
+    int y1=min<int>(surface.getHeight()-1,p.y()+height*scale-1);
+    if(x0>x1 || y0>y1) return;
+    int firstCell=(x0-p.x())/scale;
+    int lastCell=(x1-p.x())/scale;
+    impl::HeatMapScaler<T> scaler(lo,hi,cmap);
+    for(int row=(y0-p.y())/scale;row<=(y1-p.y())/scale;row++)
+    {
+        const T *src=data+row*stride;
+        Color *line=surface.getScanLineBuffer();
+        Color *dst=line;
+        for(int cell=firstCell;cell<=lastCell;cell++)
+        {
+            Color c=scaler(src[cell]);
+            //The first and last cells may be partially clipped
+            int cx0=max(x0,p.x()+cell*scale);
+            int cx1=min(x1,p.x()+cell*scale+scale-1);
+            for(int x=cx0;x<=cx1;x++) *dst++=c;
+        }
+        int ya=max(y0,p.y()+row*scale);
+        int yb=min(y1,p.y()+row*scale+scale-1);
+        for(int y=ya;y<=yb;y++) surface.scanLineBuffer(Point(x0,y),x1-x0+1);
+    }
+}
+
+} //namespace mxgui
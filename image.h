@@ -102,6 +102,22 @@ public:
      */
     virtual const T* getData() const { return 0; }
 
+    /**
+     * Like getData(), but also works for images whose lines are not
+     * contiguous in memory, such as an ImageView into a larger image.
+     * Display drivers that can copy a line of pixels at a time should use
+     * this instead of getData().
+     * \param stride the distance, in elements of type T, between the start of
+     * two consecutive lines is returned here
+     * \return a const pointer to the first pixel of the image, or NULL if the
+     * image data is not available
+     */
+    virtual const T* getStridedData(short int& stride) const
+    {
+        stride=width;
+        return getData();
+    }
+
     /**
      * Get pixels from tha image. This member function can be used to get
      * up to a full horizontal line of pixels from an image.
@@ -153,9 +169,10 @@ bool basic_image_base<T>::getScanLine(mxgui::Point p, mxgui::Color colors[],
 {
     if(p.x()<0 || p.y()<0) return false;
     if(p.x()>=this->getWidth() || p.y()>=this->getHeight()) return false;
-    const T* data=this->getData();
+    short int stride;
+    const T* data=this->getStridedData(stride);
     if(data==0) return false;
-    data+=p.x()+p.y()*this->getWidth();
+    data+=p.x()+p.y()*stride;
     for(unsigned short i=0;i<length;i++) colors[i]=data[i];
     return true;
 }
@@ -164,14 +181,21 @@ template<typename T> template<typename U>
 void basic_image_base<T>::draw(U& surface, Point p) const
 {
     using namespace std;
-    const T *imgData=this->getData();
+    short int stride;
+    const T *imgData=this->getStridedData(stride);
     if(imgData!=0)
     {
         short int xEnd=p.x()+this->getWidth()-1;
         short int yEnd=p.y()+this->getHeight()-1;
         typename U::pixel_iterator it=surface.begin(p,Point(xEnd,yEnd),RD);
-        int imgSize=this->getHeight()*this->getWidth();
-        for(int i=0;i<imgSize;i++) *it=Color(imgData[i]);
+        if(stride==this->getWidth())
+        {
+            int imgSize=this->getHeight()*this->getWidth();
+            for(int i=0;i<imgSize;i++) *it=Color(imgData[i]);
+        } else {
+            for(short i=0;i<this->getHeight();i++,imgData+=stride)
+                for(short j=0;j<this->getWidth();j++) *it=Color(imgData[j]);
+        }
     } else {
         short length=this->width;
         impl::AutoArray<Color> line(new Color[length]);
@@ -246,14 +270,15 @@ void basic_image_base<T>::clippedDraw(U& surface,
     //Draw image
     short nx=xb-xa+1;
     short ny=yb-ya+1;
-    const T *imgData=this->getData();
+    short int stride;
+    const T *imgData=this->getStridedData(stride);
     if(imgData!=0)
     {
         typename U::pixel_iterator it=surface.begin(Point(xa,ya),
                 Point(xb,yb),RD);
-        int skipStart=(ya-p.y())*this->getWidth()+(xa-p.x());
+        int skipStart=(ya-p.y())*stride+(xa-p.x());
         imgData+=skipStart;
-        int toSkip=(xa-p.x())+((p.x()+this->getWidth()-1)-xb);
+        int toSkip=stride-nx;
         for(short i=0;i<ny;i++)
         {
             for(short j=0;j<nx;j++) *it=Color(*imgData++);
@@ -405,4 +430,93 @@ private:
 /// Define the Image class
 typedef basic_image<Color> Image;
 
+/**
+ * \ingroup pub_iface
+ * A rectangular part of a larger image whose data is in memory, such as an
+ * atlas where many icons are packed together by the pngconverter tool.
+ * Views don't copy the image data, and can be drawn like any other image.
+ * Display drivers that copy lines of pixels using getStridedData() draw
+ * them with one memcpy per line.
+ *
+ * Views are not supported for 1 bit per pixel images, as their lines are
+ * byte aligned.
+ */
+template<typename T>
+class basic_image_view : public basic_image_base<T>
+{
+public:
+    /**
+     * Default constructor, makes an empty view
+     */
+    basic_image_view() : stride(0), data(0) {}
+
+    /**
+     * Construct a view from a pointer to its first pixel
+     * \param height the view's height
+     * \param width the view's width
+     * \param stride distance, in pixels, between the start of two consecutive
+     * lines of the image the view is part of
+     * \param data the pointer to the first pixel of the view. Ownership of the
+     * data is still of the caller, as with basic_image
+     */
+    basic_image_view(short int height, short int width, short int stride,
+            const void *data) : basic_image_base<T>(height, width),
+            stride(stride), data(reinterpret_cast<const T*>(data)) {}
+
+    /**
+     * Construct a view of a rectangle of an image. The image must make its
+     * data available through getStridedData(), otherwise the view is empty.
+     * The view is clipped to the image area.
+     * \param image the image the view is part of. The view only keeps a
+     * pointer to the image data, not to the image object
+     * \param p upper left corner of the view within the image
+     * \param height the view's height
+     * \param width the view's width
+     */
+    basic_image_view(const basic_image_base<T>& image, Point p,
+            short int height, short int width) : stride(0), data(0)
+    {
+        using namespace std;
+        const T *imgData=image.getStridedData(stride);
+        if(imgData==0 || p.x()<0 || p.y()<0) return;
+        this->height=max<short>(0,min<short>(height,image.getHeight()-p.y()));
+        this->width=max<short>(0,min<short>(width,image.getWidth()-p.x()));
+        data=imgData+p.x()+p.y()*stride;
+    }
+
+    /**
+     * \return a const pointer to the view's data, only if its lines are
+     * contiguous in memory, otherwise NULL
+     */
+    virtual const T* getData() const
+    {
+        return stride==this->width ? data : 0;
+    }
+
+    /**
+     * \param stride the distance between the start of two consecutive lines
+     * is returned here
+     * \return a const pointer to the first pixel of the view
+     */
+    virtual const T* getStridedData(short int& stride) const
+    {
+        stride=this->stride;
+        return data;
+    }
+
+    /**
+     * Virtual destructor. The pointer is not deallocated, as with basic_image
+     */
+    virtual ~basic_image_view() {}
+
+    //Uses default copy constructor and operator=
+private:
+    short int stride; ///< Distance between consecutive lines
+    const T *data;    ///< Pointer to the first pixel
+};
+
+/// \ingroup pub_iface
+/// Define the ImageView class
+typedef basic_image_view<Color> ImageView;
+
 } // namespace mxgui
@@ -0,0 +1,428 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "mxgui_settings.h"
+#include "point.h"
+#include "color.h"
+#include "image.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mxgui {
+
+/**
+ * This class just encapsulates the ImageFilter_ enum so that the enum names
+ * don't clobber the global namespace.
+ */
+class ImageFilter
+{
+public:
+    /**
+     * How pixels are computed when an image is scaled or rotated
+     */
+    enum ImageFilter_
+    {
+        Nearest, ///< The nearest pixel of the image, fastest
+        Bilinear ///< Blend of the four nearest pixels, smoother
+    };
+
+private:
+    ImageFilter(); //Just a wrapper class, disallow creating instances
+};
+
+/**
+ * This class just encapsulates the ImageTransform_ enum so that the enum
+ * names don't clobber the global namespace.
+ */
+class ImageTransform
+{
+public:
+    /**
+     * Transforms that map pixels to pixels, and are thus drawn exactly
+     */
+    enum ImageTransform_
+    {
+        None,      ///< Draw the image as is
+        Rotate90,  ///< Rotate clockwise by 90 degrees
+        Rotate180, ///< Rotate by 180 degrees
+        Rotate270, ///< Rotate clockwise by 270 degrees
+        MirrorX,   ///< Mirror left to right
+        MirrorY    ///< Mirror top to bottom
+    };
+
+private:
+    ImageTransform(); //Just a wrapper class, disallow creating instances
+};
+
+namespace impl {
+
+/**
+ * \internal
+ * Linear interpolation between two colors
+ * \param a first color
+ * \param b second color
+ * \param f weight of the second color, from 0 to 32
+ * \return the interpolated color
+ */
+inline Color lerpColor(Color a, Color b, int f)
+{
+    #ifdef MXGUI_COLOR_DEPTH_16_BIT
+    //Spread the channels in a 32 bit word, leaving room for the products.
+    //The constant rounds each channel to nearest
+    unsigned int ea=(a | a<<16) & 0x07e0f81f;
+    unsigned int eb=(b | b<<16) & 0x07e0f81f;
+    unsigned int e=((ea*(32-f)+eb*f+0x02008010)>>5) & 0x07e0f81f;
+    return Color(static_cast<unsigned short>(e | e>>16));
+    #elif defined(MXGUI_COLOR_DEPTH_8_BIT)
+    int r=(((a>>5) & 7)*(32-f)+((b>>5) & 7)*f+16)>>5;
+    int g=(((a>>2) & 7)*(32-f)+((b>>2) & 7)*f+16)>>5;
+    int bl=((a & 3)*(32-f)+(b & 3)*f+16)>>5;
+    return Color(r<<5 | g<<2 | bl);
+    #elif defined(MXGUI_COLOR_DEPTH_1_BIT_LINEAR)
+    return f<16 ? a : b;
+    #else
+    #error unsupported color depth
+    #endif
+}
+
+/**
+ * \internal
+ * Random access to the pixels of an image. Images in memory are read
+ * directly, the others one pixel at a time with getScanLine()
+ */
+class ImageSampler
+{
+public:
+    /**
+     * Constructor
+     * \param img image to sample
+     */
+    ImageSampler(const ImageBase& img) : img(img),
+            data(img.getStridedData(stride)),
+            width(img.getWidth()), height(img.getHeight()) {}
+
+    /**
+     * \param x x coordinate, within the image
+     * \param y y coordinate, within the image
+     * \return the pixel color
+     */
+    Color operator()(int x, int y) const
+    {
+        if(data) return data[x+y*stride];
+        Color result=Color();
+        img.getScanLine(Point(x,y),&result,1);
+        return result;
+    }
+
+    /**
+     * \param u x coordinate in 16.16 fixed point, with the pixel centers at
+     * integer coordinates
+     * \param v y coordinate in 16.16 fixed point
+     * \return the blend of the four pixels nearest to the point, with the
+     * image edges extended
+     */
+    Color bilinear(int u, int v) const
+    {
+        using namespace std;
+        int x0=u>>16, y0=v>>16;
+        int fx=(u>>11) & 31, fy=(v>>11) & 31;
+        int x1=min(x0+1,width-1), y1=min(y0+1,height-1);
+        x0=max(0,min(x0,width-1));
+        y0=max(0,min(y0,height-1));
+        x1=max(0,x1);
+        y1=max(0,y1);
+        Color top=lerpColor((*this)(x0,y0),(*this)(x1,y0),fx);
+        Color bottom=lerpColor((*this)(x0,y1),(*this)(x1,y1),fx);
+        return lerpColor(top,bottom,fy);
+    }
+
+    const ImageBase& img; ///< Sampled image
+    short int stride;     ///< Distance between lines, if data is not NULL
+    const Color *data;    ///< Image data, or NULL if not in memory
+    int width, height;    ///< Image size
+};
+
+} //namespace impl
+
+/**
+ * \ingroup pub_iface
+ * Draw an image rotated by a multiple of 90 degrees or mirrored. Pixels are
+ * copied without resampling, one line at a time through scanLineBuffer(),
+ * and the image is clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param p upper left corner of the transformed image
+ * \param img image to draw
+ * \param t transform
+ */
+template<typename U>
+void drawImageTransformed(U& surface, Point p, const ImageBase& img,
+        ImageTransform::ImageTransform_ t)
+{
+    using namespace std;
+    const int w=img.getWidth(), h=img.getHeight();
+    //Source pixel of the upper left corner of the transformed image, and
+    //how the source position changes when moving right and down
+    int u0=0, v0=0, dux=1, dvx=0, duy=0, dvy=1;
+    switch(t)
+    {
+        case ImageTransform::Rotate90:
+            v0=h-1; dux=0; dvx=-1; duy=1; dvy=0;
+            break;
+        case ImageTransform::Rotate180:
+            u0=w-1; v0=h-1; dux=-1; dvy=-1;
+            break;
+        case ImageTransform::Rotate270:
+            u0=w-1; dux=0; dvx=1; duy=-1; dvy=0;
+            break;
+        case ImageTransform::MirrorX:
+            u0=w-1; dux=-1;
+            break;
+        case ImageTransform::MirrorY:
+            v0=h-1; dvy=-1;
+            break;
+        default:
+            break;
+    }
+    const bool swap=t==ImageTransform::Rotate90 || t==ImageTransform::Rotate270;
+    //Clip to the surface
+    int x0=max<int>(0,p.x());
+    int x1=min<int>(surface.getWidth()-1,p.x()+(swap ? h : w)-1);
+    int y0=max<int>(0,p.y());
+    int y1=min<int>(surface.getHeight()-1,p.y()+(swap ? w : h)-1);
+    if(x0>x1 || y0>y1) return;
+    u0+=(x0-p.x())*dux+(y0-p.y())*duy;
+    v0+=(x0-p.x())*dvx+(y0-p.y())*dvy;
+    impl::ImageSampler src(img);
+    for(int y=y0;y<=y1;y++,u0+=duy,v0+=dvy)
+    {
+        Color *line=surface.getScanLineBuffer();
+        if(src.data)
+        {
+            const Color *pix=src.data+u0+v0*src.stride;
+            int step=dux+dvx*src.stride;
+            for(int x=x0;x<=x1;x++,pix+=step) *line++=*pix;
+        } else {
+            int u=u0, v=v0;
+            for(int x=x0;x<=x1;x++,u+=dux,v+=dvx) *line++=src(u,v);
+        }
+        surface.scanLineBuffer(Point(x0,y),x1-x0+1);
+    }
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw an image scaled to a given size. Source coordinates are stepped in
+ * fixed point and each line is written with scanLineBuffer(). Every line is
+ * sampled, even if equal to the previous one, since drivers may double buffer
+ * scanlines. The image is clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param p upper left corner of the scaled image
+ * \param img image to draw
+ * \param width width of the scaled image
+ * \param height height of the scaled image
+ * \param filter how pixels are computed
+ */
+template<typename U>
+void drawImageScaled(U& surface, Point p, const ImageBase& img,
+        short int width, short int height,
+        ImageFilter::ImageFilter_ filter=ImageFilter::Nearest)
+{
+    using namespace std;
+    if(width<=0 || height<=0 || img.getWidth()<=0 || img.getHeight()<=0)
+        return;
+    //Clip to the surface
+    int x0=max<int>(0,p.x());
+    int x1=min<int>(surface.getWidth()-1,p.x()+width-1);
+    int y0=max<int>(0,p.y());
+    int y1=min<int>(surface.getHeight()-1,p.y()+height-1);
+    if(x0>x1 || y0>y1) return;
+    //Source step per pixel in 16.16 fixed point, and the source position of
+    //the center of the first drawn pixel
+    int du=(img.getWidth()<<16)/width;
+    int dv=(img.getHeight()<<16)/height;
+    int u0=(x0-p.x())*du+du/2;
+    int v=(y0-p.y())*dv+dv/2;
+    impl::ImageSampler src(img);
+    if(filter==ImageFilter::Bilinear)
+    {
+        //Move pixel centers to integer coordinates
+        u0-=0x8000;
+        v-=0x8000;
+    }
+    for(int y=y0;y<=y1;y++,v+=dv)
+    {
+        Color *line=surface.getScanLineBuffer();
+        int u=u0;
+        if(filter==ImageFilter::Nearest)
+        {
+            int row=v>>16;
+            if(src.data)
+            {
+                const Color *pix=src.data+row*src.stride;
+                for(int x=x0;x<=x1;x++,u+=du) *line++=pix[u>>16];
+            } else {
+                for(int x=x0;x<=x1;x++,u+=du) *line++=src(u>>16,row);
+            }
+        } else {
+            for(int x=x0;x<=x1;x++,u+=du) *line++=src.bilinear(u,v);
+        }
+        surface.scanLineBuffer(Point(x0,y),x1-x0+1);
+    }
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw an image rotated by an arbitrary angle, for example the needle of a
+ * gauge. The image is rotated around a pivot point, that is placed at a
+ * given point of the surface. Angles are in degrees, and grow clockwise as
+ * the y axis of the screen points downwards.
+ *
+ * Source coordinates are stepped in fixed point along each line, and only
+ * the span of each line covered by the image is written, with
+ * scanLineBuffer(), so pixels around the rotated image are left as they are.
+ * Angles that are multiples of 90 degrees are drawn with
+ * drawImageTransformed(). The image is clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c point of the surface where the pivot is placed
+ * \param img image to draw
+ * \param pivot point of the image the image is rotated around. Coordinates
+ * refer to pixel corners, so Point(img.getWidth()/2,img.getHeight()/2) is
+ * the center of the image, and Point(0,0) its upper left corner
+ * \param angle rotation angle in degrees
+ * \param filter how pixels are computed
+ */
+template<typename U>
+void drawImageRotated(U& surface, Point c, const ImageBase& img, Point pivot,
+        float angle, ImageFilter::ImageFilter_ filter=ImageFilter::Nearest)
+{
+    using namespace std;
+    const int w=img.getWidth(), h=img.getHeight();
+    if(w<=0 || h<=0) return;
+    angle=fmod(angle,360.f);
+    if(angle<0.f) angle+=360.f;
+    //Multiples of 90 degrees map pixels to pixels, and even bilinear
+    //filtering samples pixel centers
+    const short px=pivot.x(), py=pivot.y();
+    if(angle==0.f)
+    {
+        drawImageTransformed(surface,Point(c.x()-px,c.y()-py),img,
+                             ImageTransform::None);
+        return;
+    } else if(angle==90.f) {
+        drawImageTransformed(surface,Point(c.x()+py-h,c.y()-px),img,
+                             ImageTransform::Rotate90);
+        return;
+    } else if(angle==180.f) {
+        drawImageTransformed(surface,Point(c.x()+px-w,c.y()+py-h),img,
+                             ImageTransform::Rotate180);
+        return;
+    } else if(angle==270.f) {
+        drawImageTransformed(surface,Point(c.x()-py,c.y()+px-w),img,
+                             ImageTransform::Rotate270);
+        return;
+    }
+
+    const float rad=angle*3.14159265f/180.0f;
+    const float s=sin(rad), co=cos(rad);
+    //Bounding box of the rotated image, clipped to the surface
+    float minX=1e9f, maxX=-1e9f, minY=1e9f, maxY=-1e9f;
+    for(int i=0;i<4;i++)
+    {
+        float dx=(i & 1 ? w : 0)-px, dy=(i & 2 ? h : 0)-py;
+        float x=c.x()+co*dx-s*dy, y=c.y()+s*dx+co*dy;
+        minX=min(minX,x); maxX=max(maxX,x);
+        minY=min(minY,y); maxY=max(maxY,y);
+    }
+    int xmin=max<int>(0,floor(minX));
+    int xmax=min<int>(surface.getWidth()-1,ceil(maxX));
+    int y0=max<int>(0,floor(minY));
+    int y1=min<int>(surface.getHeight()-1,ceil(maxY));
+    if(xmin>xmax || y0>y1) return;
+
+    //The source point of the center of pixel (x,y) is
+    //u=px+co*(x+0.5-c.x())+s*(y+0.5-c.y())
+    //v=py-s*(x+0.5-c.x())+co*(y+0.5-c.y())
+    //and it changes by (co,-s) moving right. Positions are in 16.16 fixed
+    //point, with pixel corners at integer coordinates
+    const int du=lround(co*65536.f), dv=lround(-s*65536.f);
+    const int uLimit=w<<16, vLimit=h<<16;
+    const int offset=filter==ImageFilter::Bilinear ? 0x8000 : 0;
+    impl::ImageSampler src(img);
+    for(int y=y0;y<=y1;y++)
+    {
+        float dy=y+0.5f-c.y();
+        float fu=px+co*(0.5f-c.x())+s*dy;
+        float fv=py-s*(0.5f-c.x())+co*dy;
+        int u0=lround(fu*65536.f), v0=lround(fv*65536.f);
+        //Find the span of the line where the source point is within the
+        //image. It is an interval, first estimate it in floating point, then
+        //adjust its ends with the same fixed point arithmetic used to draw
+        float lo=xmin, hi=xmax;
+        if(fabs(co)>1e-6f)
+        {
+            float a=-fu/co, b=(w-fu)/co;
+            lo=max(lo,min(a,b)); hi=min(hi,max(a,b));
+        } else if(fu<0.f || fu>=w) continue;
+        if(fabs(s)>1e-6f)
+        {
+            float a=fv/s, b=(fv-h)/s;
+            lo=max(lo,min(a,b)); hi=min(hi,max(a,b));
+        } else if(fv<0.f || fv>=h) continue;
+        int xa=max<int>(xmin,floor(lo)-1);
+        int xb=min<int>(xmax,ceil(hi)+1);
+        auto inside=[&](int x) {
+            unsigned int u=u0+x*du, v=v0+x*dv;
+            return u<static_cast<unsigned int>(uLimit)
+                && v<static_cast<unsigned int>(vLimit);
+        };
+        while(xa<=xb && !inside(xa)) xa++;
+        while(xb>=xa && !inside(xb)) xb--;
+        if(xa>xb) continue;
+
+        Color *line=surface.getScanLineBuffer();
+        int u=u0+xa*du, v=v0+xa*dv;
+        if(filter==ImageFilter::Nearest)
+        {
+            if(src.data)
+            {
+                for(int x=xa;x<=xb;x++,u+=du,v+=dv)
+                    *line++=src.data[(u>>16)+(v>>16)*src.stride];
+            } else {
+                for(int x=xa;x<=xb;x++,u+=du,v+=dv)
+                    *line++=src(u>>16,v>>16);
+            }
+        } else {
+            for(int x=xa;x<=xb;x++,u+=du,v+=dv)
+                *line++=src.bilinear(u-offset,v-offset);
+        }
+        surface.scanLineBuffer(Point(xa,y),xb-xa+1);
+    }
+}
+
+} //namespace mxgui
@@ -28,6 +28,9 @@
 #include "application.h"
 #include "pthread_lock.h"
 #include "misc_inst.h"
+#include "trace.h"
+#include <algorithm>
+#include <ctime>
 
 #ifdef MXGUI_LEVEL_2
 
@@ -39,13 +42,15 @@ namespace mxgui {
 // class Drawable
 //
 
-Drawable::Drawable(Window* w, DrawArea da) : w(w), da(da), needRedraw(false)
+Drawable::Drawable(Window* w, DrawArea da) : w(w), da(da), needRedraw(false),
+        damaged(false), focusable(false), z(0), redrawMark(0)
 {
     w->addDrawable(this);
 }
 
 Drawable::Drawable(Window *w, Point p, short width, short height)
-    : w(w), da(make_pair(p,Point(p.x()+width,p.y()+height))), needRedraw(false)
+    : w(w), da(make_pair(p,Point(p.x()+width,p.y()+height))), needRedraw(false),
+      damaged(false), focusable(false), z(0), redrawMark(0)
 {
     w->addDrawable(this);
 }
@@ -56,6 +61,14 @@ void Drawable::enqueueForRedraw()
     w->needsPartialRedraw(this);
 }
 
+void Drawable::setFocusable(bool focusable)
+{
+    this->focusable=focusable;
+    if(focusable==false && hasFocus()) w->setFocus(nullptr);
+}
+
+bool Drawable::hasFocus() const { return w->getFocus()==this; }
+
 void Drawable::onEvent(Event e) {}
 
 Drawable::~Drawable()
@@ -67,27 +80,92 @@ Drawable::~Drawable()
 // class Window
 //
 
-Window::Window() : prefs(white,black,defaultFont), redrawNeeded(false)
+/**
+ * \param a a rectangle
+ * \param b a rectangle
+ * \return true if the two rectangles intersect
+ */
+static bool intersects(const DrawArea& a, const DrawArea& b)
+{
+    return a.first.x()<=b.second.x() && b.first.x()<=a.second.x() &&
+           a.first.y()<=b.second.y() && b.first.y()<=a.second.y();
+}
+
+/**
+ * \param a a rectangle
+ * \param b a rectangle
+ * \return true if a completely contains b
+ */
+static bool contains(const DrawArea& a, const DrawArea& b)
+{
+    return a.first.x()<=b.first.x() && a.second.x()>=b.second.x() &&
+           a.first.y()<=b.first.y() && a.second.y()>=b.second.y();
+}
+
+Window::Window() : nextZ(0), redrawPass(0), focus(nullptr), nextTimerId(1),
+        framePeriod(level2FramePeriod*1000000LL),
+        prefs(white,black,defaultFont), redrawNeeded(false)
 {
     pthread_mutex_init(&mutex,NULL);
-    pthread_cond_init(&cond,NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr,CLOCK_MONOTONIC); //As getEventTime()
+    pthread_cond_init(&cond,&attr);
+    pthread_condattr_destroy(&attr);
+    Display& display=DisplayManager::instance().getDisplay();//FIXME: get it fron the window manager
+    gridWidth=(display.getWidth()+gridCellSize-1)/gridCellSize;
+    gridHeight=(display.getHeight()+gridCellSize-1)/gridCellSize;
+    grid.resize(gridWidth*gridHeight);
+    #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+    redrawRequests=0;
+    numLatencyPending=0;
+    #endif //MXGUI_ENABLE_LATENCY_TRACKING
 }
 
 void Window::addDrawable(Drawable* d)
 {
     PthreadLock lock(mutex);
     drawables.push_back(d);
+    d->z=nextZ++;
+    //Drawables are added in stacking order, so cells remain sorted
+    int x0,y0,x1,y1;
+    if(gridRange(d->da,x0,y0,x1,y1)==false) return;
+    for(int y=y0;y<=y1;y++)
+        for(int x=x0;x<=x1;x++) grid[y*gridWidth+x].push_back(d);
 }
 
 void Window::removeDrawable(Drawable* d)
 {
     PthreadLock lock(mutex);
     drawables.remove(d); //O(n) removal, space-speed tradeoff
+    dirty.erase(remove(dirty.begin(),dirty.end(),d),dirty.end());
+    captured.erase(remove(captured.begin(),captured.end(),d),captured.end());
+    targets.erase(remove(targets.begin(),targets.end(),d),targets.end());
+    if(focus==d) focus=nullptr;
+    int x0,y0,x1,y1;
+    if(gridRange(d->da,x0,y0,x1,y1)==false) return;
+    for(int y=y0;y<=y1;y++)
+    {
+        for(int x=x0;x<=x1;x++)
+        {
+            vector<Drawable*>& cell=grid[y*gridWidth+x];
+            cell.erase(find(cell.begin(),cell.end(),d));
+        }
+    }
+    //What was below the removed drawable needs to be redrawn
+    damage.push_back(Damage(d->da,0));
+    if(redrawNeeded) return;
+    postEventImpl(Event(EventType::WindowPartialRedraw));
+    redrawNeeded=true;
 }
 
 void Window::needsPartialRedraw(Drawable* d)
 {
     PthreadLock lock(mutex);
+    dirty.push_back(d);
+    #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+    redrawRequests++;
+    #endif //MXGUI_ENABLE_LATENCY_TRACKING
     if(redrawNeeded) return;
     //This function needs to be callable also by a thread different from the one
     //that runs the event loop, so we need to post an event to wake the event
@@ -96,12 +174,104 @@ void Window::needsPartialRedraw(Drawable* d)
     redrawNeeded=true;
 }
 
+void Window::invalidateArea(DrawArea da)
+{
+    PthreadLock lock(mutex);
+    damage.push_back(Damage(da,0));
+    #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+    redrawRequests++;
+    #endif //MXGUI_ENABLE_LATENCY_TRACKING
+    if(redrawNeeded) return;
+    postEventImpl(Event(EventType::WindowPartialRedraw));
+    redrawNeeded=true;
+}
+
 void Window::postEvent(Event e)
 {
+    MXGUI_TRACE_INSTANT("postEvent",e.getEvent());
     PthreadLock lock(mutex);
     postEventImpl(e);
 }
 
+void Window::setFocus(Drawable *d)
+{
+    PthreadLock lock(mutex);
+    if(d && d->focusable==false) return;
+    focus=d;
+}
+
+void Window::focusNext()
+{
+    PthreadLock lock(mutex);
+    list<Drawable*>::iterator it=find(drawables.begin(),drawables.end(),focus);
+    //If no drawable has the focus, it is the end iterator, so start from the
+    //first one
+    for(unsigned int i=0;i<drawables.size();i++)
+    {
+        if(it==drawables.end() || ++it==drawables.end()) it=drawables.begin();
+        if((*it)->focusable) { focus=*it; return; }
+    }
+}
+
+void Window::focusPrevious()
+{
+    PthreadLock lock(mutex);
+    list<Drawable*>::iterator it=find(drawables.begin(),drawables.end(),focus);
+    for(unsigned int i=0;i<drawables.size();i++)
+    {
+        if(it==drawables.begin()) it=drawables.end();
+        --it;
+        if((*it)->focusable) { focus=*it; return; }
+    }
+}
+
+unsigned int Window::addTimer(unsigned int delay, function<void ()> callback,
+                              unsigned int period)
+{
+    Timer timer;
+    timer.deadline=getEventTime()+delay*1000000LL;
+    timer.period=period*1000000LL;
+    timer.callback=callback;
+    PthreadLock lock(mutex);
+    timer.id=nextTimerId++;
+    if(nextTimerId==0) nextTimerId=1;
+    timers.push_back(timer);
+    pthread_cond_signal(&cond); //Wake the event loop to update its timeout
+    return timer.id;
+}
+
+unsigned int Window::requestFrame(function<void (long long)> callback)
+{
+    Timer timer;
+    timer.period=0;
+    timer.frameCallback=callback;
+    PthreadLock lock(mutex);
+    //Align to the next tick of the frame clock
+    timer.deadline=(getEventTime()/framePeriod+1)*framePeriod;
+    timer.id=nextTimerId++;
+    if(nextTimerId==0) nextTimerId=1;
+    timers.push_back(timer);
+    pthread_cond_signal(&cond);
+    return timer.id;
+}
+
+void Window::cancelTimer(unsigned int id)
+{
+    PthreadLock lock(mutex);
+    for(list<Timer>::iterator it=timers.begin();it!=timers.end();++it)
+    {
+        if(it->id!=id) continue;
+        timers.erase(it);
+        return;
+    }
+}
+
+void Window::setFramePeriod(unsigned int period)
+{
+    PthreadLock lock(mutex);
+    if(period>0) framePeriod=period*1000000LL;
+}
+
 void Window::eventLoop()
 {
     for(;;)
@@ -109,18 +279,53 @@ void Window::eventLoop()
         Event e=getEvent();
         
         if(e.getEvent()==EventType::WindowQuit) return;
+        if(e.getEvent()==EventType::Default)
+        {
+            //Returned by getEvent() when timers have expired
+            runTimers();
+            continue;
+        }
         if(e.getEvent()==EventType::WindowPartialRedraw)
         {
-            FullScreenDrawingContextProxy dc(DisplayManager::instance().getDisplay());//FIXME: get it fron the window manager
-            dc.setTextColor(make_pair(prefs.foreground,prefs.background));
-            for(list<Drawable*>::iterator it=drawables.begin();
-                it!=drawables.end();++it)
+            MXGUI_TRACE_SCOPE("WindowPartialRedraw");
             {
-                
-                if((*it)->needsRedraw()==false) continue;
-                (*it)->onDraw(dc);
-                (*it)->redrawDone();
+                PthreadLock lock(mutex);
+                collectRedraws();
             }
+            if(redrawList.empty())
+            {
+                #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+                numLatencyPending=0;
+                #endif //MXGUI_ENABLE_LATENCY_TRACKING
+                continue;
+            }
+            {
+                FullScreenDrawingContextProxy dc(DisplayManager::instance().getDisplay());//FIXME: get it fron the window manager
+                dc.setTextColor(make_pair(prefs.foreground,prefs.background));
+                for(vector<Drawable*>::iterator it=redrawList.begin();
+                    it!=redrawList.end();++it)
+                {
+                    MXGUI_TRACE_SCOPE("onDraw");
+                    (*it)->onDraw(dc);
+                    (*it)->redrawDone();
+                }
+            }
+            #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+            //The drawing context has been destroyed, so the display has been
+            //updated and the events that caused the redraw are now visible
+            long long now=getEventTime();
+            for(unsigned int i=0;i<numLatencyPending;i++)
+            {
+                const Event& pe=latencyPending[i];
+                LatencyTracker::instance().addSample(pe.getId(),
+                    now-pe.getTimestamp());
+                #ifdef MXGUI_ENABLE_TRACE
+                Tracer::instance().complete("input-to-photon",
+                    pe.getTimestamp(),now-pe.getTimestamp(),pe.getId());
+                #endif //MXGUI_ENABLE_TRACE
+            }
+            numLatencyPending=0;
+            #endif //MXGUI_ENABLE_LATENCY_TRACKING
             //Filter out this event
             continue;
         }
@@ -137,19 +342,107 @@ void Window::eventLoop()
             }
             //Do not filter this out
         }*/
-        //Forward event. For now we do not yet have a way for a Drawable to
-        //register only for a certain class of events, such as touch events only
-        //in their draw area, but we simply forward each event to all Drawables,
-        //this is a space-speed tradeoff
-        for(list<Drawable*>::iterator it=drawables.begin();
-            it!=drawables.end();++it)
-                (*it)->onEvent(e);
+        #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+        unsigned int requests;
+        {
+            PthreadLock lock(mutex);
+            requests=redrawRequests;
+        }
+        #endif //MXGUI_ENABLE_LATENCY_TRACKING
+        dispatchEvent(e);
+        #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+        //If handling the event caused a redraw, its latency is measured when
+        //the redraw is done. All queued events are given an id, but only
+        //user input is measured, not window manager events nor the events
+        //returned to run timers, which have no id. Events beyond the pending
+        //ones are not measured
+        bool input=e.getId()!=0
+                && e.getEvent()!=EventType::WindowForeground
+                && e.getEvent()!=EventType::WindowBackground
+                && e.getEvent()!=EventType::WindowQuit;
+        if(input && numLatencyPending<maxLatencyPending)
+        {
+            PthreadLock lock(mutex);
+            if(redrawRequests!=requests)
+                latencyPending[numLatencyPending++]=e;
+        }
+        #endif //MXGUI_ENABLE_LATENCY_TRACKING
+    }
+}
+
+void Window::dispatchEvent(Event e)
+{
+    MXGUI_TRACE_SCOPE("onEvent",e.getEvent());
+    if(e.hasValidPoint())
+    {
+        vector<Drawable*> snapshot;
+        {
+            PthreadLock lock(mutex);
+            hitTest(e);
+            snapshot=targets;
+        }
+        //Drawables may be removed by the onEvent of a previous one, which
+        //also removes them from targets, so iterate over a copy and skip them
+        for(vector<Drawable*>::iterator it=snapshot.begin();
+            it!=snapshot.end();++it)
+        {
+            {
+                PthreadLock lock(mutex);
+                if(find(targets.begin(),targets.end(),*it)==targets.end())
+                    continue;
+            }
+            (*it)->onEvent(e);
+        }
+        return;
     }
+    Drawable *f=focus;
+    if(f && e.getEvent()!=EventType::WindowForeground
+         && e.getEvent()!=EventType::WindowBackground)
+    {
+        f->onEvent(e);
+        return;
+    }
+    //Window events, and all events if no drawable has the focus are forwarded
+    //to all drawables
+    for(list<Drawable*>::iterator it=drawables.begin();
+        it!=drawables.end();++it)
+            (*it)->onEvent(e);
+}
+
+void Window::hitTest(Event e)
+{
+    //A drag stays with the drawables that received the TouchDown, so that
+    //they can notice it leaving their area
+    if(captured.empty()==false && e.getEvent()!=EventType::TouchDown)
+    {
+        targets=captured;
+        if(e.getEvent()==EventType::TouchUp) captured.clear();
+        return;
+    }
+    targets.clear();
+    Point p=e.getPoint();
+    int x0,y0,x1,y1;
+    if(gridRange(DrawArea(p,p),x0,y0,x1,y1))
+    {
+        //Topmost first
+        const vector<Drawable*>& cell=grid[y0*gridWidth+x0];
+        for(vector<Drawable*>::const_reverse_iterator it=cell.rbegin();
+            it!=cell.rend();++it)
+        {
+            DrawArea da=(*it)->da;
+            if(within(p,da.first,da.second)) targets.push_back(*it);
+        }
+    }
+    if(e.getEvent()==EventType::TouchDown) captured=targets;
+    else captured.clear();
 }
 
 void Window::postEventImpl(Event e)
 {
-    events.push_back(e);
+    //Producers are serialized by the mutex. TouchMove events are coalesced
+    //and use at most half of the queue, so the other events are lost only if
+    //the event loop falls behind by that many of them
+    events.put(e);
     pthread_cond_signal(&cond);
 }
 
@@ -158,29 +451,157 @@ Event Window::getEvent()
     PthreadLock lock(mutex);
     for(;;)
     {
-        if(events.empty()==false)
+        Event result;
+        if(events.get(result))
         {
-            Event result=events.front();
-            events.pop_front();
             //Filter out WindowPartialRedraw that is done through redrawNeeded
             if(result.getEvent()==EventType::WindowPartialRedraw) continue;
             return result;
         } else {
-            //No event, check if we need to redraw. The idea behind this is:
+            //No event, run expired timers before redrawing, so that all the
+            //redraws they cause are done at once
+            long long deadline=nextDeadline();
+            if(deadline>=0 && deadline<=getEventTime())
+                return Event(EventType::Default);
+            //Check if we need to redraw. The idea behind this is:
             //in case more than one event show up, we first process them all
             //and redraw after all events if redrawNeeded is true
             if(redrawNeeded)
             {
                 redrawNeeded=false;
                 return Event(EventType::WindowPartialRedraw);
-            } else {
-                //No event and no redraw needed, wait for an event
+            } else if(deadline<0) {
+                //No event, no timer and no redraw needed, wait for an event
                 pthread_cond_wait(&cond,&mutex);
+            } else {
+                //Wait for an event or the next timer
+                timespec ts;
+                ts.tv_sec=deadline/1000000000LL;
+                ts.tv_nsec=deadline%1000000000LL;
+                pthread_cond_timedwait(&cond,&mutex,&ts);
             }
         }
     }
 }
 
+void Window::runTimers()
+{
+    long long now=getEventTime();
+    //Collect the ids first, as callbacks may add or cancel timers
+    vector<unsigned int> expired;
+    {
+        PthreadLock lock(mutex);
+        for(list<Timer>::iterator it=timers.begin();it!=timers.end();++it)
+            if(it->deadline<=now) expired.push_back(it->id);
+    }
+    for(vector<unsigned int>::iterator id=expired.begin();id!=expired.end();++id)
+    {
+        Timer timer;
+        {
+            PthreadLock lock(mutex);
+            list<Timer>::iterator it=timers.begin();
+            while(it!=timers.end() && it->id!=*id) ++it;
+            if(it==timers.end()) continue; //Cancelled by a previous callback
+            timer=*it;
+            if(it->period==0) timers.erase(it);
+            else {
+                //Skip periods that were missed, instead of calling the
+                //callback repeatedly to catch up
+                it->deadline+=it->period;
+                if(it->deadline<=now)
+                    it->deadline=now+it->period-(now-it->deadline)%it->period;
+            }
+        }
+        if(timer.frameCallback) timer.frameCallback(timer.deadline);
+        else timer.callback();
+    }
+}
+
+long long Window::nextDeadline() const
+{
+    long long result=-1;
+    for(list<Timer>::const_iterator it=timers.begin();it!=timers.end();++it)
+        if(result<0 || it->deadline<result) result=it->deadline;
+    return result;
+}
+
+void Window::collectRedraws()
+{
+    //Each pass has its own mark, so that there is no need to clear the marks
+    //of all drawables before starting
+    redrawPass++;
+    redrawList.clear();
+    for(vector<Drawable*>::iterator it=dirty.begin();it!=dirty.end();++it)
+        if((*it)->redrawMark!=redrawPass) markForRedraw(*it);
+    dirty.clear();
+    //Process damage till no new drawable is marked. Every drawable is marked
+    //at most once, and adds at most one damage rectangle
+    while(damage.empty()==false)
+    {
+        Damage dmg=damage.back();
+        damage.pop_back();
+        int x0,y0,x1,y1;
+        if(gridRange(dmg.first,x0,y0,x1,y1)==false) continue;
+        for(int y=y0;y<=y1;y++)
+        {
+            for(int x=x0;x<=x1;x++)
+            {
+                vector<Drawable*>& cell=grid[y*gridWidth+x];
+                for(vector<Drawable*>::iterator it=cell.begin();
+                    it!=cell.end();++it)
+                {
+                    Drawable *d=*it;
+                    if(d->z<dmg.second || intersects(d->da,dmg.first)==false)
+                        continue;
+                    d->damaged=true;
+                    if(d->redrawMark!=redrawPass) markForRedraw(d);
+                }
+            }
+        }
+    }
+    //Draw in stacking order
+    sort(redrawList.begin(),redrawList.end(),[](Drawable *a, Drawable *b) {
+        return a->z<b->z;
+    });
+}
+
+void Window::markForRedraw(Drawable *d)
+{
+    d->redrawMark=redrawPass;
+    if(isOccluded(d))
+    {
+        //Not visible, no need to draw it nor what is above it
+        d->redrawDone();
+        return;
+    }
+    redrawList.push_back(d);
+    //Drawing d overwrites what is above it in the same area
+    damage.push_back(Damage(d->da,d->z+1));
+}
+
+bool Window::isOccluded(const Drawable *d) const
+{
+    //An occluding drawable intersects all the cells spanned by d, so looking
+    //into the first one is enough
+    int x0,y0,x1,y1;
+    if(gridRange(d->da,x0,y0,x1,y1)==false) return false;
+    const vector<Drawable*>& cell=grid[y0*gridWidth+x0];
+    for(vector<Drawable*>::const_reverse_iterator it=cell.rbegin();
+        it!=cell.rend() && (*it)->z>d->z;++it)
+        if(contains((*it)->da,d->da)) return true;
+    return false;
+}
+
+bool Window::gridRange(DrawArea da, int& x0, int& y0, int& x1, int& y1) const
+{
+    if(da.second.x()<0 || da.second.y()<0) return false;
+    x0=max<int>(0,da.first.x())/gridCellSize;
+    y0=max<int>(0,da.first.y())/gridCellSize;
+    x1=min<int>(gridWidth-1,da.second.x()/gridCellSize);
+    y1=min<int>(gridHeight-1,da.second.y()/gridCellSize);
+    return x0<=x1 && y0<=y1;
+}
+
 Window::~Window()
 {
     pthread_mutex_destroy(&mutex);
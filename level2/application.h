@@ -35,6 +35,8 @@
 #include "display.h"
 #include "input.h"
 #include "drawing_context_proxy.h"
+#include "event_ring.h"
+#include "latency_tracker.h"
 
 #ifdef MXGUI_LEVEL_2
 
@@ -66,7 +68,10 @@ public:
 
 /**
  * \ingroup pub_iface_2
- * Any object that can be drawn on screen has to extend Drawable
+ * Any object that can be drawn on screen has to extend Drawable.
+ * Drawables are stacked in the order they are created, the last one being on
+ * top, and are expected to completely paint their draw area when drawn, as
+ * the window skips redrawing drawables that are fully covered by another one
  */
 class Drawable
 {
@@ -97,12 +102,30 @@ public:
      * Called after onDraw() by the parent window when the Drawable is being
      * redrawn, do not call this directly.
      */
-    void redrawDone() { needRedraw=false; }
+    void redrawDone() { needRedraw=false; damaged=false; }
     
     /**
      * \return true if this Drawable needs to be redrawn 
      */
     bool needsRedraw() const { return needRedraw; }
+
+    /**
+     * Add or remove this object from the focus chain of its window. Events
+     * that carry no point, such as key events, are delivered to the focused
+     * drawable only
+     * \param focusable true if this object can receive the focus
+     */
+    void setFocusable(bool focusable);
+
+    /**
+     * \return true if this object is part of the focus chain
+     */
+    bool isFocusable() const { return focusable; }
+
+    /**
+     * \return true if this object has the focus
+     */
+    bool hasFocus() const;
     
     /**
      * \internal
@@ -116,6 +139,10 @@ public:
      * \internal
      * Override this member function to handle user input events. Called by the
      * parent Window, do not call this directly.
+     * Events with a point are only delivered to the drawables whose draw area
+     * contains it, except that after a TouchDown all events up to and
+     * including the TouchUp are delivered to the drawables that received it,
+     * even if outside their draw area.
      * \param e event
      */
     virtual void onEvent(Event e);
@@ -135,11 +162,27 @@ protected:
      * \return the draw area of the object
      */
     DrawArea getDrawArea() const { return da; }
+
+    /**
+     * Can only be called from onDraw()
+     * \return true if the object is being redrawn also because something
+     * overwrote the screen area it occupies, and not only because it called
+     * enqueueForRedraw(). In this case it must be drawn entirely, while
+     * otherwise an object that knows what changed since it was last drawn
+     * can redraw only that
+     */
+    bool needsFullRedraw() const { return damaged; }
     
 private:
     Window *w;       ///< Window to which this drawable belongs
     DrawArea da;     ///< Area on screen occupied by this object
     bool needRedraw; ///< True if this object needs to be redrawn
+    bool damaged;    ///< True if the screen area of this object was overwritten
+    bool focusable;  ///< True if this object is part of the focus chain
+    unsigned int z;          ///< Stacking order, higher is on top
+    unsigned int redrawMark; ///< Last redraw pass that selected this object
+
+    friend class Window;
 };
 
 /**
@@ -179,6 +222,13 @@ public:
      * \param d drawable that needs to be redrawn
      */
     void needsPartialRedraw(Drawable *d);
+
+    /**
+     * Signal that an area of the window needs to be redrawn. All the
+     * drawables intersecting it will be redrawn.
+     * \param da area to redraw
+     */
+    void invalidateArea(DrawArea da);
     
     /**
      * \internal
@@ -187,6 +237,66 @@ public:
      * \param e event to post
      */
     void postEvent(Event e);
+
+    /**
+     * Give the focus to a drawable
+     * \param d drawable that will receive events with no point information.
+     * It must be focusable. Passing nullptr removes the focus, in this case
+     * events with no point information are delivered to all drawables
+     */
+    void setFocus(Drawable *d);
+
+    /**
+     * \return the drawable that has the focus, or nullptr if none
+     */
+    Drawable *getFocus() const { return focus; }
+
+    /**
+     * Move the focus to the next focusable drawable, in stacking order
+     */
+    void focusNext();
+
+    /**
+     * Move the focus to the previous focusable drawable, in stacking order
+     */
+    void focusPrevious();
+
+    /**
+     * Start a timer. Timer callbacks are called by the thread running the
+     * event loop, so they can access drawables without further
+     * synchronization.
+     * \param delay time in milliseconds after which the callback is called
+     * \param callback callback to call
+     * \param period if nonzero, the callback is then called periodically with
+     * this period in milliseconds, till the timer is cancelled
+     * \return the timer id, to be used to cancel the timer
+     */
+    unsigned int addTimer(unsigned int delay, std::function<void ()> callback,
+                          unsigned int period=0);
+
+    /**
+     * Request a callback at the next tick of the frame clock. All the
+     * callbacks requested for the same frame are called together, and the
+     * drawables they enqueue for redraw are then redrawn once. To animate,
+     * request a new frame from the callback.
+     * \param callback callback to call, its parameter is the frame time in
+     * nanoseconds
+     * \return the request id, to be used to cancel the request
+     */
+    unsigned int requestFrame(std::function<void (long long)> callback);
+
+    /**
+     * Cancel a timer or a frame request. Cancelling a timer that already
+     * expired has no effect.
+     * \param id id returned by addTimer() or requestFrame()
+     */
+    void cancelTimer(unsigned int id);
+
+    /**
+     * Set the frame clock period, the default is level2FramePeriod
+     * \param period frame period in milliseconds
+     */
+    void setFramePeriod(unsigned int period);
     
     /**
      * \internal
@@ -215,13 +325,111 @@ private:
      * \return an event to run the event loop. Blocking 
      */
     Event getEvent();
-    
+
+    /**
+     * Call the expired timers and frame callbacks
+     */
+    void runTimers();
+
+    /**
+     * \return the time of the next timer or frame callback to call, or -1 if
+     * none. Needs the mutex locked
+     */
+    long long nextDeadline() const;
+
+    /**
+     * Deliver an event to the drawables that should receive it
+     * \param e event
+     */
+    void dispatchEvent(Event e);
+
+    /**
+     * Find the drawables that should receive an event with a point, and
+     * update the touch capture state. Needs the mutex locked
+     * \param e event
+     */
+    void hitTest(Event e);
+
+    /**
+     * Compute the drawables to redraw starting from the accumulated damage.
+     * Drawables overlapping a redrawn one and stacked above it are redrawn
+     * too, while drawables fully covered by another one are skipped.
+     * Needs the mutex locked
+     */
+    void collectRedraws();
+
+    /**
+     * Mark a drawable as to be redrawn in the current redraw pass.
+     * Needs the mutex locked
+     * \param d drawable to mark
+     */
+    void markForRedraw(Drawable *d);
+
+    /**
+     * \param d a drawable
+     * \return true if d is fully covered by a drawable stacked above it.
+     * Needs the mutex locked
+     */
+    bool isOccluded(const Drawable *d) const;
+
+    /**
+     * Compute the grid cells spanned by an area
+     * \param da area
+     * \param x0 first cell column
+     * \param y0 first cell row
+     * \param x1 last cell column
+     * \param y1 last cell row
+     * \return false if the area does not span any cell
+     */
+    bool gridRange(DrawArea da, int& x0, int& y0, int& x1, int& y1) const;
+
+    /// Size in pixels of the square cells of the spatial index grid
+    static const int gridCellSize=32;
+
+    /// A rectangle to redraw and the lowest stacking order to redraw in it
+    typedef std::pair<DrawArea,unsigned int> Damage;
+
+    /**
+     * A timer or a frame request
+     */
+    struct Timer
+    {
+        unsigned int id;                   ///< Timer id
+        long long deadline;                ///< Next expiration, nanoseconds
+        long long period;                  ///< Period, zero if one shot
+        std::function<void ()> callback;   ///< Timer callback
+        std::function<void (long long)> frameCallback; ///< Frame callback
+    };
+
     std::list<Drawable *> drawables; ///< List of drawables on the window
-    std::list<Event> events;         ///< List of unprocessed events
+    /// Spatial index, each cell lists the drawables intersecting it, sorted by
+    /// stacking order
+    std::vector<std::vector<Drawable *> > grid;
+    int gridWidth;                   ///< Number of grid columns
+    int gridHeight;                  ///< Number of grid rows
+    unsigned int nextZ;              ///< Stacking order of next drawable
+    unsigned int redrawPass;         ///< Counter of redraw passes
+    std::vector<Drawable *> dirty;   ///< Drawables that asked to be redrawn
+    std::vector<Damage> damage;      ///< Accumulated damage
+    std::vector<Drawable *> redrawList; ///< Drawables to redraw in this pass
+    std::vector<Drawable *> captured; ///< Drawables that received TouchDown
+    std::vector<Drawable *> targets;  ///< Drawables receiving current event
+    Drawable *focus;                  ///< Drawable that has the focus
+    std::list<Timer> timers;          ///< Active timers and frame requests
+    unsigned int nextTimerId;         ///< Id of next timer, zero is invalid
+    long long framePeriod;            ///< Frame clock period in nanoseconds
+    EventRing<32> events;            ///< Queue of unprocessed events
     pthread_mutex_t mutex;           ///< To serialize concurrent access
     pthread_cond_t cond;             ///< Condition variable for the evnt loop
     WindowPreferences prefs;         ///< Window preferences
     bool redrawNeeded;               ///< True if a redraw is needed
+    #ifdef MXGUI_ENABLE_LATENCY_TRACKING
+    static const unsigned int maxLatencyPending=8;
+    unsigned int redrawRequests;     ///< Incremented at every redraw request
+    unsigned int numLatencyPending;  ///< Number of events in latencyPending
+    /// Events that caused a redraw, waiting for the redraw to be flushed
+    Event latencyPending[maxLatencyPending];
+    #endif //MXGUI_ENABLE_LATENCY_TRACKING
 };
 
 /**
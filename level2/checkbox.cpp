@@ -29,6 +29,7 @@
 #ifdef MXGUI_LEVEL_2
 
 #include <utility>
+#include "shapes.h"
 
 using namespace std;
 
@@ -86,11 +87,11 @@ bool CheckBox::isChecked()
 void CheckBox::onDraw(DrawingContextProxy& dc)
 {
     DrawArea da=getDrawArea();
-    dc.clear(da.first,da.second,colors.second);
-    dc.drawImage(da.first,tl);
-    dc.drawImage(Point(da.second.x()-2,da.first.y()),tr);
-    dc.drawImage(Point(da.first.x(),da.second.y()-2),bl);
-    dc.drawImage(innerPointBr,br);
+    Color bg=getWindow()->getPreferences().background;
+    dc.clear(da.first,da.second,bg);
+    fillRoundedRectangle(dc,da.first,da.second,3,black,bg);
+    fillRoundedRectangle(dc,Point(da.first.x()+1,da.first.y()+1),
+        Point(da.second.x()-1,da.second.y()-1),2,colors.second,black);
     if(isChecked())
     {
         dc.line(innerPointTl,innerPointBr,black);
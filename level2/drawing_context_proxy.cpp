@@ -54,6 +54,17 @@ void FullScreenDrawingContextProxy::clippedWrite(Point p, Point a, Point b, cons
     dc.clippedWrite(p,a,b,text);
 }
 
+void FullScreenDrawingContextProxy::write(Point p, const TextRun& run)
+{
+    dc.write(p,run);
+}
+
+void FullScreenDrawingContextProxy::clippedWrite(Point p, Point a, Point b,
+        const TextRun& run)
+{
+    dc.clippedWrite(p,a,b,run);
+}
+
 void FullScreenDrawingContextProxy::clear(Color color)
 {
     dc.clear(color);
@@ -94,11 +105,27 @@ void FullScreenDrawingContextProxy::clippedDrawImage(Point p, Point a, Point b,
     dc.clippedDrawImage(p,a,b,img);
 }
 
+void FullScreenDrawingContextProxy::drawSprite(Point p, const Sprite& sprite)
+{
+    dc.drawSprite(p,sprite);
+}
+
+void FullScreenDrawingContextProxy::clippedDrawSprite(Point p, Point a,
+        Point b, const Sprite& sprite)
+{
+    dc.clippedDrawSprite(p,a,b,sprite);
+}
+
 void FullScreenDrawingContextProxy::drawRectangle(Point a, Point b, Color c)
 {
     dc.drawRectangle(a,b,c);
 }
 
+bool FullScreenDrawingContextProxy::copyArea(Point a, Point b, Point dst)
+{
+    return dc.copyArea(a,b,dst);
+}
+
 short int FullScreenDrawingContextProxy::getHeight() const
 {
     return dc.getHeight();
@@ -129,6 +156,16 @@ Font FullScreenDrawingContextProxy::getFont() const
     return dc.getFont();
 }
 
+void FullScreenDrawingContextProxy::setTransparentText(bool transparent)
+{
+    dc.setTransparentText(transparent);
+}
+
+bool FullScreenDrawingContextProxy::getTransparentText() const
+{
+    return dc.getTransparentText();
+}
+
 //
 // class BackgroudDrawingContextProxy
 //
@@ -70,6 +70,25 @@ public:
      */
     virtual void clippedWrite(Point p, Point a, Point b, const char *text)=0;
 
+    /**
+     * Write a TextRun to the display, with the font of the run. If text is
+     * too long it will be truncated
+     * \param p point where the upper left corner of the text will be printed
+     * \param run text to print
+     */
+    virtual void write(Point p, const TextRun& run)=0;
+
+    /**
+     * Write part of a TextRun to the display, with the font of the run
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    virtual void clippedWrite(Point p, Point a, Point b, const TextRun& run)=0;
+
     /**
      * Clear the Display. The screen will be filled with the desired color
      * \param color fill color
@@ -136,6 +155,27 @@ public:
      */
     virtual void clippedDrawImage(Point p, Point a, Point b, const ImageBase& img)=0;
 
+    /**
+     * Draw a sprite on the screen, leaving transparent pixels as they are.
+     * Sprites are clipped to the screen
+     * \param p point of the upper left corner where the sprite will be drawn
+     * \param sprite sprite to draw
+     */
+    virtual void drawSprite(Point p, const Sprite& sprite)=0;
+
+    /**
+     * Draw part of a sprite on the screen, leaving transparent pixels as
+     * they are
+     * \param p point of the upper left corner where the sprite will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param sprite sprite to draw
+     */
+    virtual void clippedDrawSprite(Point p, Point a, Point b,
+            const Sprite& sprite)=0;
+
     /**
      * Draw a rectangle (not filled) with the desired color
      * \param a upper left corner of the rectangle
@@ -144,6 +184,17 @@ public:
      */
     virtual void drawRectangle(Point a, Point b, Color c)=0;
 
+    /**
+     * Copy a rectangular area of the screen to another position, used to
+     * scroll. Source and destination areas can overlap.
+     * \param a upper left corner of the area to copy
+     * \param b lower right corner of the area to copy
+     * \param dst where the upper left corner of the area is copied
+     * \return false if the display does not support it, in this case nothing
+     * is copied and the destination area has to be redrawn
+     */
+    virtual bool copyArea(Point a, Point b, Point dst)=0;
+
     /**
      * \return the display's height
      */
@@ -176,6 +227,18 @@ public:
      * \return the current font used to draw text
      */
     virtual Font getFont() const=0;
+
+    /**
+     * Select whether text is written with a transparent background
+     * \param transparent if true write() and clippedWrite() only draw the
+     * text foreground and antialiasing pixels, leaving the background as is
+     */
+    virtual void setTransparentText(bool transparent)=0;
+
+    /**
+     * \return true if text is written with a transparent background
+     */
+    virtual bool getTransparentText() const=0;
     
     /**
      * Destructor
@@ -220,6 +283,25 @@ public:
      */
     virtual void clippedWrite(Point p, Point a, Point b, const char *text);
 
+    /**
+     * Write a TextRun to the display, with the font of the run. If text is
+     * too long it will be truncated
+     * \param p point where the upper left corner of the text will be printed
+     * \param run text to print
+     */
+    virtual void write(Point p, const TextRun& run);
+
+    /**
+     * Write part of a TextRun to the display, with the font of the run
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param run text to write
+     */
+    virtual void clippedWrite(Point p, Point a, Point b, const TextRun& run);
+
     /**
      * Clear the Display. The screen will be filled with the desired color
      * \param color fill color
@@ -286,6 +368,27 @@ public:
      */
     virtual void clippedDrawImage(Point p, Point a, Point b, const ImageBase& img);
 
+    /**
+     * Draw a sprite on the screen, leaving transparent pixels as they are.
+     * Sprites are clipped to the screen
+     * \param p point of the upper left corner where the sprite will be drawn
+     * \param sprite sprite to draw
+     */
+    virtual void drawSprite(Point p, const Sprite& sprite);
+
+    /**
+     * Draw part of a sprite on the screen, leaving transparent pixels as
+     * they are
+     * \param p point of the upper left corner where the sprite will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param sprite sprite to draw
+     */
+    virtual void clippedDrawSprite(Point p, Point a, Point b,
+            const Sprite& sprite);
+
     /**
      * Draw a rectangle (not filled) with the desired color
      * \param a upper left corner of the rectangle
@@ -294,6 +397,17 @@ public:
      */
     virtual void drawRectangle(Point a, Point b, Color c);
 
+    /**
+     * Copy a rectangular area of the screen to another position, used to
+     * scroll. Source and destination areas can overlap.
+     * \param a upper left corner of the area to copy
+     * \param b lower right corner of the area to copy
+     * \param dst where the upper left corner of the area is copied
+     * \return false if the display does not support it, in this case nothing
+     * is copied and the destination area has to be redrawn
+     */
+    virtual bool copyArea(Point a, Point b, Point dst);
+
     /**
      * \return the display's height
      */
@@ -326,6 +440,18 @@ public:
      * \return the current font used to draw text
      */
     virtual Font getFont() const;
+
+    /**
+     * Select whether text is written with a transparent background
+     * \param transparent if true write() and clippedWrite() only draw the
+     * text foreground and antialiasing pixels, leaving the background as is
+     */
+    virtual void setTransparentText(bool transparent);
+
+    /**
+     * \return true if text is written with a transparent background
+     */
+    virtual bool getTransparentText() const;
     
 private:
     DrawingContext dc;
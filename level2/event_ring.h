@@ -0,0 +1,186 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include "input.h"
+
+#ifdef MXGUI_LEVEL_2
+
+namespace mxgui {
+
+/**
+ * \internal
+ * Lock-free, allocation-free queue of events with a single producer and a
+ * single consumer. Consecutive TouchMove events are coalesced, keeping only
+ * the newest position, and TouchMove events can only use part of the queue,
+ * so that touch and button edges such as TouchDown and TouchUp always find
+ * room even under heavy touch traffic.
+ * A TouchMove that finds no room is coalesced into a slot that holds the
+ * newest position, delivered as soon as the queue empties or before the next
+ * event, so the last position of a drag is never held back.
+ * \param N queue size, must be a power of two
+ */
+template<unsigned int N>
+class EventRing
+{
+public:
+    static_assert(N>=4 && (N & (N-1))==0,"N must be a power of two");
+
+    /**
+     * Constructor
+     */
+    EventRing() : head(0), tail(0), pendingState(Empty) {}
+
+    /**
+     * Add an event to the queue, can only be called by the producer.
+     * Events without a timestamp are timestamped and given an id.
+     * \param e event to add
+     * \return false if the event was dropped because the queue is full.
+     * TouchMove events are never dropped, only coalesced, and the other
+     * events always find at least N/2 free slots, so they are dropped only if
+     * the consumer falls behind by that many of them
+     */
+    bool put(Event e)
+    {
+        if(e.getTimestamp()==0)
+        {
+            e.setTimestamp(getEventTime());
+            e.setId(newEventId());
+        }
+        Event p;
+        if(e.getEvent()==EventType::TouchMove)
+        {
+            //Replaces any older pending position, that is thus discarded
+            if(push(e,N/2)) takePending(p);
+            else setPending(e);
+            return true;
+        }
+        //The last position before the edge is delivered if possible
+        if(takePending(p)) push(p,1);
+        return push(e,0);
+    }
+
+    /**
+     * Remove an event from the queue, can only be called by the consumer.
+     * If more TouchMove events are queued one after the other, only the newest
+     * is returned.
+     * \param e the event is returned here
+     * \return false if the queue is empty
+     */
+    bool get(Event& e)
+    {
+        unsigned int t=tail.load(std::memory_order_relaxed);
+        unsigned int h=head.load(std::memory_order_acquire);
+        //A parked TouchMove is newer than all queued events
+        if(t==h) return takePending(e);
+        e=buffer[t % N];
+        t++;
+        while(e.getEvent()==EventType::TouchMove && t!=h
+              && buffer[t % N].getEvent()==EventType::TouchMove)
+            e=buffer[t++ % N];
+        tail.store(t,std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \return true if the queue is empty, only meaningful for the consumer
+     */
+    bool isEmpty() const
+    {
+        return tail.load(std::memory_order_relaxed)==
+               head.load(std::memory_order_acquire)
+            && pendingState.load(std::memory_order_acquire)!=Full;
+    }
+
+private:
+    EventRing(const EventRing&)=delete;
+    EventRing& operator=(const EventRing&)=delete;
+
+    /**
+     * Add an event to the queue
+     * \param e event
+     * \param reserved number of slots that must remain free after adding it
+     * \return false if there is no room
+     */
+    bool push(const Event& e, unsigned int reserved)
+    {
+        unsigned int h=head.load(std::memory_order_relaxed);
+        unsigned int t=tail.load(std::memory_order_acquire);
+        if(h-t+reserved>=N) return false;
+        buffer[h % N]=e;
+        head.store(h+1,std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Park a TouchMove that found no room, can only be called by the producer
+     * \param e event
+     */
+    void setPending(const Event& e)
+    {
+        if(pendingState.exchange(Busy,std::memory_order_acquire)==Busy)
+        {
+            //The consumer is taking the previous one, as the queue is empty
+            push(e,0);
+            return;
+        }
+        pending=e;
+        pendingState.store(Full,std::memory_order_release);
+    }
+
+    /**
+     * Take the parked TouchMove, if any. Called by both the producer and the
+     * consumer, the one that finds it busy backs off instead of waiting, so
+     * that it is safe even if the producer is an interrupt
+     * \param e the event is returned here
+     * \return true if an event was taken
+     */
+    bool takePending(Event& e)
+    {
+        if(pendingState.load(std::memory_order_relaxed)!=Full) return false;
+        unsigned char s=pendingState.exchange(Busy,std::memory_order_acquire);
+        if(s==Busy) return false; //The other side is accessing it
+        if(s==Full) e=pending;
+        pendingState.store(Empty,std::memory_order_release);
+        return s==Full;
+    }
+
+    /// Values of pendingState
+    enum { Empty, Full, Busy };
+
+    Event buffer[N];                ///< Queued events
+    std::atomic<unsigned int> head; ///< Written by the producer only
+    std::atomic<unsigned int> tail; ///< Written by the consumer only
+    Event pending;                  ///< Newest TouchMove that found no room
+    std::atomic<unsigned char> pendingState; ///< Ownership of pending
+};
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2
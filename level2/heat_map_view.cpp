@@ -0,0 +1,174 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "heat_map_view.h"
+#include <algorithm>
+
+#ifdef MXGUI_LEVEL_2
+
+using namespace std;
+
+namespace mxgui {
+
+//
+// class HeatMapView
+//
+
+HeatMapView::HeatMapView(Window *w, Point p, short int width, short int height,
+        short int scale, const Colormap& cmap)
+    : Drawable(w,DrawArea(p,Point(p.x()+width*scale-1,p.y()+height*scale-1))),
+      cmap(cmap), data(nullptr), type(NONE), stride(width), width(width),
+      height(height), scale(scale), lo(0.f), hi(255.f)
+{
+    enqueueForRedraw();
+}
+
+void HeatMapView::setData(const unsigned char *data, int stride)
+{
+    this->data=data;
+    this->stride=stride>0 ? stride : width;
+    type=UINT8;
+    enqueueForRedraw();
+}
+
+void HeatMapView::setData(const unsigned short *data, int stride)
+{
+    this->data=data;
+    this->stride=stride>0 ? stride : width;
+    type=UINT16;
+    enqueueForRedraw();
+}
+
+void HeatMapView::setData(const float *data, int stride)
+{
+    this->data=data;
+    this->stride=stride>0 ? stride : width;
+    type=FLOAT;
+    enqueueForRedraw();
+}
+
+void HeatMapView::setRange(float lo, float hi)
+{
+    this->lo=lo;
+    this->hi=hi;
+    enqueueForRedraw();
+}
+
+void HeatMapView::setColormap(const Colormap& cmap)
+{
+    this->cmap=cmap;
+    enqueueForRedraw();
+}
+
+void HeatMapView::onDraw(DrawingContextProxy& dc)
+{
+    Point p=getDrawArea().first;
+    switch(type)
+    {
+        case UINT8:
+            drawHeatMap(dc,p,static_cast<const unsigned char*>(data),width,
+                        height,stride,lo,hi,cmap,scale);
+            break;
+        case UINT16:
+            drawHeatMap(dc,p,static_cast<const unsigned short*>(data),width,
+                        height,stride,lo,hi,cmap,scale);
+            break;
+        case FLOAT:
+            drawHeatMap(dc,p,static_cast<const float*>(data),width,
+                        height,stride,lo,hi,cmap,scale);
+            break;
+        default:
+            dc.clear(getDrawArea().first,getDrawArea().second,cmap[0]);
+            break;
+    }
+}
+
+//
+// class Waterfall
+//
+
+Waterfall::Waterfall(Window *w, Point p, short int width, short int height,
+        short int scale, const Colormap& cmap)
+    : Drawable(w,DrawArea(p,Point(p.x()+width*scale-1,p.y()+height*scale-1))),
+      cmap(cmap), rows(width*height,0), width(width), height(height),
+      scale(scale), newest(0), pending(0), fullRedraw(true), lo(0.f), hi(255.f)
+{
+    enqueueForRedraw();
+}
+
+template<typename T>
+void Waterfall::append(const T *row)
+{
+    //Rows are stored from the newest to the oldest, so that the rows to draw
+    //are at most two contiguous ranges of the ring
+    newest=newest>0 ? newest-1 : height-1;
+    unsigned char *dst=&rows[newest*width];
+    float k=hi>lo ? 255.f/(hi-lo) : 0.f;
+    for(short int i=0;i<width;i++)
+    {
+        float x=(static_cast<float>(row[i])-lo)*k;
+        dst[i]=!(x>0.f) ? 0 : x>=255.f ? 255 : static_cast<unsigned char>(x);
+    }
+    if(pending<height) pending++;
+    enqueueForRedraw();
+}
+
+template void Waterfall::append<unsigned char>(const unsigned char *row);
+template void Waterfall::append<unsigned short>(const unsigned short *row);
+template void Waterfall::append<float>(const float *row);
+
+void Waterfall::onDraw(DrawingContextProxy& dc)
+{
+    DrawArea da=getDrawArea();
+    bool full=fullRedraw || needsFullRedraw() || pending>=height;
+    //Move the older rows down, and draw only the new ones
+    if(full==false && pending>0)
+        full=!dc.copyArea(da.first,
+            Point(da.second.x(),da.second.y()-pending*scale),
+            Point(da.first.x(),da.first.y()+pending*scale));
+    if(full) drawRows(dc,0,height);
+    else drawRows(dc,0,pending);
+    pending=0;
+    fullRedraw=false;
+}
+
+void Waterfall::drawRows(DrawingContextProxy& dc, int first, int n)
+{
+    //The identity range maps the stored indices to the colormap entries
+    Point p=getDrawArea().first;
+    int start=(newest+first) % height;
+    int n1=min(n,height-start);
+    drawHeatMap(dc,Point(p.x(),p.y()+first*scale),&rows[start*width],width,
+                n1,width,0.f,255.f,cmap,scale);
+    if(n1<n)
+        drawHeatMap(dc,Point(p.x(),p.y()+(first+n1)*scale),&rows[0],width,
+                    n-n1,width,0.f,255.f,cmap,scale);
+}
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2
@@ -0,0 +1,209 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "mxgui_settings.h"
+#include "application.h"
+#include "heat_map.h"
+
+#ifdef MXGUI_LEVEL_2
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface_2
+ * Draws a matrix of scalar values, such as a thermal camera frame, as a false
+ * color image. Each value is drawn as a square of scale*scale pixels. The
+ * data is not copied, so it must remain valid while the object exists, and
+ * enqueueForRedraw() must be called when it changes.
+ */
+class HeatMapView : public Drawable
+{
+public:
+    /**
+     * Constructor
+     * \param w window to which this object belongs
+     * \param p upper left point of the image
+     * \param width number of values in a row
+     * \param height number of rows
+     * \param scale size in pixels of each value
+     * \param cmap colormap
+     */
+    HeatMapView(Window *w, Point p, short int width, short int height,
+                short int scale=1, const Colormap& cmap=Colormap(Colormap::IRON));
+
+    /**
+     * Set the data to draw
+     * \param data pointer to the first value of the first row
+     * \param stride distance in values between the start of two rows, 0
+     * means the width
+     */
+    void setData(const unsigned char *data, int stride=0);
+
+    /**
+     * Set the data to draw
+     * \param data pointer to the first value of the first row
+     * \param stride distance in values between the start of two rows, 0
+     * means the width
+     */
+    void setData(const unsigned short *data, int stride=0);
+
+    /**
+     * Set the data to draw
+     * \param data pointer to the first value of the first row
+     * \param stride distance in values between the start of two rows, 0
+     * means the width
+     */
+    void setData(const float *data, int stride=0);
+
+    /**
+     * Set the range of the values
+     * \param lo value drawn with the first color of the colormap
+     * \param hi value drawn with the last color of the colormap
+     */
+    void setRange(float lo, float hi);
+
+    /**
+     * \param cmap new colormap
+     */
+    void setColormap(const Colormap& cmap);
+
+    /**
+     * \internal
+     * Overridden this member function to draw the object.
+     * \param dc drawing context used to draw the object
+     */
+    virtual void onDraw(DrawingContextProxy& dc);
+
+private:
+    /**
+     * Type of the data
+     */
+    enum Type
+    {
+        NONE,
+        UINT8,
+        UINT16,
+        FLOAT
+    };
+
+    Colormap cmap;     ///< Colormap
+    const void *data;  ///< Data to draw
+    Type type;         ///< Type of the data
+    int stride;        ///< Distance between rows, in values
+    short int width;   ///< Number of values in a row
+    short int height;  ///< Number of rows
+    short int scale;   ///< Size of a value in pixels
+    float lo, hi;      ///< Range of the values
+};
+
+/**
+ * \ingroup pub_iface_2
+ * A waterfall display, used for spectrograms. Rows of values are appended at
+ * the top, moving the older ones down. When the display supports
+ * copyArea() only the new rows are drawn. Rows are converted to colormap
+ * indices when appended, so the object needs one byte per value.
+ */
+class Waterfall : public Drawable
+{
+public:
+    /**
+     * Constructor
+     * \param w window to which this object belongs
+     * \param p upper left point of the waterfall
+     * \param width number of values in a row
+     * \param height number of rows shown
+     * \param scale size in pixels of each value
+     * \param cmap colormap
+     */
+    Waterfall(Window *w, Point p, short int width, short int height,
+              short int scale=1, const Colormap& cmap=Colormap(Colormap::JET));
+
+    /**
+     * Append a row
+     * \param row pointer to width values
+     */
+    void appendRow(const unsigned char *row) { append(row); }
+
+    /**
+     * Append a row
+     * \param row pointer to width values
+     */
+    void appendRow(const unsigned short *row) { append(row); }
+
+    /**
+     * Append a row
+     * \param row pointer to width values
+     */
+    void appendRow(const float *row) { append(row); }
+
+    /**
+     * Set the range of the values, only affects rows appended afterwards
+     * \param lo value drawn with the first color of the colormap
+     * \param hi value drawn with the last color of the colormap
+     */
+    void setRange(float lo, float hi) { this->lo=lo; this->hi=hi; }
+
+    /**
+     * \internal
+     * Overridden this member function to draw the object.
+     * \param dc drawing context used to draw the object
+     */
+    virtual void onDraw(DrawingContextProxy& dc);
+
+private:
+    /**
+     * Convert a row to colormap indices and store it
+     * \param row pointer to width values
+     */
+    template<typename T>
+    void append(const T *row);
+
+    /**
+     * Draw a range of rows
+     * \param dc drawing context
+     * \param first first row, 0 is the newest row
+     * \param n number of rows
+     */
+    void drawRows(DrawingContextProxy& dc, int first, int n);
+
+    Colormap cmap;     ///< Colormap
+    std::vector<unsigned char> rows; ///< Ring buffer of colormap indices
+    short int width;   ///< Number of values in a row
+    short int height;  ///< Number of rows
+    short int scale;   ///< Size of a value in pixels
+    short int newest;  ///< Index in the ring of the newest row
+    short int pending; ///< Rows appended since last drawn
+    bool fullRedraw;   ///< True if all rows must be drawn
+    float lo, hi;      ///< Range of the values
+};
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2
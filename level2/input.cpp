@@ -26,6 +26,13 @@
  ***************************************************************************/
 
 #include "input.h"
+#include "trace.h"
+#include "pthread_lock.h"
+#include <ctime>
+#include <cerrno>
+#include <cstdlib>
+#include <atomic>
+#include <algorithm>
 
 #ifdef MXGUI_LEVEL_2
 
@@ -44,6 +51,21 @@ using namespace std;
 
 namespace mxgui {
 
+long long getEventTime()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return static_cast<long long>(ts.tv_sec)*1000000000LL+ts.tv_nsec;
+}
+
+unsigned int newEventId()
+{
+    static atomic<unsigned int> nextId(0);
+    unsigned int result;
+    do result=++nextId; while(result==0);
+    return result;
+}
+
 //
 // class InputHandler
 //
@@ -57,20 +79,213 @@ InputHandler& InputHandler::instance()
 
 Event InputHandler::getEvent()
 {
-    return pImpl->getEvent();
+    Event result;
+    {
+        //Wait here and not in the driver, so that a replay that starts while
+        //waiting is noticed. The driver callback signals each driver event
+        PthreadLock lock(mutex);
+        while(takeEvent(result)==false) pthread_cond_wait(&cond,&mutex);
+    }
+    MXGUI_TRACE_INSTANT("InputHandler",result.getEvent());
+    record(result);
+    return result;
 }
 
 Event InputHandler::popEvent()
 {
-    return pImpl->popEvent();
+    Event result;
+    {
+        PthreadLock lock(mutex);
+        if(takeEvent(result)==false) return result;
+    }
+    MXGUI_TRACE_INSTANT("InputHandler",result.getEvent());
+    record(result);
+    return result;
 }
 
 function<void ()> InputHandler::registerEventCallback(function<void ()> cb)
 {
-    return pImpl->registerEventCallback(cb);
+    bool pending;
+    function<void ()> current;
+    {
+        PthreadLock lock(mutex);
+        swap(callback,cb);
+        pending=replayedValid;
+        current=callback;
+    }
+    //A replayed event may have been produced before the callback was set
+    if(pending && current) current();
+    return cb;
+}
+
+bool InputHandler::startRecording(const char *filename)
+{
+    FILE *f=fopen(filename,"w");
+    if(f==nullptr) return false;
+    fputs("# mxgui input recording: time_us type x y direction key\n",f);
+    PthreadLock lock(mutex);
+    if(recordFile) fclose(recordFile);
+    recordFile=f;
+    recordStart=getEventTime();
+    return true;
+}
+
+void InputHandler::stopRecording()
+{
+    PthreadLock lock(mutex);
+    if(recordFile==nullptr) return;
+    fclose(recordFile);
+    recordFile=nullptr;
+}
+
+bool InputHandler::startReplay(const char *filename, bool realTime)
+{
+    PthreadLock lock(mutex);
+    if(replaying) return false;
+    replayFile=fopen(filename,"r");
+    if(replayFile==nullptr) return false;
+    this->realTime=realTime;
+    replaying=true;
+    //Wake the consumer, so that it starts discarding driver events
+    pthread_cond_broadcast(&cond);
+    pthread_t t;
+    if(pthread_create(&t,NULL,replayLauncher,this)!=0)
+    {
+        fclose(replayFile);
+        replayFile=nullptr;
+        replaying=false;
+        return false;
+    }
+    pthread_detach(t);
+    return true;
+}
+
+bool InputHandler::isReplaying()
+{
+    PthreadLock lock(mutex);
+    return replaying;
+}
+
+void InputHandler::waitReplayEnd()
+{
+    PthreadLock lock(mutex);
+    while(replaying) pthread_cond_wait(&cond,&mutex);
+}
+
+InputHandler::InputHandler(InputHandlerImpl *impl) : pImpl(impl),
+        recordFile(nullptr), recordStart(0), replayFile(nullptr),
+        realTime(true), replaying(false), replayedValid(false)
+{
+    pthread_mutex_init(&mutex,NULL);
+    pthread_cond_init(&cond,NULL);
+    pImpl->registerEventCallback([this]{ driverCallback(); });
 }
 
-InputHandler::InputHandler(InputHandlerImpl *impl) : pImpl(impl) {}
+void InputHandler::record(const Event& e)
+{
+    if(e.getEvent()==EventType::Default) return;
+    PthreadLock lock(mutex);
+    if(recordFile==nullptr) return;
+    long long t=e.getTimestamp()!=0 ? e.getTimestamp() : getEventTime();
+    fprintf(recordFile,"%lld %d %d %d %d %d\n",max(0LL,(t-recordStart)/1000),
+            static_cast<int>(e.getEvent()),e.getPoint().x(),e.getPoint().y(),
+            static_cast<int>(e.getDirection()),static_cast<int>(e.getKey()));
+}
+
+bool InputHandler::takeEvent(Event& e)
+{
+    if(replayedValid)
+    {
+        e=replayed;
+        replayedValid=false;
+        pthread_cond_broadcast(&cond);
+        return true;
+    }
+    if(replaying)
+    {
+        //Drain the driver queue, so that no stale event is left when the
+        //replay ends
+        while(pImpl->popEvent().getEvent()!=EventType::Default) ;
+        return false;
+    }
+    e=pImpl->popEvent();
+    return e.getEvent()!=EventType::Default;
+}
+
+void InputHandler::driverCallback()
+{
+    //The callback is copied as it may be replaced concurrently, and called
+    //without holding the lock as it may call back into the InputHandler
+    function<void ()> current;
+    {
+        PthreadLock lock(mutex);
+        pthread_cond_broadcast(&cond);
+        if(replaying) return;
+        current=callback;
+    }
+    if(current) current();
+}
+
+void *InputHandler::replayLauncher(void *arg)
+{
+    reinterpret_cast<InputHandler*>(arg)->replayThread();
+    return nullptr;
+}
+
+void InputHandler::replayThread()
+{
+    long long start=getEventTime();
+    char line[64];
+    //Parsing is done with strtol instead of sscanf to keep stack usage low
+    while(fgets(line,sizeof(line),replayFile))
+    {
+        if(line[0]=='#') continue;
+        char *p=line;
+        char *end;
+        long long t=strtoll(p,&end,10);
+        int fields[5];
+        bool valid=end!=p;
+        for(int i=0;i<5 && valid;i++)
+        {
+            p=end;
+            fields[i]=strtol(p,&end,10);
+            valid=end!=p;
+        }
+        if(valid==false) continue; //Skip empty or malformed lines
+        EventType::E type=static_cast<EventType::E>(fields[0]);
+        Event e;
+        if(fields[4]!=0) e=Event(type,static_cast<char>(fields[4]));
+        else e=Event(type,Point(fields[1],fields[2]),
+            fields[3] ? EventDirection::UP : EventDirection::DOWN);
+        if(realTime)
+        {
+            long long due=start+t*1000;
+            timespec ts;
+            ts.tv_sec=due/1000000000LL;
+            ts.tv_nsec=due%1000000000LL;
+            while(clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&ts,NULL)==EINTR) ;
+        }
+        e.setTimestamp(getEventTime());
+        e.setId(newEventId());
+        function<void ()> current;
+        {
+            PthreadLock lock(mutex);
+            replayed=e;
+            replayedValid=true;
+            pthread_cond_broadcast(&cond);
+            current=callback;
+        }
+        if(current) current();
+        //Wait for the application to consume the event
+        PthreadLock lock(mutex);
+        while(replayedValid) pthread_cond_wait(&cond,&mutex);
+    }
+    PthreadLock lock(mutex);
+    fclose(replayFile);
+    replayFile=nullptr;
+    replaying=false;
+    pthread_cond_broadcast(&cond);
+}
 
 } //namespace mxgui
 
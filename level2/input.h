@@ -28,6 +28,8 @@
 #pragma once
 
 #include <functional>
+#include <cstdio>
+#include <pthread.h>
 #include "mxgui_settings.h"
 #include "point.h"
 #include "drivers/event_types_qt.h"
@@ -76,27 +78,27 @@ public:
     /**
      * Default constructor
      */
-    Event(): e(EventType::Default), k(0), d(false), p(-1,-1) {}
+    Event(): e(EventType::Default), k(0), d(false), p(-1,-1), id(0), t(0) {}
 
     /**
      * Constructor for events without a position information
      * \param e event type
      */
-    explicit Event(EventType::E e): e(e), k(0), d(false), p(-1,-1) {}
+    explicit Event(EventType::E e): e(e), k(0), d(false), p(-1,-1), id(0), t(0) {}
     
     /**
      * Constructor for events without a position information
      * \param e event type
      */
     explicit Event(EventType::E e, EventDirection::D d)
-            : e(e), k(0), d(d==EventDirection::UP), p(-1,-1) {}
+            : e(e), k(0), d(d==EventDirection::UP), p(-1,-1), id(0), t(0) {}
 
     /**
      * Constructor for events that also carry a position information
      * \param e event type
      * \param p point
      */
-    Event(EventType::E e, Point p): e(e), k(0), d(false), p(p) {}
+    Event(EventType::E e, Point p): e(e), k(0), d(false), p(p), id(0), t(0) {}
     
     /**
      * Constructor for events that also carry a position information
@@ -104,14 +106,14 @@ public:
      * \param p point
      */
     Event(EventType::E e, Point p, EventDirection::D d)
-        : e(e), k(0), d(d==EventDirection::UP), p(p) {}
+        : e(e), k(0), d(d==EventDirection::UP), p(p), id(0), t(0) {}
     
     /**
      * Constructor for events that also carry a key information
      * \param e even type
      * \param k key data
      */
-    explicit Event(EventType::E e, char k): e(e), k(k), d(false), p(-1,-1) {} 
+    explicit Event(EventType::E e, char k): e(e), k(k), d(false), p(-1,-1), id(0), t(0) {}
 
     /**
      * \return the event information
@@ -146,13 +148,53 @@ public:
      */
     char getKey() const { return k; }
 
+    /**
+     * \return the time when the event was generated, in nanoseconds, with the
+     * same time base as getEventTime(), or zero if unknown
+     */
+    long long getTimestamp() const { return t; }
+
+    /**
+     * Set the time when the event was generated. Events are timestamped when
+     * they are queued, if they don't already have a timestamp
+     * \param timestamp time in nanoseconds, as returned by getEventTime()
+     */
+    void setTimestamp(long long timestamp) { t=timestamp; }
+
+    /**
+     * \return an id that identifies the event, assigned when the event is
+     * queued together with the timestamp, or zero if unknown
+     */
+    unsigned int getId() const { return id; }
+
+    /**
+     * Set the event id
+     * \param id new id, as returned by newEventId()
+     */
+    void setId(unsigned int id) { this->id=id; }
+
 private:
     EventType::E e;
     char k;
     bool d;
     Point p;
+    unsigned int id;
+    long long t;
 };
 
+/**
+ * \ingroup pub_iface_2
+ * \return the current time in nanoseconds from a monotonic clock. This is the
+ * time base of event timestamps and of window timers
+ */
+long long getEventTime();
+
+/**
+ * \ingroup pub_iface_2
+ * \return a new nonzero event id. Ids are unique till they wrap around
+ */
+unsigned int newEventId();
+
 class InputHandlerImpl; //Forward declaration
 
 /**
@@ -201,6 +243,44 @@ public:
      */
     std::function<void ()> registerEventCallback(std::function<void ()> cb);
 
+    /**
+     * Start recording the events returned by getEvent() and popEvent() to a
+     * file, as text with one event per line. Each line contains the time in
+     * microseconds since recording started, the event type, the point x and
+     * y, the direction and the key. Recording a replay is allowed.
+     * \param filename file where events are recorded, overwritten if existing
+     * \return true on success
+     */
+    bool startRecording(const char *filename);
+
+    /**
+     * Stop recording events and close the file
+     */
+    void stopRecording();
+
+    /**
+     * Replay events previously recorded with startRecording(). Events are
+     * replayed by a background thread and, until the replay ends, getEvent()
+     * and popEvent() return the replayed events while events from the input
+     * driver are discarded. An event is replayed only after the previous one
+     * has been consumed, so no event is lost even if the application is slow.
+     * \param filename file with the recorded events
+     * \param realTime if true, events are replayed with the same timing they
+     * were recorded, otherwise as fast as the application consumes them
+     * \return true on success
+     */
+    bool startReplay(const char *filename, bool realTime=true);
+
+    /**
+     * \return true if a replay is in progress
+     */
+    bool isReplaying();
+
+    /**
+     * Block until the replay in progress, if any, ends
+     */
+    void waitReplayEnd();
+
 private:
     /**
      * Class cannot be copied
@@ -209,8 +289,49 @@ private:
     InputHandler& operator= (const InputHandler&);
 
     InputHandler(InputHandlerImpl *impl);
+
+    /**
+     * Record an event, if recording
+     * \param e event, ignored if of type EventType::Default
+     */
+    void record(const Event& e);
+
+    /**
+     * Take the next event, must be called with the mutex locked. While
+     * replaying the events from the driver are taken and discarded
+     * \param e the event is returned here
+     * \return false if no event is available
+     */
+    bool takeEvent(Event& e);
+
+    /**
+     * Called when a driver event is available, wakes getEvent() and forwards
+     * it to the user callback if not replaying
+     */
+    void driverCallback();
+
+    /**
+     * Replay thread entry point
+     * \param arg pointer to the InputHandler
+     */
+    static void *replayLauncher(void *arg);
+
+    /**
+     * Replay events from replayFile, then close it
+     */
+    void replayThread();
     
     InputHandlerImpl *pImpl; //Implementation detal
+    pthread_mutex_t mutex;          ///< Protects the members below
+    pthread_cond_t cond;            ///< Signaled when an event is available
+    std::function<void ()> callback; ///< Callback registered by the user
+    FILE *recordFile;               ///< File being recorded, or nullptr
+    long long recordStart;          ///< Time when recording started
+    FILE *replayFile;               ///< File being replayed, or nullptr
+    bool realTime;                  ///< True if replaying in real time
+    bool replaying;                 ///< True if a replay is in progress
+    bool replayedValid;             ///< True if replayed is not yet consumed
+    Event replayed;                 ///< Replayed event, not yet consumed
 };
 
 } //namespace mxgui
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "latency_tracker.h"
+#include "pthread_lock.h"
+#include <algorithm>
+#include <cstdio>
+
+#if defined(MXGUI_LEVEL_2) && defined(MXGUI_ENABLE_LATENCY_TRACKING)
+
+using namespace std;
+
+namespace mxgui {
+
+//
+// class LatencyTracker
+//
+
+LatencyTracker& LatencyTracker::instance()
+{
+    static LatencyTracker singleton;
+    return singleton;
+}
+
+void LatencyTracker::addSample(unsigned int id, long long latency)
+{
+    PthreadLock lock(mutex);
+    ids[head]=id;
+    samples[head]=latency;
+    head=(head+1) % latencyBufferSize;
+    if(numSamples<latencyBufferSize) numSamples++;
+}
+
+long long LatencyTracker::percentile(unsigned int p)
+{
+    PthreadLock lock(mutex);
+    return percentileImpl(p);
+}
+
+unsigned int LatencyTracker::count()
+{
+    PthreadLock lock(mutex);
+    return numSamples;
+}
+
+void LatencyTracker::reset()
+{
+    PthreadLock lock(mutex);
+    head=numSamples=0;
+}
+
+void LatencyTracker::dump(function<void (const char *)> out)
+{
+    PthreadLock lock(mutex);
+    char line[128];
+    snprintf(line,sizeof(line),
+             "# samples=%u p50=%lldus p99=%lldus max=%lldus\n# id latency_us\n",
+             numSamples,percentileImpl(50)/1000,percentileImpl(99)/1000,
+             percentileImpl(100)/1000);
+    out(line);
+    unsigned int first=(head+latencyBufferSize-numSamples) % latencyBufferSize;
+    for(unsigned int i=0;i<numSamples;i++)
+    {
+        unsigned int j=(first+i) % latencyBufferSize;
+        snprintf(line,sizeof(line),"%u %lld\n",ids[j],samples[j]/1000);
+        out(line);
+    }
+}
+
+bool LatencyTracker::dumpToFile(const char *filename)
+{
+    FILE *f=fopen(filename,"w");
+    if(f==NULL) return false;
+    dump([f](const char *s){ fputs(s,f); });
+    return fclose(f)==0;
+}
+
+LatencyTracker::LatencyTracker() : head(0), numSamples(0)
+{
+    pthread_mutex_init(&mutex,NULL);
+}
+
+long long LatencyTracker::percentileImpl(unsigned int p)
+{
+    if(numSamples==0) return -1;
+    //Nearest rank method
+    unsigned int rank=(min(p,100u)*numSamples+99)/100;
+    if(rank>0) rank--;
+    copy(samples,samples+numSamples,sorted);
+    nth_element(sorted,sorted+rank,sorted+numSamples);
+    return sorted[rank];
+}
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2 && MXGUI_ENABLE_LATENCY_TRACKING
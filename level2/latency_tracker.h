@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <pthread.h>
+#include "mxgui_settings.h"
+
+#if defined(MXGUI_LEVEL_2) && defined(MXGUI_ENABLE_LATENCY_TRACKING)
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface_2
+ * Input to photon latency statistics. Only available if
+ * MXGUI_ENABLE_LATENCY_TRACKING is defined in mxgui_settings.h.
+ * When an event causes a drawable to be redrawn, the time from when the event
+ * was queued by the input driver to when the redraw has been flushed to the
+ * display by update() is recorded. The most recent latencyBufferSize samples
+ * are kept.
+ */
+class LatencyTracker
+{
+public:
+    /**
+     * \return an instance of the latency tracker (singleton)
+     */
+    static LatencyTracker& instance();
+
+    /**
+     * \internal
+     * Add a sample, called by the window event loop
+     * \param id id of the event that caused the redraw
+     * \param latency latency in nanoseconds
+     */
+    void addSample(unsigned int id, long long latency);
+
+    /**
+     * \param p percentile, from 0 to 100
+     * \return the p-th percentile of the recorded latencies in nanoseconds,
+     * or -1 if there are no samples
+     */
+    long long percentile(unsigned int p);
+
+    /**
+     * \return the 50th percentile of the latency, or -1 if no samples
+     */
+    long long p50() { return percentile(50); }
+
+    /**
+     * \return the 99th percentile of the latency, or -1 if no samples
+     */
+    long long p99() { return percentile(99); }
+
+    /**
+     * \return the number of samples recorded, at most latencyBufferSize
+     */
+    unsigned int count();
+
+    /**
+     * Discard all samples
+     */
+    void reset();
+
+    /**
+     * Dump a summary followed by the samples as text, one per line with the
+     * event id and the latency in microseconds
+     * \param out callback that is called multiple times with consecutive
+     * pieces of the output as nul terminated strings
+     */
+    void dump(std::function<void (const char *)> out);
+
+    /**
+     * Dump the summary and the samples to a file
+     * \param filename file name
+     * \return true on success
+     */
+    bool dumpToFile(const char *filename);
+
+private:
+    LatencyTracker(const LatencyTracker&)=delete;
+    LatencyTracker& operator=(const LatencyTracker&)=delete;
+
+    /**
+     * Constructor
+     */
+    LatencyTracker();
+
+    /**
+     * \return the p-th percentile. Needs the mutex locked
+     */
+    long long percentileImpl(unsigned int p);
+
+    pthread_mutex_t mutex;                    ///< To serialize access
+    unsigned int ids[latencyBufferSize];      ///< Event ids of the samples
+    long long samples[latencyBufferSize];     ///< Latencies in nanoseconds
+    long long sorted[latencyBufferSize];      ///< Scratch for percentiles
+    unsigned int head;                        ///< Next sample to be written
+    unsigned int numSamples;                  ///< Number of valid samples
+};
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2 && MXGUI_ENABLE_LATENCY_TRACKING
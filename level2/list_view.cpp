@@ -0,0 +1,314 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "list_view.h"
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef MXGUI_LEVEL_2
+
+using namespace std;
+
+namespace mxgui {
+
+/// Pixels a touch has to move before the list starts being dragged, so that
+/// taps are not mistaken for drags
+static const int dragThreshold=4;
+
+//
+// class ListDataSource
+//
+
+ListDataSource::~ListDataSource() {}
+
+//
+// class TextListDataSource
+//
+
+unsigned int TextListDataSource::getCount() { return count(); }
+
+short int TextListDataSource::getItemHeight(unsigned int)
+{
+    return itemHeight;
+}
+
+void TextListDataSource::drawItem(DrawingContextProxy& dc, unsigned int index,
+        Point p, Point a, Point b, bool selected)
+{
+    pair<Color,Color> colors=dc.getTextColor();
+    if(selected) dc.setTextColor(make_pair(colors.second,colors.first));
+    Color bg=dc.getTextColor().second;
+    string s=text(index);
+    short int h=dc.getFont().getHeight();
+    short int y=p.y()+max(0,(itemHeight-h)/2);
+    short int y0=max(y,a.y());
+    short int y1=min<short>(y+h-1,b.y());
+    short int x1=a.x()-1; //Last column drawn by the text
+    if(y0<=y1)
+    {
+        short int w=dc.getFont().calculateLength(s.c_str());
+        x1=min<short>(p.x()+w-1,b.x());
+        if(x1>=a.x())
+            dc.clippedWrite(Point(p.x(),y),Point(a.x(),y0),
+                            Point(x1,y1),s.c_str());
+        if(x1<b.x()) dc.clear(Point(x1+1,y0),Point(b.x(),y1),bg);
+    } else {
+        y0=b.y()+1;
+        y1=b.y();
+    }
+    //Fill above and below the text
+    if(a.y()<y0) dc.clear(a,Point(b.x(),min<short>(y0-1,b.y())),bg);
+    if(y1<b.y()) dc.clear(Point(a.x(),max<short>(y1+1,a.y())),b,bg);
+    if(selected) dc.setTextColor(colors);
+}
+
+//
+// class ListView
+//
+
+ListView::ListView(Window *w, DrawArea da, ListDataSource *source)
+    : Drawable(w,da), source(source), topIndex(0), topOffset(0),
+      pendingScroll(0), fullRedraw(true), selected(-1), dragging(false),
+      dragged(false), dragStart(0), dragLast(0)
+{
+    changed[0]=changed[1]=-1;
+    enqueueForRedraw();
+}
+
+void ListView::setDataSource(ListDataSource *source)
+{
+    this->source=source;
+    topIndex=0;
+    topOffset=0;
+    selected=-1;
+    dataChanged();
+}
+
+void ListView::dataChanged()
+{
+    unsigned int count=source ? source->getCount() : 0;
+    if(selected>=static_cast<int>(count)) selected=-1;
+    if(topIndex>=count)
+    {
+        topIndex=count>0 ? count-1 : 0;
+        topOffset=0;
+    } else topOffset=min<int>(topOffset,source->getItemHeight(topIndex)-1);
+    //If items were removed at the end, scroll back to keep the list filled
+    DrawArea da=getDrawArea();
+    int height=da.second.y()-da.first.y()+1;
+    int below=contentBelow(height);
+    if(below<height) scroll(below-height);
+    pendingScroll=0;
+    changed[0]=changed[1]=-1;
+    fullRedraw=true;
+    enqueueForRedraw();
+}
+
+void ListView::scroll(int dy)
+{
+    if(source==nullptr || dy==0) return;
+    if(dy>0)
+    {
+        DrawArea da=getDrawArea();
+        int height=da.second.y()-da.first.y()+1;
+        dy=min(dy,max(0,contentBelow(height+dy)-height));
+        topOffset+=dy;
+        unsigned int count=source->getCount();
+        while(topIndex+1<count && topOffset>=source->getItemHeight(topIndex))
+            topOffset-=source->getItemHeight(topIndex++);
+    } else {
+        int offset=topOffset+dy;
+        while(offset<0 && topIndex>0)
+            offset+=source->getItemHeight(--topIndex);
+        if(offset<0)
+        {
+            //Reached the first item
+            dy-=offset;
+            offset=0;
+        }
+        topOffset=offset;
+    }
+    if(dy==0) return;
+    pendingScroll+=dy;
+    enqueueForRedraw();
+}
+
+void ListView::scrollToItem(unsigned int index)
+{
+    if(source==nullptr) return;
+    unsigned int count=source->getCount();
+    if(count==0) return;
+    topIndex=min(index,count-1);
+    topOffset=0;
+    DrawArea da=getDrawArea();
+    int height=da.second.y()-da.first.y()+1;
+    int below=contentBelow(height);
+    if(below<height) scroll(below-height);
+    pendingScroll=0;
+    fullRedraw=true;
+    enqueueForRedraw();
+}
+
+void ListView::setSelected(int index)
+{
+    if(index==selected) return;
+    int items[2]={selected,index};
+    selected=index;
+    for(int i=0;i<2;i++)
+    {
+        if(items[i]<0 || items[i]==changed[0] || items[i]==changed[1]) continue;
+        if(changed[0]<0) changed[0]=items[i];
+        else if(changed[1]<0) changed[1]=items[i];
+        else fullRedraw=true; //Too many changes before the list was drawn
+    }
+    enqueueForRedraw();
+}
+
+void ListView::onDraw(DrawingContextProxy& dc)
+{
+    DrawArea da=getDrawArea();
+    int height=da.second.y()-da.first.y()+1;
+    int dy=pendingScroll;
+    bool full=fullRedraw || needsFullRedraw() || abs(dy)>=height;
+    pendingScroll=0;
+    fullRedraw=false;
+    //Move what is still visible, if the display does not support it the
+    //whole list is drawn
+    if(full==false && dy>0)
+        full=!dc.copyArea(Point(da.first.x(),da.first.y()+dy),da.second,
+                          da.first);
+    else if(full==false && dy<0)
+        full=!dc.copyArea(da.first,Point(da.second.x(),da.second.y()+dy),
+                          Point(da.first.x(),da.first.y()-dy));
+    if(full) drawLines(dc,da.first.y(),da.second.y());
+    else {
+        //Draw only the lines exposed by scrolling and the changed items
+        if(dy>0) drawLines(dc,da.second.y()-dy+1,da.second.y());
+        else if(dy<0) drawLines(dc,da.first.y(),da.first.y()-dy-1);
+        for(int i=0;i<2;i++) if(changed[i]>=0) drawItem(dc,changed[i]);
+    }
+    changed[0]=changed[1]=-1;
+}
+
+void ListView::onEvent(Event e)
+{
+    DrawArea da=getDrawArea();
+    Point p=e.getPoint();
+    switch(e.getEvent())
+    {
+        case EventType::TouchDown:
+            if(within(p,da.first,da.second)==false) return;
+            dragging=true;
+            dragged=false;
+            dragStart=dragLast=p.y();
+            break;
+        case EventType::TouchMove:
+            if(dragging==false) return;
+            if(dragged==false && abs(p.y()-dragStart)<dragThreshold) return;
+            dragged=true;
+            scroll(dragLast-p.y());
+            dragLast=p.y();
+            break;
+        case EventType::TouchUp:
+        {
+            if(dragging==false) return;
+            dragging=false;
+            if(dragged || within(p,da.first,da.second)==false) return;
+            int index=itemAt(p.y());
+            if(index<0) return;
+            setSelected(index);
+            if(callback) callback();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ListView::drawLines(DrawingContextProxy& dc, short int y0, short int y1)
+{
+    DrawArea da=getDrawArea();
+    unsigned int count=source ? source->getCount() : 0;
+    int y=da.first.y()-topOffset;
+    for(unsigned int i=topIndex;i<count && y<=y1;i++)
+    {
+        int h=source->getItemHeight(i);
+        if(y+h-1>=y0)
+            source->drawItem(dc,i,Point(da.first.x(),y),
+                             Point(da.first.x(),max<int>(y,y0)),
+                             Point(da.second.x(),min<int>(y+h-1,y1)),
+                             static_cast<int>(i)==selected);
+        y+=h;
+    }
+    //Clear the area after the last item
+    if(y<=y1) dc.clear(Point(da.first.x(),max<int>(y,y0)),Point(da.second.x(),y1),
+                       dc.getTextColor().second);
+}
+
+void ListView::drawItem(DrawingContextProxy& dc, unsigned int index)
+{
+    if(source==nullptr || index<topIndex || index>=source->getCount()) return;
+    DrawArea da=getDrawArea();
+    int y=da.first.y()-topOffset;
+    for(unsigned int i=topIndex;i<index && y<=da.second.y();i++)
+        y+=source->getItemHeight(i);
+    if(y>da.second.y()) return;
+    int h=source->getItemHeight(index);
+    source->drawItem(dc,index,Point(da.first.x(),y),
+                     Point(da.first.x(),max<int>(y,da.first.y())),
+                     Point(da.second.x(),min<int>(y+h-1,da.second.y())),
+                     static_cast<int>(index)==selected);
+}
+
+int ListView::contentBelow(int limit)
+{
+    if(source==nullptr) return 0;
+    unsigned int count=source->getCount();
+    int result=-topOffset;
+    for(unsigned int i=topIndex;i<count && result<limit;i++)
+        result+=source->getItemHeight(i);
+    return max(0,min(result,limit));
+}
+
+int ListView::itemAt(short int y)
+{
+    if(source==nullptr) return -1;
+    DrawArea da=getDrawArea();
+    unsigned int count=source->getCount();
+    int top=da.first.y()-topOffset;
+    for(unsigned int i=topIndex;i<count && top<=da.second.y();i++)
+    {
+        int h=source->getItemHeight(i);
+        if(y<top+h) return i;
+        top+=h;
+    }
+    return -1;
+}
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2
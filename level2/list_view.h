@@ -0,0 +1,251 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <functional>
+#include "mxgui_settings.h"
+#include "application.h"
+
+#ifdef MXGUI_LEVEL_2
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface_2
+ * Interface through which a ListView gets its items. Items are not stored in
+ * the list, so lists with a large number of items only need memory for what
+ * the data source needs to produce them.
+ */
+class ListDataSource
+{
+public:
+    /**
+     * \return the number of items
+     */
+    virtual unsigned int getCount()=0;
+
+    /**
+     * \param index index of an item, from 0 to getCount()-1
+     * \return the item height in pixels, must be greater than zero
+     */
+    virtual short int getItemHeight(unsigned int index)=0;
+
+    /**
+     * Draw an item. The item is as wide as the list, and only the part within
+     * the clipping rectangle must be drawn, painting it completely
+     * \param dc drawing context
+     * \param index index of the item to draw
+     * \param p upper left corner of the item, can be outside the clipping
+     * rectangle if the item is partially visible
+     * \param a upper left corner of the clipping rectangle
+     * \param b lower right corner of the clipping rectangle
+     * \param selected true if the item is selected
+     */
+    virtual void drawItem(DrawingContextProxy& dc, unsigned int index,
+                          Point p, Point a, Point b, bool selected)=0;
+
+    /**
+     * Destructor
+     */
+    virtual ~ListDataSource();
+};
+
+/**
+ * \ingroup pub_iface_2
+ * A data source whose items are lines of text produced by a callback, and
+ * that all have the same height
+ */
+class TextListDataSource : public ListDataSource
+{
+public:
+    /**
+     * Constructor
+     * \param count callback returning the number of items
+     * \param text callback returning the text of an item given its index
+     * \param itemHeight height of the items
+     */
+    TextListDataSource(std::function<unsigned int ()> count,
+                       std::function<std::string (unsigned int)> text,
+                       short int itemHeight=20)
+        : count(count), text(text), itemHeight(itemHeight) {}
+
+    /**
+     * \return the number of items
+     */
+    virtual unsigned int getCount();
+
+    /**
+     * \param index index of an item
+     * \return the item height in pixels
+     */
+    virtual short int getItemHeight(unsigned int index);
+
+    /**
+     * Draw an item as a line of text, vertically centered. Selected items
+     * are drawn swapping the foreground and background colors
+     */
+    virtual void drawItem(DrawingContextProxy& dc, unsigned int index,
+                          Point p, Point a, Point b, bool selected);
+
+private:
+    std::function<unsigned int ()> count; ///< Returns the number of items
+    std::function<std::string (unsigned int)> text; ///< Returns item text
+    short int itemHeight; ///< Height of the items
+};
+
+/**
+ * \ingroup pub_iface_2
+ * A scrollable list whose items are provided by a ListDataSource. Memory and
+ * drawing time are proportional to the visible items only. When the list is
+ * scrolled the visible part is moved with Display::copyArea() and only the
+ * newly exposed items are drawn, if the display supports it. Items can have
+ * different heights. The list is scrolled by dragging it, and an item is
+ * selected by tapping it.
+ */
+class ListView : public Drawable
+{
+public:
+    /**
+     * Constructor
+     * The object will be immediately enqueued for redraw
+     * \param w window to which this object belongs
+     * \param da area on screen occupied by this object
+     * \param source data source, may be nullptr
+     */
+    ListView(Window *w, DrawArea da, ListDataSource *source=nullptr);
+
+    /**
+     * Change the data source, the list is scrolled back to the first item
+     * \param source new data source, may be nullptr
+     */
+    void setDataSource(ListDataSource *source);
+
+    /**
+     * Must be called when the items of the data source change, to redraw the
+     * list
+     */
+    void dataChanged();
+
+    /**
+     * Scroll the list. Scrolling stops at the first and last item
+     * \param dy pixels to scroll, positive values show the following items
+     */
+    void scroll(int dy);
+
+    /**
+     * Scroll the list so that an item is the first visible one, or as close
+     * as possible if near the end of the list
+     * \param index item index
+     */
+    void scrollToItem(unsigned int index);
+
+    /**
+     * \return the index of the first, possibly partially, visible item
+     */
+    unsigned int getFirstVisibleItem() const { return topIndex; }
+
+    /**
+     * Select an item
+     * \param index item index, or -1 to remove the selection
+     */
+    void setSelected(int index);
+
+    /**
+     * \return the index of the selected item, or -1 if none
+     */
+    int getSelected() const { return selected; }
+
+    /**
+     * Set the callback to be called when an item is selected by tapping it
+     */
+    void setCallback(std::function<void ()> callback)
+    {
+        swap(this->callback,callback);
+    }
+
+    /**
+     * \internal
+     * Overridden this member function to draw the object.
+     * \param dc drawing context used to draw the object
+     */
+    virtual void onDraw(DrawingContextProxy& dc);
+
+    /**
+     * \internal
+     * Overridden this member function to handle the events.
+     * \param e event to be handled
+     */
+    virtual void onEvent(Event e);
+
+private:
+    /**
+     * Draw the items intersecting a range of lines of the list
+     * \param dc drawing context
+     * \param y0 first line to draw
+     * \param y1 last line to draw
+     */
+    void drawLines(DrawingContextProxy& dc, short int y0, short int y1);
+
+    /**
+     * Redraw a single item, if visible
+     * \param dc drawing context
+     * \param index item index
+     */
+    void drawItem(DrawingContextProxy& dc, unsigned int index);
+
+    /**
+     * \param limit stop counting at limit pixels
+     * \return the height of the content from the top of the list to the end
+     * of the last item, or limit if greater
+     */
+    int contentBelow(int limit);
+
+    /**
+     * \param y screen y coordinate within the list
+     * \return the index of the item at that coordinate, or -1 if none
+     */
+    int itemAt(short int y);
+
+    ListDataSource *source;          ///< Data source
+    unsigned int topIndex;           ///< First visible item
+    int topOffset;                   ///< Pixels of the first item hidden
+    int pendingScroll;               ///< Scrolled pixels not yet drawn
+    bool fullRedraw;                 ///< True if the whole list must be drawn
+    int selected;                    ///< Selected item, or -1
+    int changed[2];                  ///< Items to redraw, or -1
+    bool dragging;                   ///< True if touch is dragging the list
+    bool dragged;                    ///< True if the drag scrolled the list
+    short int dragStart;             ///< Coordinate where the drag started
+    short int dragLast;              ///< Coordinate of last drag event
+    std::function<void ()> callback; ///< Called when an item is selected
+};
+
+} //namespace mxgui
+
+#endif //MXGUI_LEVEL_2
@@ -29,6 +29,8 @@
 #ifdef MXGUI_LEVEL_2
 
 #include <utility>
+#include <algorithm>
+#include "shapes.h"
 
 using namespace std;
 
@@ -108,16 +110,17 @@ string RadioButton::getLabel()
 void RadioButton::onDraw(DrawingContextProxy& dc)
 {
     DrawArea da=getDrawArea();
-    dc.clear(da.first,da.second,colors.second);
-    dc.drawImage(da.first,tl);
-    dc.drawImage(Point(da.second.x()-2,da.first.y()),tr);
-    dc.drawImage(Point(da.first.x(),da.second.y()-2),bl);
-    dc.drawImage(innerPointBr,br);
-    dc.drawRectangle(innerPointTl,innerPointBr,black);
-    if(isChecked())
-    {
-        dc.clear(innerPointTl,innerPointBr,black);
-    }
+    Color bg=getWindow()->getPreferences().background;
+    dc.clear(da.first,da.second,bg);
+    short r=min(da.second.x()-da.first.x(),da.second.y()-da.first.y())/2;
+    Point c(da.first.x()+r,da.first.y()+r);
+    fillCircle(dc,c,r,black,bg);
+    fillCircle(dc,c,r-1,colors.second,black);
+    if(isChecked()==false) return;
+    //Keep a 3 pixel gap around the dot, but shrink it proportionally when the
+    //button is too small for that, so the radius never drops below 1
+    short dot=max<short>(1,max<short>(r/2,r-4));
+    fillCircle(dc,c,dot,black,colors.second);
 }
 
 }//namespace mxgui
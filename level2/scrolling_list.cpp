@@ -25,11 +25,11 @@
  *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
  ***************************************************************************/
 
-#ifdef MXGUI_LEVEL_2
-
 #include "scrolling_list.h"
 #include <utility>
-#include <chrono>
+#include <algorithm>
+
+#ifdef MXGUI_LEVEL_2
 
 #define scrollAreaTLPoint Point(listArea.second.x(),listArea.first.y()+buttonHeight)
 #define scrollAreaBRPoint Point(listArea.second.x()+buttonHeight,listArea.second.y()-buttonHeight)
@@ -42,7 +42,7 @@ ScrollingList::ScrollingList(Window* w,Point start, int nItems,int width,int but
 {
     this->buttonHeight=buttonHeight;
     this->itemHeight=itemHeight;
-    this->scrollingThread=nullptr;
+    this->scrollingTimer=0;
     scrolling=false;
     DrawArea da = getDrawArea();
     listArea = DrawArea(da.first,Point(da.second.x()-buttonHeight-1,da.second.y()));
@@ -53,46 +53,19 @@ ScrollingList::ScrollingList(Window* w,Point start, int nItems,int width,int but
     up = new ScrollButton(w,upButtonPoint,ScrollButtonType::UP,buttonHeight);
     up->setDownCallback([this](){
         this->upOne();
-        if(this->scrollingThread!=nullptr)
-        {
-            this->scrollingThread->join();
-            delete this->scrollingThread;
-            this->scrollingThread=nullptr;
-        }
-        scrollingThread = new thread( &ScrollingList::keepScrollingUp, this);
-
-
+        this->keepScrolling(up,true);
     });
     up->setCallback([this](){
-
-        if(this->scrollingThread!=nullptr)
-        {
-            this->scrollingThread->join();
-            delete this->scrollingThread;
-            this->scrollingThread=nullptr;
-        }
+        this->stopScrolling();
     });
     scroll = new ScrollButton(w,DrawArea(scrollAreaTLPoint,scrollAreaBRPoint),ScrollButtonType::SCROLL);
     down = new ScrollButton(w,downButtonPoint,ScrollButtonType::DOWN,buttonHeight);
     down->setDownCallback([this](){
         this->downOne();
-        if(this->scrollingThread!=nullptr)
-        {
-            this->scrollingThread->join();
-            delete this->scrollingThread;
-            this->scrollingThread=nullptr;
-        }
-        scrollingThread = new thread( &ScrollingList::keepScrollingDown, this);
-
+        this->keepScrolling(down,false);
     });
     down->setCallback([this](){
-
-        if(this->scrollingThread!=nullptr)
-        {
-            this->scrollingThread->join();
-            delete this->scrollingThread;
-            this->scrollingThread=nullptr;
-        }
+        this->stopScrolling();
     });
     items = vector<string>();
     visibleItems=vector<ItemLabel*>();
@@ -119,63 +92,23 @@ void ScrollingList::upOne()
     }
 }
 
-void ScrollingList::keepScrollingUp()
+void ScrollingList::keepScrolling(ScrollButton *button, bool upwards)
 {
-    int i=0;
-    while(i<500)
-    {
-        if(!up->isPressed())
-        {
-            return;
-        }
-        i++;
-        this_thread::sleep_for(chrono::milliseconds(1));
-    }
-
-    while(up->isPressed())
-    {
-        upOne();
-        i=0;
-        while(i<100)
-        {
-            if(!up->isPressed())
-            {
-                return;
-            }
-            i++;
-            this_thread::sleep_for(chrono::milliseconds(1));
-        }
-    }
+    stopScrolling();
+    //Start repeating after the button has been held for a while, the timer
+    //runs in the event loop thread, so no locking is needed
+    scrollingTimer=getWindow()->addTimer(500,[this,button,upwards](){
+        if(button->isPressed()==false) stopScrolling();
+        else if(upwards) upOne();
+        else downOne();
+    },100);
 }
 
-void ScrollingList::keepScrollingDown()
+void ScrollingList::stopScrolling()
 {
-    int i=0;
-    while(i<500)
-    {
-        if(!down->isPressed())
-        {
-            return;
-        }
-        i++;
-        this_thread::sleep_for(chrono::milliseconds(1));
-    }
-
-    while(down->isPressed())
-    {
-        downOne();
-        i=0;
-        while(i<100)
-        {
-            if(!down->isPressed())
-            {
-                return;
-            }
-            i++;
-            this_thread::sleep_for(chrono::milliseconds(1));
-        }
-
-    }
+    if(scrollingTimer==0) return;
+    getWindow()->cancelTimer(scrollingTimer);
+    scrollingTimer=0;
 }
 
 void ScrollingList::downOne()
@@ -198,7 +131,7 @@ void ScrollingList::addItem(const string& text)
 void ScrollingList::onDraw(DrawingContextProxy& dc)
 {
     dc.clear(scrollAreaTLPoint,scrollAreaBRPoint,grey);
-    for(int index=0;index<visibleItems.size() ;index++)
+    for(unsigned int index=0;index<visibleItems.size();index++)
     {
         string item;
         Label* curr = visibleItems.at(index);
@@ -301,9 +234,11 @@ void ScrollingList::onEvent(Event e)
 
 void ScrollingList::pageDown()
 {
-    int temp=firstVisibleIndex+visibleItems.size();
-    if(temp>items.size()-visibleItems.size())
-        temp=items.size()-visibleItems.size();
+    int numVisible=static_cast<int>(visibleItems.size());
+    int lastFirst=max(0,static_cast<int>(items.size())-numVisible);
+    int temp=firstVisibleIndex+numVisible;
+    if(temp>lastFirst)
+        temp=lastFirst;
 
     firstVisibleIndex=temp;
     updateScrollButton();
@@ -312,7 +247,7 @@ void ScrollingList::pageDown()
 
 void ScrollingList::pageUp()
 {
-    int temp=firstVisibleIndex-visibleItems.size();
+    int temp=firstVisibleIndex-static_cast<int>(visibleItems.size());
     if(temp<0)
         temp=0;
     firstVisibleIndex=temp;
@@ -353,6 +288,11 @@ void ScrollingList::updateScrollButton()
     }
 }
 
+ScrollingList::~ScrollingList()
+{
+    stopScrolling();
+}
+
 } //namespace mxgui
 
 #endif //MXGUI_LEVEL_2
@@ -28,7 +28,6 @@
 #pragma once
 
 #include "button.h"
-#include <thread>
 
 #define innerPointTr Point(innerPointBr.x(),innerPointTl.y())
 #define innerPointBl Point(innerPointTl.x(),innerPointBr.y())
@@ -285,6 +284,11 @@ public:
      */
     std::string getSelected();
 
+    /**
+     * Destructor
+     */
+    ~ScrollingList();
+
 private:
     /**
      * Selects an item
@@ -300,8 +304,13 @@ private:
     bool checkArea(Event e,DrawArea da);
 
     void upOne(); ///< Scroll up one item
-    void keepScrollingUp(); ///< Keep scrolling up
-    void keepScrollingDown(); ///< Keep scrolling down
+    /**
+     * Keep scrolling while a button is held down
+     * \param button button being held
+     * \param upwards true to scroll up, false to scroll down
+     */
+    void keepScrolling(ScrollButton *button, bool upwards);
+    void stopScrolling(); ///< Stop scrolling started by keepScrolling()
     void downOne(); ///< Scroll down one item
     void pageDown(); ///< Scroll down a page
     void pageUp(); ///< Scroll up a page
@@ -313,7 +322,7 @@ private:
     int buttonHeight;///< Height of the buttons
     int itemHeight;///< Height of the items
     bool scrolling;///< True if the scroll button is being dragged
-    std::thread *scrollingThread;///< Thread to keep scrolling
+    unsigned int scrollingTimer;///< Timer to keep scrolling, zero if none
     DrawArea listArea; ///< Area of the list
     std::vector<ItemLabel*> visibleItems; ///< Labels of the visible items
     std::vector<std::string> items; ///< Items of the list
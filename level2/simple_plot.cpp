@@ -29,7 +29,6 @@
 #include "display_state_saver.h"
 #include <cmath>
 #include <limits>
-#include <sstream>
 
 using namespace std;
 
@@ -100,9 +99,10 @@ void SimplePlot::draw(DrawingContext& dc, const vector<Dataset>& dataset, bool f
         //TODO: avoid clearing
         dc.clear(Point(upperLeft.x(),lowerRight.y()-ticksXspace-fh),
                  Point(upperLeft.x()+ticksYspace,lowerRight.y()+ticksXspace),background);
-        string xt=number(ymin);
-        dc.write(Point(upperLeft.x()+ticksYspace-font.calculateLength(xt.c_str()),
-                       lowerRight.y()-ticksXspace-fh),xt.c_str());
+        char xt[numberSize];
+        number(xt,ymin);
+        dc.write(Point(upperLeft.x()+ticksYspace-font.calculateLength(xt),
+                       lowerRight.y()-ticksXspace-fh),xt);
     }
     if(fullRedraw || ymax!=prevYmax)
     {
@@ -110,17 +110,19 @@ void SimplePlot::draw(DrawingContext& dc, const vector<Dataset>& dataset, bool f
         //TODO: avoid clearing
         dc.clear(upperLeft,
                  Point(upperLeft.x()+ticksYspace,upperLeft.y()+fh),background);
-        string xt=number(ymax);
-        dc.write(Point(upperLeft.x()+ticksYspace-font.calculateLength(xt.c_str()),
-                       upperLeft.y()),xt.c_str());
+        char xt[numberSize];
+        number(xt,ymax);
+        dc.write(Point(upperLeft.x()+ticksYspace-font.calculateLength(xt),
+                       upperLeft.y()),xt);
     }
     //TODO: For now always redraw X ticks max
     //TODO: avoid clearing
     dc.clear(Point(lowerRight.x()-ticksYspace,lowerRight.y()-fh),
              lowerRight,background);
-    string xt=number(numElem>2 ? numElem-1 : 1);
-    dc.write(Point(lowerRight.x()-font.calculateLength(xt.c_str()),lowerRight.y()-fh),
-             xt.c_str());
+    char xt[numberSize];
+    number(xt,numElem>2 ? numElem-1 : 1);
+    dc.write(Point(lowerRight.x()-font.calculateLength(xt),lowerRight.y()-fh),
+             xt);
     
     //Plot drawing area
     const int x1=upperLeft.x()+ticksYspace+whitespaceBeforeTicks+ticksLength+2;
@@ -235,12 +237,297 @@ void SimplePlot::draw(DrawingContext& dc, const vector<Dataset>& dataset, bool f
     first=false;
 }
 
-string SimplePlot::number(float num)
+void SimplePlot::number(char *buffer, float num)
 {
-    ostringstream ss;
-    ss.precision(2);
-    ss<<num;
-    return ss.str();
+    NumericField::formatCompact(buffer,numberSize-1,num,2);
+}
+
+//
+// class StreamingTrace
+//
+
+const unsigned int StreamingTrace::blockSize;
+
+StreamingTrace::StreamingTrace(unsigned int capacity, Color color)
+    : color(color),
+      data(max(1u,(capacity+blockSize-1)/blockSize)*blockSize),
+      blockMin(data.size()/blockSize), blockMax(data.size()/blockSize)
+{
+    clear();
+}
+
+void StreamingTrace::append(float sample)
+{
+    unsigned int b=head/blockSize;
+    //The first sample written in a block starts its min/max anew, as until
+    //the block is completely rewritten ranges can only partially include it,
+    //and partially included blocks are scanned sample by sample
+    if(head % blockSize==0)
+    {
+        blockMin[b]=numeric_limits<float>::infinity();
+        blockMax[b]=-numeric_limits<float>::infinity();
+        //The block that was current is complete, and the samples of this one
+        //are being discarded, update the range of the other blocks
+        restMin=numeric_limits<float>::infinity();
+        restMax=-numeric_limits<float>::infinity();
+        for(unsigned int i=0;i<blockMin.size();i++)
+        {
+            if(i==b) continue;
+            restMin=min(restMin,blockMin[i]);
+            restMax=max(restMax,blockMax[i]);
+        }
+    }
+    if(!isnan(sample))
+    {
+        blockMin[b]=min(blockMin[b],sample);
+        blockMax[b]=max(blockMax[b],sample);
+    }
+    data[head]=sample;
+    if(++head>=data.size()) head=0;
+    if(count<data.size()) count++;
+    total++;
+}
+
+void StreamingTrace::append(const float *samples, unsigned int n)
+{
+    for(unsigned int i=0;i<n;i++) append(samples[i]);
+}
+
+void StreamingTrace::clear()
+{
+    head=count=0;
+    total=0;
+    fill(blockMin.begin(),blockMin.end(),numeric_limits<float>::infinity());
+    fill(blockMax.begin(),blockMax.end(),-numeric_limits<float>::infinity());
+    restMin=numeric_limits<float>::infinity();
+    restMax=-numeric_limits<float>::infinity();
+}
+
+bool StreamingTrace::minMax(unsigned int first, unsigned int last,
+        float& lo, float& hi) const
+{
+    last=min(last,count);
+    lo=numeric_limits<float>::infinity();
+    hi=-numeric_limits<float>::infinity();
+    if(first==0 && last==count && count>0)
+    {
+        //The whole buffer is the current block, that is the one with the
+        //newest sample, and all the others. When the current block is only
+        //partially rewritten, its oldest samples are scanned
+        unsigned int newest= head>0 ? head-1 : data.size()-1;
+        lo=min(restMin,blockMin[newest/blockSize]);
+        hi=max(restMax,blockMax[newest/blockSize]);
+        if(head % blockSize!=0 && count==data.size())
+        {
+            unsigned int end=(head/blockSize+1)*blockSize;
+            for(unsigned int p=head;p<end;p++)
+            {
+                if(isnan(data[p])) continue;
+                lo=min(lo,data[p]);
+                hi=max(hi,data[p]);
+            }
+        }
+        return lo<=hi;
+    }
+    for(unsigned int i=first;i<last;)
+    {
+        unsigned int p=physical(i);
+        if(p % blockSize==0 && last-i>=blockSize)
+        {
+            //A whole block is within the range
+            lo=min(lo,blockMin[p/blockSize]);
+            hi=max(hi,blockMax[p/blockSize]);
+            i+=blockSize;
+        } else {
+            float sample=data[p];
+            if(!isnan(sample))
+            {
+                lo=min(lo,sample);
+                hi=max(hi,sample);
+            }
+            i++;
+        }
+    }
+    return lo<=hi;
+}
+
+//
+// class StreamingPlot
+//
+
+const int StreamingPlot::sweepGap;
+
+StreamingPlot::StreamingPlot(Point upperLeft, Point lowerRight)
+    : background(black), upperLeft(upperLeft), lowerRight(lowerRight),
+      column(max(0,lowerRight.y()-upperLeft.y()+1)), mode(FIT),
+      samplesPerColumn(1), autoRange(true), first(true), ymin(0.f), ymax(1.f),
+      drawnYmin(0.f), drawnYmax(1.f), nextColumn(0) {}
+
+void StreamingPlot::addTrace(const StreamingTrace& trace)
+{
+    traces.push_back(&trace);
+    prevSpans.push_back(make_pair(-1,-1));
+    first=true;
+}
+
+void StreamingPlot::setMode(Mode mode, unsigned int samplesPerColumn)
+{
+    this->mode=mode;
+    this->samplesPerColumn=max(1u,samplesPerColumn);
+    first=true;
+}
+
+void StreamingPlot::setRange(float ymin, float ymax)
+{
+    this->ymin=ymin;
+    this->ymax=ymax;
+    autoRange=false;
+}
+
+void StreamingPlot::draw(DrawingContext& dc, bool fullRedraw)
+{
+    const int x1=upperLeft.x();
+    const int y1=upperLeft.y();
+    const int x2=lowerRight.x();
+    const int y2=lowerRight.y();
+    const int width=x2-x1+1;
+    if(traces.empty() || width<=0 || y2<y1) return;
+
+    if(autoRange)
+    {
+        bool valid=false;
+        float lo=numeric_limits<float>::infinity();
+        float hi=-numeric_limits<float>::infinity();
+        for(unsigned int i=0;i<traces.size();i++)
+        {
+            float tlo,thi;
+            if(traces[i]->minMax(0,traces[i]->size(),tlo,thi)==false) continue;
+            lo=min(lo,tlo);
+            hi=max(hi,thi);
+            valid=true;
+        }
+        if(valid)
+        {
+            ymin=lo;
+            ymax=hi;
+        }
+    }
+    if(first || ymin!=drawnYmin || ymax!=drawnYmax) fullRedraw=true;
+    first=false;
+    drawnYmin=ymin;
+    drawnYmax=ymax;
+
+    unsigned long long total=totalSamples();
+    if(mode==FIT)
+    {
+        //Every new sample changes all columns, so always draw all of them
+        unsigned long long n=total;
+        for(unsigned int i=0;i<traces.size();i++)
+            n=min<unsigned long long>(n,traces[i]->size());
+        unsigned long long start=total-n;
+        fill(prevSpans.begin(),prevSpans.end(),make_pair(-1,-1));
+        for(int x=0;x<width;x++)
+        {
+            unsigned long long a=start+x*n/width;
+            unsigned long long b=start+(x+1)*n/width;
+            if(a==b && n>0) b=a+1; //Less samples than columns
+            drawColumn(dc,x1+x,a,b);
+        }
+        return;
+    }
+
+    unsigned long long endColumn=total/samplesPerColumn;
+    unsigned long long startColumn=endColumn>static_cast<unsigned>(width) ?
+        endColumn-width : 0;
+    if(nextColumn>endColumn) fullRedraw=true; //Traces have been cleared
+    if(fullRedraw==false)
+    {
+        if(endColumn==nextColumn) return;
+        unsigned long long shift=endColumn-nextColumn;
+        if(shift>=static_cast<unsigned>(width)) fullRedraw=true;
+        else if(mode==SCROLL)
+        {
+            //Move the columns already drawn to the left
+            if(dc.copyArea(Point(x1+shift,y1),lowerRight,upperLeft))
+                startColumn=nextColumn;
+            else fullRedraw=true;
+        } else startColumn=nextColumn;
+    }
+    if(fullRedraw) fill(prevSpans.begin(),prevSpans.end(),make_pair(-1,-1));
+    for(unsigned long long c=startColumn;c<endColumn;c++)
+    {
+        int x=mode==SCROLL ? x2-static_cast<int>(endColumn-1-c)
+                           : x1+static_cast<int>(c % width);
+        drawColumn(dc,x,c*samplesPerColumn,(c+1)*samplesPerColumn);
+    }
+    int drawn=endColumn-startColumn;
+    if(mode==SCROLL)
+    {
+        if(fullRedraw && drawn<width)
+            dc.clear(upperLeft,Point(x2-drawn,y2),background);
+    } else {
+        if(fullRedraw && endColumn<static_cast<unsigned>(width))
+            dc.clear(Point(x1+endColumn,y1),lowerRight,background);
+        //Clear some columns ahead of the cursor, to make it visible
+        for(int i=0;i<sweepGap && i<width;i++)
+        {
+            int x=x1+static_cast<int>((endColumn+i) % width);
+            dc.line(Point(x,y1),Point(x,y2),background);
+        }
+    }
+    nextColumn=endColumn;
+}
+
+void StreamingPlot::drawColumn(DrawingContext& dc, int x,
+        unsigned long long first, unsigned long long last)
+{
+    const int h=column.size();
+    const float range=ymax>ymin ? ymax-ymin : 1.f;
+    fill(column.begin(),column.end(),background);
+    for(unsigned int i=0;i<traces.size();i++)
+    {
+        const StreamingTrace *t=traces[i];
+        unsigned long long oldest=t->getTotal()-t->size();
+        unsigned long long a=max(first,oldest);
+        unsigned long long b=min(last,t->getTotal());
+        float lo,hi;
+        if(a>=b || t->minMax(a-oldest,b-oldest,lo,hi)==false)
+        {
+            prevSpans[i]=make_pair(-1,-1);
+            continue;
+        }
+        int yMin=min(h-1,max<int>(0,(lo-ymin)/range*static_cast<float>(h)));
+        int yMax=min(h-1,max<int>(0,(hi-ymin)/range*static_cast<float>(h)));
+        //Extend the span to join the previous column, so the trace looks
+        //continuous
+        int oldMin=prevSpans[i].first;
+        int oldMax=prevSpans[i].second;
+        prevSpans[i]=make_pair(yMin,yMax);
+        if(oldMin>=0)
+        {
+            if(yMin>oldMax) yMin=oldMax+1;
+            if(yMax<oldMin) yMax=oldMin-1;
+        }
+        for(int y=yMin;y<=yMax;y++)
+            column[y]=column[y]==background ? t->color : column[y] | t->color;
+    }
+    //Draw runs of the same color as lines
+    const int y2=lowerRight.y();
+    for(int y=0;y<h;)
+    {
+        int end=y+1;
+        while(end<h && column[end]==column[y]) end++;
+        dc.line(Point(x,y2-end+1),Point(x,y2-y),column[y]);
+        y=end;
+    }
+}
+
+unsigned long long StreamingPlot::totalSamples() const
+{
+    unsigned long long result=traces.front()->getTotal();
+    for(unsigned int i=1;i<traces.size();i++)
+        result=min(result,traces[i]->getTotal());
+    return result;
 }
 
 } //namespace mxgui
@@ -31,6 +31,7 @@
 #include <string>
 #include <display.h>
 #include <misc_inst.h>
+#include <numeric_field.h>
 
 namespace mxgui {
 
@@ -68,10 +69,221 @@ public:
     float ymax;
     
 private:
-    std::string number(float num);
+    static const int numberSize=9; ///< Buffer size for number(), nul included
+
+    /**
+     * Format a tick label, without allocating memory
+     * \param buffer the label is written here, numberSize bytes
+     * \param num number to format
+     */
+    void number(char *buffer, float num);
     
     bool first;
     float prevYmin,prevYmax;
 };
 
+/**
+ * A fixed capacity ring buffer of samples to be drawn by a StreamingPlot.
+ * When full, appending a sample discards the oldest one. The minimum and
+ * maximum of each block of blockSize samples are kept updated as samples are
+ * appended, so that the minimum and maximum of a range of samples can be
+ * found without scanning all of them. The minimum and maximum of all the
+ * blocks but the one being written are also kept, and updated once per
+ * block, so those of the whole buffer are found in at most blockSize steps.
+ * NaN samples are allowed, and are not plotted.
+ */
+class StreamingTrace
+{
+public:
+    /**
+     * Constructor
+     * \param capacity maximum number of samples, rounded up to a multiple of
+     * blockSize
+     * \param color trace color
+     */
+    StreamingTrace(unsigned int capacity, Color color=white);
+
+    /**
+     * Append a sample
+     * \param sample sample to append
+     */
+    void append(float sample);
+
+    /**
+     * Append samples
+     * \param samples pointer to the samples
+     * \param n number of samples
+     */
+    void append(const float *samples, unsigned int n);
+
+    /**
+     * Remove all samples
+     */
+    void clear();
+
+    /**
+     * \return the number of samples in the buffer
+     */
+    unsigned int size() const { return count; }
+
+    /**
+     * \return the maximum number of samples in the buffer
+     */
+    unsigned int getCapacity() const { return data.size(); }
+
+    /**
+     * \return the number of samples appended since construction or the last
+     * call to clear(), including those that have been discarded
+     */
+    unsigned long long getTotal() const { return total; }
+
+    /**
+     * \param i sample index, 0 is the oldest sample in the buffer
+     * \return the sample
+     */
+    float at(unsigned int i) const { return data[physical(i)]; }
+
+    /**
+     * Find the minimum and maximum of a range of samples, ignoring NaNs.
+     * Reads the minimum and maximum of the whole blocks in the range, and the
+     * samples of the up to two blocks it only partially includes. The range
+     * of all samples is found in at most blockSize steps
+     * \param first index of the first sample, 0 is the oldest sample
+     * \param last index of one past the last sample
+     * \param lo the minimum is returned here
+     * \param hi the maximum is returned here
+     * \return false if the range contains no samples other than NaNs
+     */
+    bool minMax(unsigned int first, unsigned int last, float& lo, float& hi) const;
+
+    Color color; ///< Trace color
+
+    static const unsigned int blockSize=64; ///< Samples per min/max block
+
+private:
+    /**
+     * \param i sample index, 0 is the oldest sample
+     * \return the index of the sample in data
+     */
+    unsigned int physical(unsigned int i) const
+    {
+        unsigned int p=head+data.size()-count+i;
+        return p>=data.size() ? p-data.size() : p;
+    }
+
+    std::vector<float> data;     ///< Ring buffer
+    std::vector<float> blockMin; ///< Minimum of each block of data
+    std::vector<float> blockMax; ///< Maximum of each block of data
+    float restMin;               ///< Minimum of the blocks but the current
+    float restMax;               ///< Maximum of the blocks but the current
+    unsigned int head;           ///< Where the next sample is written
+    unsigned int count;          ///< Number of samples in the buffer
+    unsigned long long total;    ///< Number of samples ever appended
+};
+
+/**
+ * A plot of streaming data, such as data coming from a sensor at a high rate.
+ * Each column of pixels shows a vertical span from the minimum to the maximum
+ * of the samples it represents, found using the per block minimum and
+ * maximum of the traces. Drawing a column thus costs at most 2*blockSize
+ * sample reads plus one read per whole block it spans, so the drawing time of
+ * the columns in SCROLL and SWEEP mode does not depend on how many samples
+ * the traces hold. FIT mode redraws all the columns, and thus reads all the
+ * blocks of every trace at each draw().
+ */
+class StreamingPlot
+{
+public:
+    /**
+     * Plot modes
+     */
+    enum Mode
+    {
+        FIT,    ///< All the samples in the buffers are fit in the plot width
+        SCROLL, ///< Fixed samples per column, the plot scrolls to the left
+        SWEEP   ///< Fixed samples per column, a cursor sweeps the plot
+    };
+
+    /**
+     * Constructor, the plot is in FIT mode and automatic range
+     * \param upperLeft upper left corner of the plot area
+     * \param lowerRight lower right corner of the plot area
+     */
+    StreamingPlot(Point upperLeft, Point lowerRight);
+
+    /**
+     * Add a trace to the plot. All traces should be appended the same number
+     * of samples, as only the samples appended to all traces are plotted
+     * \param trace trace to add, must outlive the plot
+     */
+    void addTrace(const StreamingTrace& trace);
+
+    /**
+     * Set the plot mode. In SCROLL and SWEEP mode only the columns for the
+     * samples appended since the last draw() are drawn. SCROLL mode requires
+     * a display that supports copyArea(), otherwise the whole plot is drawn
+     * every time. Traces should have a capacity of at least the plot width
+     * times samplesPerColumn samples
+     * \param mode plot mode
+     * \param samplesPerColumn samples in each column, ignored in FIT mode
+     */
+    void setMode(Mode mode, unsigned int samplesPerColumn=1);
+
+    /**
+     * Set a fixed y axis range
+     * \param ymin value at the bottom of the plot
+     * \param ymax value at the top of the plot
+     */
+    void setRange(float ymin, float ymax);
+
+    /**
+     * Set the y axis range from the minimum and maximum of the samples in the
+     * traces. Every time the range changes the whole plot is drawn, so use a
+     * fixed range in SCROLL and SWEEP mode
+     */
+    void setAutoRange() { autoRange=true; }
+
+    /**
+     * Draw the plot
+     * \param dc drawing context
+     * \param fullRedraw if true draw the whole plot, and not only the parts
+     * that changed since the last draw
+     */
+    void draw(DrawingContext& dc, bool fullRedraw=false);
+
+    Color background; ///< Background color
+
+    static const int sweepGap=4; ///< Columns cleared ahead of the cursor
+
+private:
+    /**
+     * Draw a column
+     * \param dc drawing context
+     * \param x column x coordinate
+     * \param first first sample of the column in the traces
+     * \param last one past the last sample of the column, first==last if
+     * there are no samples
+     */
+    void drawColumn(DrawingContext& dc, int x, unsigned long long first,
+                    unsigned long long last);
+
+    /**
+     * \return the number of samples appended to all traces
+     */
+    unsigned long long totalSamples() const;
+
+    Point upperLeft;
+    Point lowerRight;
+    std::vector<const StreamingTrace*> traces;
+    std::vector<std::pair<int,int> > prevSpans; ///< Last drawn span per trace
+    std::vector<Color> column;  ///< Buffer to compose a column
+    Mode mode;
+    unsigned int samplesPerColumn;
+    bool autoRange;
+    bool first;                 ///< True if the plot was never drawn
+    float ymin, ymax;           ///< Range of the y axis
+    float drawnYmin, drawnYmax; ///< Range when the plot was last drawn
+    unsigned long long nextColumn; ///< First column not yet drawn
+};
+
 } //namespace mxgui
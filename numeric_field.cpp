@@ -0,0 +1,224 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "numeric_field.h"
+#include "display_state_saver.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+namespace mxgui {
+
+/**
+ * Format a fixed point number without padding
+ * \param buffer the number is written here, not nul terminated
+ * \param cells maximum number of characters
+ * \param value value in fixed point
+ * \param decimals number of digits after the decimal point
+ * \return the number of characters, or 0 if the number does not fit
+ */
+static unsigned int formatFixed(char *buffer, unsigned int cells,
+        long long value, unsigned char decimals)
+{
+    //Digits are generated right to left, at least one before the point
+    char temp[24];
+    unsigned int n=0;
+    unsigned long long m=value<0 ? -value : value;
+    do {
+        if(decimals>0 && n==decimals) temp[n++]='.';
+        temp[n++]='0'+m%10;
+        m/=10;
+    } while(m>0 || (decimals>0 && n<=decimals));
+    if(value<0) temp[n++]='-';
+    if(n>cells) return 0;
+    for(unsigned int i=0;i<n;i++) buffer[i]=temp[n-1-i];
+    return n;
+}
+
+/**
+ * Fill a buffer with '#' to show a number that does not fit
+ * \param buffer buffer to fill, nul terminated
+ * \param cells number of characters
+ * \return false
+ */
+static bool overflow(char *buffer, unsigned int cells)
+{
+    memset(buffer,'#',cells);
+    buffer[cells]='\0';
+    return false;
+}
+
+//
+// class NumericField
+//
+
+const unsigned int NumericField::maxCells;
+
+NumericField::NumericField(Point p, const Font& font, unsigned char cells,
+        unsigned char decimals) : p(p), font(font),
+        cells(min<unsigned char>(cells,maxCells)), decimals(decimals),
+        valid(false)
+{
+    //Cells are as wide as the widest character, so the layout never moves
+    const char chars[]="0123456789-# ";
+    cellWidth=0;
+    for(const char *c=chars;*c;c++)
+        cellWidth=max(cellWidth,font.calculateLength(static_cast<char32_t>(*c)));
+    pointWidth=font.calculateLength(static_cast<char32_t>('.'));
+}
+
+void NumericField::draw(DrawingContext& dc, int value)
+{
+    char text[maxCells+1];
+    format(text,cells,value,decimals);
+    drawCells(dc,text);
+}
+
+void NumericField::draw(DrawingContext& dc, float value)
+{
+    char text[maxCells+1];
+    float scaled=value;
+    for(int i=0;i<decimals;i++) scaled*=10.f;
+    //Also rejects NaN, as comparisons with it are false
+    if(scaled>=-2147483648.f && scaled<2147483648.f)
+        format(text,cells,static_cast<int>(lround(scaled)),decimals);
+    else overflow(text,cells);
+    drawCells(dc,text);
+}
+
+short int NumericField::getWidth() const
+{
+    if(decimals>0 && decimals<cells) return (cells-1)*cellWidth+pointWidth;
+    return cells*cellWidth;
+}
+
+bool NumericField::format(char *buffer, unsigned int cells, int value,
+        unsigned char decimals)
+{
+    unsigned int n=formatFixed(buffer,cells,value,decimals);
+    if(n==0) return overflow(buffer,cells);
+    //Right align
+    memmove(buffer+cells-n,buffer,n);
+    memset(buffer,' ',cells-n);
+    buffer[cells]='\0';
+    return true;
+}
+
+bool NumericField::formatCompact(char *buffer, unsigned int cells,
+        float value, unsigned char maxDecimals)
+{
+    if(std::isnan(value) || std::isinf(value))
+    {
+        const char *s=std::isnan(value) ? "nan" : value<0 ? "-inf" : "inf";
+        if(strlen(s)>cells) return overflow(buffer,cells);
+        strcpy(buffer,s);
+        return true;
+    }
+    float scaled=value;
+    for(int i=0;i<maxDecimals;i++) scaled*=10.f;
+    for(int decimals=maxDecimals;decimals>=0;decimals--,scaled/=10.f)
+    {
+        if(fabs(scaled)>=9.2e18f) continue;
+        long long fixed=llround(scaled);
+        //Values too small to show any digit use the exponential notation
+        if(fixed==0 && value!=0.f) break;
+        unsigned int n=formatFixed(buffer,cells,fixed,decimals);
+        if(n==0) continue;
+        if(decimals>0)
+        {
+            while(buffer[n-1]=='0') n--;
+            if(buffer[n-1]=='.') n--;
+        }
+        buffer[n]='\0';
+        return true;
+    }
+    //Exponential notation with two significant digits, like 1.5e+09
+    int exponent=floor(log10(fabs(value)));
+    int mantissa=lround(fabs(value)/pow(10.f,exponent)*10.f);
+    if(mantissa>=100)
+    {
+        mantissa/=10;
+        exponent++;
+    }
+    char temp[12];
+    unsigned int n=0;
+    if(value<0) temp[n++]='-';
+    temp[n++]='0'+mantissa/10;
+    if(mantissa%10)
+    {
+        temp[n++]='.';
+        temp[n++]='0'+mantissa%10;
+    }
+    temp[n++]='e';
+    temp[n++]=exponent<0 ? '-' : '+';
+    exponent=abs(exponent);
+    temp[n++]='0'+exponent/10;
+    temp[n++]='0'+exponent%10;
+    if(n>cells) return overflow(buffer,cells);
+    memcpy(buffer,temp,n);
+    buffer[n]='\0';
+    return true;
+}
+
+void NumericField::drawCells(DrawingContext& dc, const char *text)
+{
+    pair<Color,Color> c=dc.getTextColor();
+    if(c!=colors)
+    {
+        colors=c;
+        valid=false;
+    }
+    StateSaver state(dc);
+    dc.setFont(font);
+    dc.setTransparentText(false);
+    const short int height=font.getHeight();
+    const unsigned int point=decimals>0 ? cells-decimals-1 : cells;
+    short int x=p.x();
+    for(unsigned int i=0;i<cells;i++)
+    {
+        short int width=i==point ? pointWidth : cellWidth;
+        if(valid==false || text[i]!=drawn[i])
+        {
+            //The character is centered in its cell, the rest is background
+            const char s[]={text[i],'\0'};
+            short int charWidth=font.calculateLength(s);
+            short int left=max(0,(width-charWidth)/2);
+            Point a(x,p.y()), b(x+width-1,p.y()+height-1);
+            if(left>0) dc.clear(a,Point(x+left-1,b.y()),c.second);
+            if(left+charWidth<width)
+                dc.clear(Point(x+left+charWidth,a.y()),b,c.second);
+            dc.clippedWrite(Point(x+left,p.y()),a,b,s);
+            drawn[i]=text[i];
+        }
+        x+=width;
+    }
+    valid=true;
+}
+
+} //namespace mxgui
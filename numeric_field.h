@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "display.h"
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface
+ * A number drawn at a fixed position, for dashboards and counters that are
+ * updated often. Numbers are formatted without allocating memory, and each
+ * character is drawn in a cell of fixed width, so digits don't move when
+ * the value changes. The field remembers what it has drawn, so that only
+ * the cells that changed are redrawn, usually one or two digits per update.
+ *
+ * Numbers are right aligned, and can be integers or fixed point, with a
+ * given number of digits after the decimal point. Values that don't fit are
+ * drawn as a row of '#'.
+ * Text is drawn with the text colors of the DrawingContext, and changing
+ * them redraws the whole field. If something else is drawn over the field,
+ * call invalidate() to redraw it entirely the next time.
+ */
+class NumericField
+{
+public:
+    /**
+     * Constructor
+     * \param p upper left corner of the field
+     * \param font font used to draw the number
+     * \param cells number of characters, including the sign and the decimal
+     * point, at most maxCells
+     * \param decimals number of digits after the decimal point, 0 for
+     * integers
+     */
+    NumericField(Point p, const Font& font, unsigned char cells,
+            unsigned char decimals=0);
+
+    /**
+     * Draw a number, only redrawing the cells that changed
+     * \param dc drawing context
+     * \param value value to draw, in fixed point. For example with two
+     * decimals 1234 is drawn as 12.34
+     */
+    void draw(DrawingContext& dc, int value);
+
+    /**
+     * Draw a number, only redrawing the cells that changed
+     * \param dc drawing context
+     * \param value value to draw, rounded to the number of decimals
+     */
+    void draw(DrawingContext& dc, float value);
+
+    /**
+     * Redraw all cells the next time draw() is called
+     */
+    void invalidate() { valid=false; }
+
+    /**
+     * \return the upper left corner of the field
+     */
+    Point getPosition() const { return p; }
+
+    /**
+     * \return the width of the field
+     */
+    short int getWidth() const;
+
+    /**
+     * \return the height of the field
+     */
+    short int getHeight() const { return font.getHeight(); }
+
+    /**
+     * Format a fixed point number, right aligned and padded with spaces
+     * \param buffer the nul terminated number is written here, must be at
+     * least cells+1 bytes
+     * \param cells number of characters
+     * \param value value in fixed point
+     * \param decimals number of digits after the decimal point
+     * \return false if the value does not fit, in this case buffer is
+     * filled with '#'
+     */
+    static bool format(char *buffer, unsigned int cells, int value,
+            unsigned char decimals);
+
+    /**
+     * Format a number in the shortest form that fits, with as many digits
+     * after the decimal point as fit up to maxDecimals, without trailing
+     * zeros, or in exponential notation if it is too large or too small.
+     * Useful for labels such as the ticks of a plot
+     * \param buffer the nul terminated number is written here, must be at
+     * least cells+1 bytes
+     * \param cells maximum number of characters
+     * \param value value to format
+     * \param maxDecimals maximum number of digits after the decimal point
+     * \return false if the value does not fit, in this case buffer is
+     * filled with '#'
+     */
+    static bool formatCompact(char *buffer, unsigned int cells, float value,
+            unsigned char maxDecimals);
+
+    static const unsigned int maxCells=16; ///< Maximum number of cells
+
+    //Uses default copy constructor and operator=
+private:
+    /**
+     * Draw the cells that changed
+     * \param dc drawing context
+     * \param text formatted number, cells characters long
+     */
+    void drawCells(DrawingContext& dc, const char *text);
+
+    Point p;                   ///< Upper left corner
+    Font font;                 ///< Font used to draw the number
+    unsigned char cells;       ///< Number of characters
+    unsigned char decimals;    ///< Digits after the decimal point
+    short int cellWidth;       ///< Width of a cell, the widest character
+    short int pointWidth;      ///< Width of the decimal point cell
+    char drawn[maxCells];      ///< Characters on screen
+    std::pair<Color,Color> colors; ///< Colors of the characters on screen
+    bool valid;                ///< False if drawn is not what is on screen
+};
+
+} //namespace mxgui
@@ -0,0 +1,525 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "path.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+namespace mxgui {
+
+//
+// class Path
+//
+
+Path::Path() : numSubpaths(0), subpathStart(0), axisAligned(true) {}
+
+void Path::moveTo(float x, float y)
+{
+    commands.push_back(MoveTo);
+    subpathStart=points.size();
+    addPoint(x,y);
+    numSubpaths++;
+}
+
+void Path::lineTo(float x, float y)
+{
+    continueSubpath();
+    int prevX=points[points.size()-2];
+    int prevY=points[points.size()-1];
+    commands.push_back(LineTo);
+    addPoint(x,y);
+    if(prevX!=points[points.size()-2] && prevY!=points[points.size()-1])
+        axisAligned=false;
+}
+
+void Path::quadTo(float cx, float cy, float x, float y)
+{
+    continueSubpath();
+    commands.push_back(QuadTo);
+    addPoint(cx,cy);
+    addPoint(x,y);
+    axisAligned=false;
+}
+
+void Path::cubicTo(float c1x, float c1y, float c2x, float c2y, float x,
+        float y)
+{
+    continueSubpath();
+    commands.push_back(CubicTo);
+    addPoint(c1x,c1y);
+    addPoint(c2x,c2y);
+    addPoint(x,y);
+    axisAligned=false;
+}
+
+void Path::close()
+{
+    if(commands.empty() || commands.back()==Close) return;
+    commands.push_back(Close);
+}
+
+void Path::clear()
+{
+    commands.clear();
+    points.clear();
+    numSubpaths=0;
+    subpathStart=0;
+    axisAligned=true;
+}
+
+void Path::addPoint(float x, float y)
+{
+    int fx=lroundf(x*256.0f);
+    int fy=lroundf(y*256.0f);
+    if((fx & 255) || (fy & 255)) axisAligned=false;
+    points.push_back(fx);
+    points.push_back(fy);
+}
+
+void Path::continueSubpath()
+{
+    if(commands.empty())
+    {
+        commands.push_back(MoveTo);
+        points.push_back(0);
+        points.push_back(0);
+        numSubpaths++;
+    } else if(commands.back()==Close) {
+        int x=points[subpathStart];
+        int y=points[subpathStart+1];
+        commands.push_back(MoveTo);
+        subpathStart=points.size();
+        points.push_back(x);
+        points.push_back(y);
+        numSubpaths++;
+    }
+}
+
+namespace impl {
+
+/**
+ * Map the accumulated signed coverage of a pixel to the antialiasing palette
+ * \param v coverage, 256 for a fully covered pixel, the sign depends on the
+ * direction of the edges
+ * \param rule fill rule
+ * \return the palette level, from 0 to 3
+ */
+static int coverageLevel(int v, FillRule::FillRule_ rule)
+{
+    v=abs(v);
+    if(rule==FillRule::NonZero) v=min(v,256);
+    else {
+        v&=511;
+        if(v>256) v=512-v;
+    }
+    return (v*3+128)/256;
+}
+
+//
+// class PathRasteriser
+//
+
+PathRasteriser::PathRasteriser(short int width, short int height)
+    : width(width), height(height), rule(FillRule::NonZero), next(0),
+      halfWidth(0)
+{
+    current.x=current.y=0;
+    current.cover=current.area=0;
+}
+
+void PathRasteriser::fill(const Path& path)
+{
+    int startX=0, startY=0, prevX=0, prevY=0;
+    flatten(path,[&](FlattenEvent e, int x, int y)
+    {
+        if(e==Start)
+        {
+            //Open subpaths are implicitly closed
+            addLine(prevX,prevY,startX,startY);
+            startX=x;
+            startY=y;
+        } else addLine(prevX,prevY,x,y);
+        prevX=x;
+        prevY=y;
+    });
+    addLine(prevX,prevY,startX,startY);
+}
+
+void PathRasteriser::stroke(const Path& path, float width)
+{
+    float r=max(width/2.0f,0.0f);
+    halfWidth=lroundf(r*256.0f);
+    if(halfWidth==0) return;
+    //Enough segments for round joins to deviate less than 0.1 pixels from
+    //a circle
+    int n=6;
+    if(r>0.1f)
+        n=max(n,static_cast<int>(ceilf(3.14159265f/acosf(1.0f-0.1f/r))));
+    n=min(n,64);
+    join.resize(2*n);
+    for(int i=0;i<n;i++)
+    {
+        float a=2.0f*3.14159265f*i/n;
+        join[2*i]=lroundf(halfWidth*cosf(a));
+        join[2*i+1]=lroundf(halfWidth*sinf(a));
+    }
+    int prevX=0, prevY=0;
+    int nx=0, ny=0;
+    bool interior=false;
+    flatten(path,[&](FlattenEvent e, int x, int y)
+    {
+        //Points within flattened curves only need a bevel on the outer side
+        //of the turn, as the segments meet at a small angle
+        int prevNx=nx, prevNy=ny;
+        if(e!=Start) addSegmentStroke(prevX,prevY,x,y,nx,ny);
+        if(interior)
+        {
+            int side=static_cast<long long>(prevNx)*ny-
+                     static_cast<long long>(prevNy)*nx>0 ? -1 : 1;
+            const int wedge[]=
+            {
+                prevX, prevY,
+                prevX+side*prevNx, prevY+side*prevNy,
+                prevX+side*nx, prevY+side*ny
+            };
+            addPolygon(wedge,3);
+        }
+        interior= e==Interior;
+        if(e==Start || e==Corner) addRoundJoin(x,y);
+        prevX=x;
+        prevY=y;
+    });
+}
+
+void PathRasteriser::finish(FillRule::FillRule_ rule)
+{
+    this->rule=rule;
+    flushCell();
+    sort(cells.begin(),cells.end(),[](const Cell& a, const Cell& b)
+    {
+        return a.y<b.y || (a.y==b.y && a.x<b.x);
+    });
+    //Merge the cells of the same pixel
+    unsigned int j=0;
+    for(unsigned int i=0;i<cells.size();i++)
+    {
+        if(j>0 && cells[j-1].x==cells[i].x && cells[j-1].y==cells[i].y)
+        {
+            cells[j-1].cover+=cells[i].cover;
+            cells[j-1].area+=cells[i].area;
+        } else cells[j++]=cells[i];
+    }
+    cells.resize(j);
+    next=0;
+}
+
+int PathRasteriser::nextRow(short int& y, const ShapeSpan *& spans)
+{
+    if(next>=cells.size()) return -1;
+    this->spans.clear();
+    auto addSpan=[this](int x0, int x1, int v)
+    {
+        int level=coverageLevel(v,rule);
+        x0=max(x0,0);
+        x1=min<int>(x1,width-1);
+        if(level==0 || x0>x1) return;
+        if(!this->spans.empty() && this->spans.back().level==level
+            && this->spans.back().x1+1==x0)
+        {
+            this->spans.back().x1=x1;
+            return;
+        }
+        ShapeSpan s;
+        s.x0=x0;
+        s.x1=x1;
+        s.level=level;
+        this->spans.push_back(s);
+    };
+    y=cells[next].y;
+    //Sweep the row accumulating the cover left to right. Within a cell the
+    //area of the edges is subtracted, as the part of the cell left of them
+    //is not covered
+    int cover=0;
+    while(next<cells.size() && cells[next].y==y)
+    {
+        const Cell& c=cells[next++];
+        addSpan(c.x,c.x,cover+c.cover-c.area/512);
+        cover+=c.cover;
+        int end= next<cells.size() && cells[next].y==y ? cells[next].x : width;
+        if(end>c.x+1) addSpan(c.x+1,end-1,cover);
+    }
+    spans=this->spans.data();
+    return this->spans.size();
+}
+
+template<typename F>
+void PathRasteriser::flatten(const Path& path, F&& callback)
+{
+    //Curves are split in segments deviating less than 0.2 pixels from them
+    const float tolerance=0.2f*256.0f;
+    const int maxSegments=64;
+    const int *p=path.points.data();
+    int x=0, y=0, startX=0, startY=0;
+    for(unsigned char c : path.commands)
+    {
+        switch(c)
+        {
+            case Path::MoveTo:
+                x=startX=p[0];
+                y=startY=p[1];
+                p+=2;
+                callback(Start,x,y);
+                break;
+            case Path::LineTo:
+                x=p[0];
+                y=p[1];
+                p+=2;
+                callback(Corner,x,y);
+                break;
+            case Path::QuadTo:
+            {
+                //A quadratic curve deviates from its chord by a quarter of
+                //the second difference of its points
+                float ddx=x-2*p[0]+p[2];
+                float ddy=y-2*p[1]+p[3];
+                float dd=sqrtf(ddx*ddx+ddy*ddy);
+                int n=max(1,min(maxSegments,
+                    static_cast<int>(ceilf(sqrtf(dd/(4*tolerance))))));
+                for(int i=1;i<n;i++)
+                {
+                    float t=static_cast<float>(i)/n;
+                    float u=1.0f-t;
+                    callback(Interior,
+                        lroundf(u*u*x+2*u*t*p[0]+t*t*p[2]),
+                        lroundf(u*u*y+2*u*t*p[1]+t*t*p[3]));
+                }
+                x=p[2];
+                y=p[3];
+                p+=4;
+                callback(Corner,x,y);
+                break;
+            }
+            case Path::CubicTo:
+            {
+                //A cubic curve deviates from its chord by at most 3/4 of the
+                //largest second difference of its points
+                float ddx0=x-2*p[0]+p[2];
+                float ddy0=y-2*p[1]+p[3];
+                float ddx1=p[0]-2*p[2]+p[4];
+                float ddy1=p[1]-2*p[3]+p[5];
+                float dd=sqrtf(max(ddx0*ddx0+ddy0*ddy0,ddx1*ddx1+ddy1*ddy1));
+                int n=max(1,min(maxSegments,
+                    static_cast<int>(ceilf(sqrtf(3*dd/(4*tolerance))))));
+                for(int i=1;i<n;i++)
+                {
+                    float t=static_cast<float>(i)/n;
+                    float u=1.0f-t;
+                    float a=u*u*u, b=3*u*u*t, cc=3*u*t*t, d=t*t*t;
+                    callback(Interior,
+                        lroundf(a*x+b*p[0]+cc*p[2]+d*p[4]),
+                        lroundf(a*y+b*p[1]+cc*p[3]+d*p[5]));
+                }
+                x=p[4];
+                y=p[5];
+                p+=6;
+                callback(Corner,x,y);
+                break;
+            }
+            case Path::Close:
+                x=startX;
+                y=startY;
+                callback(Close,x,y);
+                break;
+        }
+    }
+}
+
+void PathRasteriser::setCell(int x, int y)
+{
+    //Cells outside the clipping area are merged in a single column on each
+    //side, as their cover still affects the pixels to their right
+    x=max(-1,min<int>(x,width));
+    if(x==current.x && y==current.y) return;
+    flushCell();
+    current.x=x;
+    current.y=y;
+    current.cover=0;
+    current.area=0;
+}
+
+void PathRasteriser::flushCell()
+{
+    if(current.cover==0 && current.area==0) return;
+    cells.push_back(current);
+    current.cover=0;
+    current.area=0;
+}
+
+void PathRasteriser::addLine(int x0, int y0, int x1, int y1)
+{
+    //Horizontal lines do not contribute to coverage
+    if(y0==y1) return;
+    const int ymax=height*256;
+    if((y0<=0 && y1<=0) || (y0>=ymax && y1>=ymax)) return;
+    //Clip to the visible rows, lines to the left and right are still
+    //needed as they affect the cover of the visible pixels
+    auto xAt=[=](int y)
+    {
+        return x0+static_cast<int>(static_cast<long long>(x1-x0)*(y-y0)/(y1-y0));
+    };
+    int cx0=x0, cy0=y0, cx1=x1, cy1=y1;
+    if(y0<0) { cx0=xAt(0); cy0=0; }
+    else if(y0>ymax) { cx0=xAt(ymax); cy0=ymax; }
+    if(y1<0) { cx1=xAt(0); cy1=0; }
+    else if(y1>ymax) { cx1=xAt(ymax); cy1=ymax; }
+    x0=cx0; y0=cy0; x1=cx1; y1=cy1;
+
+    int dx=x1-x0;
+    int dy=y1-y0;
+    int row0=y0>>8;
+    int row1=y1>>8;
+    if(row0==row1)
+    {
+        addScanline(row0,x0,y0-(row0<<8),x1,y1-(row0<<8));
+        return;
+    }
+    int dir= dy>0 ? 1 : -1;
+    int x=x0, y=y0;
+    for(int row=row0;;row+=dir)
+    {
+        int yNext= dy>0 ? min(y1,(row+1)<<8) : max(y1,row<<8);
+        int xNext= yNext==y1 ? x1 :
+            x0+static_cast<int>(static_cast<long long>(dx)*(yNext-y0)/dy);
+        if(yNext!=y) addScanline(row,x,y-(row<<8),xNext,yNext-(row<<8));
+        x=xNext;
+        y=yNext;
+        if(row==row1) break;
+    }
+}
+
+void PathRasteriser::addScanline(int y, int x0, int fy0, int x1, int fy1)
+{
+    if(fy0==fy1) return;
+    int col0=x0>>8;
+    int col1=x1>>8;
+    if(col0==col1)
+    {
+        //Also the fast path for vertical lines
+        setCell(col0,y);
+        current.cover+=fy1-fy0;
+        current.area+=(fy1-fy0)*((x0&255)+(x1&255));
+        return;
+    }
+    //Walk the cells crossed by the line, computing where it crosses each
+    //cell boundary
+    int dx=x1-x0;
+    int dy=fy1-fy0;
+    int step= dx>0 ? 1 : -1;
+    int x=x0, fy=fy0;
+    for(int col=col0;col!=col1;col+=step)
+    {
+        int xb= dx>0 ? (col+1)*256 : col*256;
+        int fyb=fy0+static_cast<int>(static_cast<long long>(dy)*(xb-x0)/dx);
+        setCell(col,y);
+        current.cover+=fyb-fy;
+        current.area+=(fyb-fy)*((x-col*256)+(xb-col*256));
+        x=xb;
+        fy=fyb;
+    }
+    setCell(col1,y);
+    current.cover+=fy1-fy;
+    current.area+=(fy1-fy)*((x-col1*256)+(x1&255));
+}
+
+void PathRasteriser::addPolygon(const int *xy, int n)
+{
+    long long area=0;
+    for(int i=0;i<n;i++)
+    {
+        int j= i+1<n ? i+1 : 0;
+        area+=static_cast<long long>(xy[2*i])*xy[2*j+1]-
+              static_cast<long long>(xy[2*j])*xy[2*i+1];
+    }
+    for(int i=0;i<n;i++)
+    {
+        int j= i+1<n ? i+1 : 0;
+        if(area>=0) addLine(xy[2*i],xy[2*i+1],xy[2*j],xy[2*j+1]);
+        else addLine(xy[2*j],xy[2*j+1],xy[2*i],xy[2*i+1]);
+    }
+}
+
+void PathRasteriser::addSegmentStroke(int x0, int y0, int x1, int y1,
+        int& nx, int& ny)
+{
+    float dx=x1-x0;
+    float dy=y1-y0;
+    float len=sqrtf(dx*dx+dy*dy);
+    if(len==0.0f) return;
+    nx=lroundf(-dy*halfWidth/len);
+    ny=lroundf(dx*halfWidth/len);
+    const int quad[]=
+    {
+        x0+nx, y0+ny, x1+nx, y1+ny, x1-nx, y1-ny, x0-nx, y0-ny
+    };
+    addPolygon(quad,4);
+}
+
+void PathRasteriser::addRoundJoin(int x, int y)
+{
+    //The join vertices are precomputed around the origin, so they are
+    //translated in place and then back
+    int n=join.size()/2;
+    for(int i=0;i<n;i++)
+    {
+        join[2*i]+=x;
+        join[2*i+1]+=y;
+    }
+    addPolygon(join.data(),n);
+    for(int i=0;i<n;i++)
+    {
+        join[2*i]-=x;
+        join[2*i+1]-=y;
+    }
+}
+
+int PathRasteriser::axisAlignedPolygon(const Path& path, Point *points)
+{
+    if(path.axisAligned==false || path.numSubpaths!=1) return 0;
+    int n=path.points.size()/2;
+    if(n<3 || n>PolygonRasteriser::maxVertices) return 0;
+    //Also the implicit closing line must be axis aligned
+    const int *p=path.points.data();
+    if(p[0]!=p[2*n-2] && p[1]!=p[2*n-1]) return 0;
+    for(int i=0;i<n;i++) points[i]=Point(p[2*i]>>8,p[2*i+1]>>8);
+    return n;
+}
+
+} //namespace impl
+} //namespace mxgui
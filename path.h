@@ -0,0 +1,377 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "mxgui_settings.h"
+#include "point.h"
+#include "color.h"
+#include "font.h"
+#include "shapes.h"
+#include <vector>
+
+namespace mxgui {
+
+namespace impl { class PathRasteriser; }
+
+/**
+ * \ingroup pub_iface
+ * A vector path made of one or more subpaths of straight lines, quadratic
+ * and cubic Bezier curves, that can be filled or stroked with antialiasing.
+ * Coordinates are in pixels, with the pixel at (x,y) covering the square
+ * from (x,y) to (x+1,y+1), so a line through the center of a pixel has
+ * coordinates ending in .5. Coordinates are stored in fixed point with 8
+ * fractional bits.
+ */
+class Path
+{
+public:
+    /**
+     * Constructor, creates an empty path
+     */
+    Path();
+
+    /**
+     * Start a new subpath
+     * \param x x coordinate of the first point of the subpath
+     * \param y y coordinate of the first point of the subpath
+     */
+    void moveTo(float x, float y);
+
+    /**
+     * Add a straight line to the current subpath
+     * \param x x coordinate of the end point
+     * \param y y coordinate of the end point
+     */
+    void lineTo(float x, float y);
+
+    /**
+     * Add a quadratic Bezier curve to the current subpath
+     * \param cx x coordinate of the control point
+     * \param cy y coordinate of the control point
+     * \param x x coordinate of the end point
+     * \param y y coordinate of the end point
+     */
+    void quadTo(float cx, float cy, float x, float y);
+
+    /**
+     * Add a cubic Bezier curve to the current subpath
+     * \param c1x x coordinate of the first control point
+     * \param c1y y coordinate of the first control point
+     * \param c2x x coordinate of the second control point
+     * \param c2y y coordinate of the second control point
+     * \param x x coordinate of the end point
+     * \param y y coordinate of the end point
+     */
+    void cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+
+    /**
+     * Close the current subpath with a line to its first point
+     */
+    void close();
+
+    /**
+     * Remove all subpaths
+     */
+    void clear();
+
+    /**
+     * \return true if the path is empty
+     */
+    bool empty() const { return commands.empty(); }
+
+private:
+    /**
+     * Path commands
+     */
+    enum Command
+    {
+        MoveTo,  ///< Uses one point
+        LineTo,  ///< Uses one point
+        QuadTo,  ///< Uses two points
+        CubicTo, ///< Uses three points
+        Close    ///< Uses no point
+    };
+
+    /**
+     * Append a point to the path
+     * \param x x coordinate
+     * \param y y coordinate
+     */
+    void addPoint(float x, float y);
+
+    /**
+     * Called before adding a line or curve, starts a subpath if there is
+     * none, or after close() from the first point of the closed one
+     */
+    void continueSubpath();
+
+    std::vector<unsigned char> commands; ///< Commands
+    std::vector<int> points; ///< Coordinates in fixed point, x and y pairs
+    int numSubpaths;         ///< Number of subpaths
+    int subpathStart;        ///< Index in points of the current subpath start
+    /// True if the path is only made of horizontal and vertical lines with
+    /// integer coordinates, so all pixels are either fully covered or not
+    bool axisAligned;
+
+    friend class impl::PathRasteriser;
+};
+
+namespace impl {
+
+/**
+ * \internal
+ * Antialiased scanline rasteriser for paths. Curves are flattened into
+ * lines, and each line accumulates the signed height it covers, and the
+ * area to its left, in the pixel cells it crosses. Only cells crossed by an
+ * edge are stored, sorted by row and column once the path is complete and
+ * swept left to right: the coverage of the pixels between two cells is the
+ * accumulated cover, so the interior of a shape costs nothing but the
+ * spans that draw it.
+ */
+class PathRasteriser
+{
+public:
+    /**
+     * Constructor
+     * \param width cells right of this column are not stored
+     * \param height cells below this row are not stored
+     */
+    PathRasteriser(short int width, short int height);
+
+    /**
+     * Add the outline of a path to fill
+     * \param path path to fill
+     */
+    void fill(const Path& path);
+
+    /**
+     * Add the outline of the stroke of a path, with round caps and joins.
+     * Strokes must be drawn with the non-zero fill rule.
+     * \param path path to stroke
+     * \param width stroke width in pixels
+     */
+    void stroke(const Path& path, float width);
+
+    /**
+     * Sort the cells, call once after adding all outlines and before nextRow()
+     * \param rule fill rule
+     */
+    void finish(FillRule::FillRule_ rule);
+
+    /**
+     * Compute the spans of the next row containing cells
+     * \param y the row is returned here
+     * \param spans the spans are returned here, they are valid until the
+     * next call
+     * \return the number of spans, or -1 if there are no more rows
+     */
+    int nextRow(short int& y, const ShapeSpan *& spans);
+
+    /**
+     * Fast path for filling paths made of a single subpath of horizontal and
+     * vertical lines with integer coordinates, as all pixels are either fully
+     * covered or not, and can be drawn by PolygonRasteriser
+     * \param path path to fill
+     * \param points the polygon vertices are written here, array of at least
+     * PolygonRasteriser::maxVertices
+     * \return the number of vertices, or 0 if the path can't be drawn this way
+     */
+    static int axisAlignedPolygon(const Path& path, Point *points);
+
+private:
+    /**
+     * A pixel crossed by at least an edge
+     */
+    struct Cell
+    {
+        short int x, y; ///< Position
+        int cover;      ///< Sum of the signed heights of the edges in the cell
+        int area;       ///< Sum of the heights times twice the edge x position
+    };
+
+    /**
+     * Events produced while flattening a path
+     */
+    enum FlattenEvent
+    {
+        Start,    ///< First point of a subpath
+        Corner,   ///< End point of a line or curve
+        Interior, ///< Point within a flattened curve
+        Close     ///< The subpath is closed, with its first point
+    };
+
+    /**
+     * Flatten a path into straight lines
+     * \param path path to flatten
+     * \param callback called with a FlattenEvent and the coordinates of each
+     * point, in fixed point
+     */
+    template<typename F>
+    void flatten(const Path& path, F&& callback);
+
+    /**
+     * Select the cell where cover and area are accumulated, storing the
+     * previous one if needed
+     * \param x column
+     * \param y row
+     */
+    void setCell(int x, int y);
+
+    /**
+     * Store the cell being accumulated, if not empty
+     */
+    void flushCell();
+
+    /**
+     * Add a line, clipped to the rows between 0 and height
+     * \param x0 x coordinate of the first point, fixed point
+     * \param y0 y coordinate of the first point, fixed point
+     * \param x1 x coordinate of the second point, fixed point
+     * \param y1 y coordinate of the second point, fixed point
+     */
+    void addLine(int x0, int y0, int x1, int y1);
+
+    /**
+     * Add the part of a line within a row
+     * \param y row
+     * \param x0 x coordinate of the first point, fixed point
+     * \param fy0 y coordinate of the first point, from 0 to 256 within row y
+     * \param x1 x coordinate of the second point, fixed point
+     * \param fy1 y coordinate of the second point, from 0 to 256 within row y
+     */
+    void addScanline(int y, int x0, int fy0, int x1, int fy1);
+
+    /**
+     * Add a closed polygon, oriented so that all polygons added by stroke()
+     * wind in the same direction, and their union is drawn
+     * \param xy vertices, as x and y pairs in fixed point
+     * \param n number of vertices
+     */
+    void addPolygon(const int *xy, int n);
+
+    /**
+     * Add the outline of the stroke of a line, without caps
+     * \param x0 x coordinate of the first point, fixed point
+     * \param y0 y coordinate of the first point, fixed point
+     * \param x1 x coordinate of the second point, fixed point
+     * \param y1 y coordinate of the second point, fixed point
+     * \param nx x component of the normal to the line, long half the stroke
+     * width, is returned here. Left unchanged if the line has zero length
+     * \param ny y component of the normal is returned here
+     */
+    void addSegmentStroke(int x0, int y0, int x1, int y1, int& nx, int& ny);
+
+    /**
+     * Add a round join or cap
+     * \param x x coordinate of the center, fixed point
+     * \param y y coordinate of the center, fixed point
+     */
+    void addRoundJoin(int x, int y);
+
+    std::vector<Cell> cells;        ///< Stored cells
+    std::vector<ShapeSpan> spans;   ///< Spans of the current row
+    std::vector<int> join;          ///< Vertices of round joins, or scratch
+    Cell current;                   ///< Cell being accumulated
+    short int width, height;        ///< Clipping size
+    FillRule::FillRule_ rule;       ///< Fill rule
+    unsigned int next;              ///< Next cell to sweep
+    int halfWidth;                  ///< Half the stroke width, fixed point
+};
+
+/**
+ * \internal
+ * Draw the content of a PathRasteriser as spans through clear()
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param r rasteriser
+ * \param color fill color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void drawPath(T& surface, PathRasteriser& r, Color color, Color bg)
+{
+    Color palette[4];
+    Font::generatePalette(palette,color,bg);
+    short int y;
+    const ShapeSpan *spans;
+    int n;
+    while((n=r.nextRow(y,spans))>=0)
+        for(int i=0;i<n;i++)
+            surface.clear(Point(spans[i].x0,y),Point(spans[i].x1,y),
+                          palette[spans[i].level]);
+}
+
+} //namespace impl
+
+/**
+ * \ingroup pub_iface
+ * Fill a path with antialiased edges. Paths made of a single subpath of
+ * horizontal and vertical lines with integer coordinates are drawn without
+ * computing coverage.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param path path to fill, open subpaths are implicitly closed
+ * \param color fill color
+ * \param bg color of the background, edge pixels are blended with it
+ * \param rule fill rule
+ */
+template<typename T>
+void fillPath(T& surface, const Path& path, Color color, Color bg,
+        FillRule::FillRule_ rule=FillRule::NonZero)
+{
+    Point points[impl::PolygonRasteriser::maxVertices];
+    if(int n=impl::PathRasteriser::axisAlignedPolygon(path,points))
+    {
+        impl::PolygonRasteriser polygon(points,n,rule,0);
+        impl::drawPolygon(surface,polygon,color);
+        return;
+    }
+    impl::PathRasteriser r(surface.getWidth(),surface.getHeight());
+    r.fill(path);
+    r.finish(rule);
+    impl::drawPath(surface,r,color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Stroke a path with antialiased edges, round caps and round joins
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param path path to stroke
+ * \param width stroke width in pixels
+ * \param color stroke color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void strokePath(T& surface, const Path& path, float width, Color color,
+        Color bg)
+{
+    impl::PathRasteriser r(surface.getWidth(),surface.getHeight());
+    r.stroke(path,width);
+    r.finish(FillRule::NonZero);
+    impl::drawPath(surface,r,color,bg);
+}
+
+} //namespace mxgui
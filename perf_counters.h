@@ -0,0 +1,239 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "mxgui_settings.h"
+#include "color.h"
+
+#if defined(MXGUI_ENABLE_PERF_COUNTERS) || defined(MXGUI_ENABLE_TRACE)
+#include <algorithm>
+#include <cstdlib>
+#ifdef _MIOSIX
+#include "miosix.h"
+#else //_MIOSIX
+#include <chrono>
+#endif //_MIOSIX
+#endif //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
+
+namespace mxgui {
+
+#if defined(MXGUI_ENABLE_PERF_COUNTERS) || defined(MXGUI_ENABLE_TRACE)
+
+/**
+ * \internal
+ * \return the current time in nanoseconds, used as timebase by both the
+ * performance counters and the trace recorder
+ */
+inline long long perfTime()
+{
+    #ifdef _MIOSIX
+    return miosix::getTime();
+    #else //_MIOSIX
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count();
+    #endif //_MIOSIX
+}
+
+#endif //MXGUI_ENABLE_PERF_COUNTERS || MXGUI_ENABLE_TRACE
+
+#ifdef MXGUI_ENABLE_PERF_COUNTERS
+
+/**
+ * \ingroup pub_iface
+ * Performance counters of a display. Only available if
+ * MXGUI_ENABLE_PERF_COUNTERS is defined in mxgui_settings.h.
+ * Counters are updated by the DrawingContext member functions, so they
+ * account for the time spent by the application drawing, and not for the
+ * time the display driver spends internally. All times are in nanoseconds.
+ */
+class PerformanceCounters
+{
+public:
+    /**
+     * Graphic primitives whose performance is measured. Clipped variants
+     * are accounted together with the non clipped ones, and scanLineBuffer()
+     * together with scanLine()
+     */
+    enum Primitive
+    {
+        Write,         ///< write(), clippedWrite()
+        Clear,         ///< clear()
+        Line,          ///< line()
+        SetPixel,      ///< setPixel(), only calls and pixels, not time
+        ScanLine,      ///< scanLine(), scanLineBuffer()
+        DrawImage,     ///< drawImage(), clippedDrawImage(), sprites
+        DrawRectangle, ///< drawRectangle()
+        NumPrimitives  ///< Number of primitives, not a primitive
+    };
+
+    /**
+     * Counters for a single primitive
+     */
+    struct Counter
+    {
+        unsigned int calls;        ///< Number of calls
+        unsigned long long pixels; ///< Pixels written (upper bound if clipped)
+        long long time;            ///< Time spent in the primitive
+
+        /**
+         * \return an estimate of the bytes transferred to the display, as
+         * the number of pixels times the size of a Color
+         */
+        unsigned long long bytes() const { return pixels*sizeof(Color); }
+    };
+
+    /**
+     * Constructor, all counters start from zero
+     */
+    PerformanceCounters() { reset(); }
+
+    /**
+     * Reset all counters to zero, call it once per frame to measure the
+     * time spent drawing a frame
+     */
+    void reset()
+    {
+        for(int i=0;i<NumPrimitives;i++) primitives[i]=Counter();
+        update=Counter();
+        drawingContexts=0;
+        mutexWaitTime=0;
+        mutexHoldTime=0;
+        maxMutexHoldTime=0;
+    }
+
+    /**
+     * \param p a primitive
+     * \return the counters for that primitive
+     */
+    const Counter& operator[](Primitive p) const { return primitives[p]; }
+
+    /**
+     * \return the sum of the time spent in all primitives and update()
+     */
+    long long totalTime() const
+    {
+        long long result=update.time;
+        for(int i=0;i<NumPrimitives;i++) result+=primitives[i].time;
+        return result;
+    }
+
+    /**
+     * \return the current time in nanoseconds, used as timebase
+     */
+    static long long now() { return perfTime(); }
+
+    Counter primitives[NumPrimitives]; ///< Per primitive counters
+    Counter update;                    ///< Calls and time of Display::update()
+    unsigned int drawingContexts;      ///< Number of DrawingContext created
+    long long mutexWaitTime;           ///< Time waited to lock the display
+    long long mutexHoldTime;           ///< Time the display was held locked
+    long long maxMutexHoldTime;        ///< Longest a DrawingContext lived
+};
+
+/**
+ * \internal
+ * RAII class that accounts a call to a primitive, including its duration
+ */
+class PerfScope
+{
+public:
+    PerfScope(PerformanceCounters::Counter& c, unsigned long long pixels)
+        : c(c), start(PerformanceCounters::now())
+    {
+        c.calls++;
+        c.pixels+=pixels;
+    }
+
+    ~PerfScope() { c.time+=PerformanceCounters::now()-start; }
+
+private:
+    PerfScope(const PerfScope&)=delete;
+    PerfScope& operator=(const PerfScope&)=delete;
+
+    PerformanceCounters::Counter& c;
+    long long start;
+};
+
+/**
+ * \internal
+ * RAII class that accounts a call to a primitive, including its duration,
+ * whose pixel count is computed after the duration has been measured
+ */
+template<typename F>
+class LazyPerfScope
+{
+public:
+    LazyPerfScope(PerformanceCounters::Counter& c, F pixels)
+        : c(c), pixels(pixels), start(PerformanceCounters::now()) {}
+
+    ~LazyPerfScope()
+    {
+        c.time+=PerformanceCounters::now()-start;
+        c.calls++;
+        c.pixels+=pixels();
+    }
+
+private:
+    LazyPerfScope(const LazyPerfScope&)=delete;
+    LazyPerfScope& operator=(const LazyPerfScope&)=delete;
+
+    PerformanceCounters::Counter& c;
+    F pixels;
+    long long start;
+};
+
+/// \internal Account the enclosing scope as a call to a primitive. The pixel
+/// count expression is not evaluated when performance counters are disabled
+#define MXGUI_PERF_SCOPE(perf,prim,n) \
+    PerfScope perfScope((perf).primitives[PerformanceCounters::prim],(n))
+
+/// \internal As MXGUI_PERF_SCOPE, but the pixel count expression is evaluated
+/// when the scope ends, outside of the measured time. Use it when computing
+/// the pixel count is expensive compared to the primitive
+#define MXGUI_PERF_SCOPE_LAZY(perf,prim,n) \
+    auto perfPixels=[&]{ return static_cast<unsigned long long>(n); }; \
+    LazyPerfScope<decltype(perfPixels)> perfScope( \
+        (perf).primitives[PerformanceCounters::prim],perfPixels)
+
+/// \internal Account a call to a primitive without measuring its duration
+#define MXGUI_PERF_COUNT(perf,prim,n) \
+    do { \
+        (perf).primitives[PerformanceCounters::prim].calls++; \
+        (perf).primitives[PerformanceCounters::prim].pixels+=(n); \
+    } while(0)
+
+#else //MXGUI_ENABLE_PERF_COUNTERS
+
+#define MXGUI_PERF_SCOPE(perf,prim,n)
+#define MXGUI_PERF_SCOPE_LAZY(perf,prim,n)
+#define MXGUI_PERF_COUNT(perf,prim,n)
+
+#endif //MXGUI_ENABLE_PERF_COUNTERS
+
+} //namespace mxgui
@@ -0,0 +1,564 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "shapes.h"
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace mxgui {
+namespace impl {
+
+/// Used as an interval endpoint to mean unbounded
+static const int unbounded=1<<30;
+
+/**
+ * \param a dividend
+ * \param b divisor, nonzero
+ * \return a/b rounded towards minus infinity
+ */
+static int floorDiv(int a, int b)
+{
+    int q=a/b;
+    if(q*b!=a && ((a<0)!=(b<0))) q--;
+    return q;
+}
+
+/**
+ * \param a dividend
+ * \param b divisor, nonzero
+ * \return a/b rounded towards plus infinity
+ */
+static int ceilDiv(int a, int b)
+{
+    return -floorDiv(-a,b);
+}
+
+/**
+ * \param x a number
+ * \return the square root of x rounded down
+ */
+template<typename T>
+static unsigned int isqrtImpl(T x)
+{
+    T result=0;
+    T bit=static_cast<T>(1)<<(8*sizeof(T)-2);
+    while(bit>x) bit>>=2;
+    while(bit)
+    {
+        if(x>=result+bit)
+        {
+            x-=result+bit;
+            result=(result>>1)+bit;
+        } else result>>=1;
+        bit>>=2;
+    }
+    return result;
+}
+
+/**
+ * \param x a number
+ * \return the square root of x rounded down
+ */
+static unsigned int isqrt(unsigned long long x)
+{
+    //Shapes that fit on screen only need the faster 32 bit version
+    if(x<=0xffffffffull) return isqrtImpl<unsigned int>(x);
+    return isqrtImpl<unsigned long long>(x);
+}
+
+/**
+ * \param rx horizontal radius
+ * \param ry vertical radius
+ * \param dy vertical distance from the center
+ * \return half the width of the ellipse at distance dy from the center, or
+ * a negative number if the line does not intersect the ellipse
+ */
+static int ellipseHalfWidth(int rx, int ry, int dy)
+{
+    if(dy<=-ry || dy>=ry) return -1;
+    if(rx==ry) return isqrt(static_cast<long long>(ry)*ry-
+                            static_cast<long long>(dy)*dy);
+    //rx*sqrt(1-dy^2/ry^2), with the square root computed with four more
+    //fractional bits not to lose precision
+    unsigned int s=isqrt((static_cast<long long>(ry)*ry-
+                          static_cast<long long>(dy)*dy)*256);
+    return static_cast<long long>(rx)*s/(16*ry);
+}
+
+/**
+ * Compute the interval of x where sign*(ux*y-uy*x)>=0, that is the part of
+ * an horizontal line on one side of a line through the origin
+ * \param ux x component of the line direction
+ * \param uy y component of the line direction
+ * \param y the horizontal line
+ * \param sign 1 or -1 to select the side
+ * \param x0 interval begin is returned here
+ * \param x1 interval end, excluded, is returned here
+ */
+static void halfPlane(int ux, int uy, int y, int sign, int& x0, int& x1)
+{
+    //The condition is a*x<=b. With directions scaled by 1024 b fits in an
+    //int for any radius that fits in a short int
+    int a=sign*uy;
+    int b=sign*ux*y;
+    if(a>0)
+    {
+        x0=-unbounded;
+        x1=floorDiv(b,a)+1;
+    } else if(a<0) {
+        x0=ceilDiv(b,a);
+        x1=unbounded;
+    } else if(b>=0) {
+        x0=-unbounded;
+        x1=unbounded;
+    } else x0=x1=0;
+}
+
+/**
+ * Intersect two sets of sorted, non overlapping intervals
+ * \param a first set, as pairs of begin and end
+ * \param na number of intervals in a
+ * \param b second set
+ * \param nb number of intervals in b
+ * \param result intersection is written here
+ * \return the number of intervals in result
+ */
+static int intersect(const int *a, int na, const int *b, int nb, int *result)
+{
+    int n=0;
+    int i=0, j=0;
+    while(i<na && j<nb)
+    {
+        int x0=max(a[2*i],b[2*j]);
+        int x1=min(a[2*i+1],b[2*j+1]);
+        if(x0<x1)
+        {
+            result[2*n]=x0;
+            result[2*n+1]=x1;
+            n++;
+        }
+        if(a[2*i+1]<b[2*j+1]) i++; else j++;
+    }
+    return n;
+}
+
+//
+// class ShapeRasteriser
+//
+
+int ShapeRasteriser::row(short int y, short int xmin, short int xmax,
+        ShapeSpan *spans) const
+{
+    int n=0;
+    auto addSpan=[&](int x0, int x1, int level)
+    {
+        x0=max<int>(x0,xmin);
+        x1=min<int>(x1,xmax);
+        if(x0>x1 || level==0) return;
+        if(n>0 && spans[n-1].level==level && spans[n-1].x1+1==x0)
+        {
+            spans[n-1].x1=x1;
+            return;
+        }
+        spans[n].x0=x0;
+        spans[n].x1=x1;
+        spans[n].level=level;
+        n++;
+    };
+
+    if(antialiased==false)
+    {
+        //Draw the pixels whose center is within the intervals, ends included
+        //so that shapes symmetric around a pixel center are drawn symmetric.
+        //Intervals that touch could then share a pixel, which is drawn once
+        int x[2*maxIntervals];
+        int count=intervals(16*y+8,x);
+        for(int i=0;i<count;i++)
+        {
+            int x0=ceilDiv(x[2*i]-8,16);
+            if(n>0) x0=max<int>(x0,spans[n-1].x1+1);
+            addSpan(x0,floorDiv(x[2*i+1]-8,16),3);
+        }
+        return n;
+    }
+
+    //Sample the shape along the sub-scanlines, and collect the pixels
+    //containing an interval endpoint, sorted and without duplicates.
+    //Between two of those pixels the coverage is constant
+    int x[subScanlines][2*maxIntervals];
+    int count[subScanlines];
+    int edges[subScanlines*2*maxIntervals];
+    int numEdges=0;
+    for(int i=0;i<subScanlines;i++)
+    {
+        count[i]=intervals(16*y+16/(2*subScanlines)+i*16/subScanlines,x[i]);
+        for(int j=0;j<2*count[i];j++)
+        {
+            //Interval ends are excluded
+            int e=floorDiv(j & 1 ? x[i][j]-1 : x[i][j],16);
+            int k=numEdges;
+            while(k>0 && edges[k-1]>e) k--;
+            if(k>0 && edges[k-1]==e) continue;
+            for(int h=numEdges;h>k;h--) edges[h]=edges[h-1];
+            edges[k]=e;
+            numEdges++;
+        }
+    }
+    auto level=[&](int px)
+    {
+        int coverage=0; //Up to 16*subScanlines
+        for(int i=0;i<subScanlines;i++)
+            for(int j=0;j<count[i];j++)
+                coverage+=max(0,min(x[i][2*j+1],16*px+16)-max(x[i][2*j],16*px));
+        return (coverage*3+8*subScanlines)/(16*subScanlines);
+    };
+    for(int i=0;i<numEdges;i++)
+    {
+        if(edges[i]>xmax) break;
+        addSpan(edges[i],edges[i],level(edges[i]));
+        if(i+1<numEdges && edges[i+1]>edges[i]+1)
+            addSpan(edges[i]+1,edges[i+1]-1,level(edges[i]+1));
+    }
+    return n;
+}
+
+ShapeRasteriser::~ShapeRasteriser() {}
+
+//
+// class EllipseRasteriser
+//
+
+EllipseRasteriser::EllipseRasteriser(Point c, short int rx, short int ry,
+        short int thickness, bool antialiased)
+    : ShapeRasteriser(c.y()-ry,c.y()+ry,antialiased),
+      cx(16*c.x()+8), cy(16*c.y()+8), ox(16*rx+8), oy(16*ry+8), ix(0), iy(0)
+{
+    //The outer radius is extended by half a pixel so that the ellipse
+    //touches the pixels at distance rx and ry from the center
+    if(thickness>0 && thickness<=rx && thickness<=ry)
+    {
+        ix=ox-16*thickness;
+        iy=oy-16*thickness;
+    }
+}
+
+int EllipseRasteriser::intervals(int y, int *x) const
+{
+    int dy=y-cy;
+    int half=ellipseHalfWidth(ox,oy,dy);
+    if(half<=0) return 0;
+    x[0]=cx-half;
+    if(iy>0)
+    {
+        int innerHalf=ellipseHalfWidth(ix,iy,dy);
+        if(innerHalf>0)
+        {
+            x[1]=cx-innerHalf;
+            x[2]=cx+innerHalf;
+            x[3]=cx+half;
+            return 2;
+        }
+    }
+    x[1]=cx+half;
+    return 1;
+}
+
+//
+// class RoundedRectangleRasteriser
+//
+
+/**
+ * Compute the interval covered by a rounded rectangle along a line
+ * \param y the line
+ * \param x0 left side, included
+ * \param y0 top side, included
+ * \param x1 right side, excluded
+ * \param y1 bottom side, excluded
+ * \param r radius of the corners
+ * \param result the interval is written here
+ * \return true if the line intersects the rectangle
+ */
+static bool roundedRectangleInterval(int y, int x0, int y0, int x1, int y1,
+        int r, int *result)
+{
+    if(x0>=x1 || y<y0 || y>=y1) return false;
+    int inset=0;
+    int dy=0;
+    if(y<y0+r) dy=y0+r-y;
+    else if(y>=y1-r) dy=y-(y1-r);
+    if(dy>0) inset=r-isqrt(static_cast<long long>(r)*r-
+                           static_cast<long long>(dy)*dy);
+    if(x0+inset>=x1-inset) return false;
+    result[0]=x0+inset;
+    result[1]=x1-inset;
+    return true;
+}
+
+RoundedRectangleRasteriser::RoundedRectangleRasteriser(Point a, Point b,
+        short int r, short int thickness, bool antialiased)
+    : ShapeRasteriser(a.y(),b.y(),antialiased),
+      ox0(16*a.x()), oy0(16*a.y()), ox1(16*b.x()+16), oy1(16*b.y()+16)
+{
+    r=max<short>(0,min<short>(r,min(b.x()-a.x(),b.y()-a.y())/2));
+    //As for circles, the corners touch the pixels at distance r from their
+    //center, which lies in the middle of a pixel
+    oradius= r>0 ? 16*r+8 : 0;
+    if(thickness>0)
+    {
+        ix0=ox0+16*thickness;
+        iy0=oy0+16*thickness;
+        ix1=ox1-16*thickness;
+        iy1=oy1-16*thickness;
+        iradius=max(0,oradius-16*thickness);
+    } else ix0=iy0=ix1=iy1=iradius=0;
+}
+
+int RoundedRectangleRasteriser::intervals(int y, int *x) const
+{
+    if(!roundedRectangleInterval(y,ox0,oy0,ox1,oy1,oradius,x)) return 0;
+    int inner[2];
+    if(!roundedRectangleInterval(y,ix0,iy0,ix1,iy1,iradius,inner)) return 1;
+    x[3]=x[1];
+    x[1]=inner[0];
+    x[2]=inner[1];
+    return 2;
+}
+
+//
+// class ArcRasteriser
+//
+
+ArcRasteriser::ArcRasteriser(Point c, short int r, short int thickness,
+        short int startAngle, short int endAngle, bool antialiased)
+    : ShapeRasteriser(c.y()-r,c.y()+r,antialiased),
+      cx(16*c.x()+8), cy(16*c.y()+8), outer(16*r+8),
+      inner(max(0,outer-16*thickness))
+{
+    const float toRadians=3.14159265f/180.0f;
+    ux0=lroundf(1024.0f*cosf(startAngle*toRadians));
+    uy0=lroundf(1024.0f*sinf(startAngle*toRadians));
+    ux1=lroundf(1024.0f*cosf(endAngle*toRadians));
+    uy1=lroundf(1024.0f*sinf(endAngle*toRadians));
+    int angle=endAngle-startAngle;
+    if(angle>=360) sweep=Full;
+    else sweep=((angle%360)+360)%360<=180 ? Narrow : Wide;
+}
+
+int ArcRasteriser::intervals(int y, int *x) const
+{
+    int dy=y-cy;
+    int half=ellipseHalfWidth(outer,outer,dy);
+    if(half<=0) return 0;
+    int ring[4]={cx-half,cx+half};
+    int numRing=1;
+    int innerHalf= inner>0 ? ellipseHalfWidth(inner,inner,dy) : -1;
+    if(innerHalf>0)
+    {
+        ring[3]=ring[1];
+        ring[1]=cx-innerHalf;
+        ring[2]=cx+innerHalf;
+        numRing=2;
+    }
+    if(sweep==Full)
+    {
+        copy(ring,ring+2*numRing,x);
+        return numRing;
+    }
+
+    //A sector up to 180 degrees is the part of the plane on the clockwise
+    //side of the start direction and on the counterclockwise side of the
+    //end direction. Wider sectors are the complement of the sector from the
+    //end to the start direction
+    int a0, a1, b0, b1;
+    if(sweep==Narrow)
+    {
+        halfPlane(ux0,uy0,dy,1,a0,a1);
+        halfPlane(ux1,uy1,dy,-1,b0,b1);
+    } else {
+        halfPlane(ux1,uy1,dy,1,a0,a1);
+        halfPlane(ux0,uy0,dy,-1,b0,b1);
+    }
+    int s0=max(a0,b0);
+    int s1=min(a1,b1);
+    //The sector is computed relative to the center
+    auto absolute=[this](int v)
+    {
+        return v<=-unbounded || v>=unbounded ? v : cx+v;
+    };
+    int sector[4];
+    int numSector=0;
+    if(sweep==Narrow)
+    {
+        if(s0>=s1) return 0;
+        sector[0]=absolute(s0);
+        sector[1]=absolute(s1);
+        numSector=1;
+    } else if(s0>=s1) {
+        sector[0]=-unbounded;
+        sector[1]=unbounded;
+        numSector=1;
+    } else {
+        if(s0>-unbounded)
+        {
+            sector[0]=-unbounded;
+            sector[1]=absolute(s0);
+            numSector=1;
+        }
+        if(s1<unbounded)
+        {
+            sector[2*numSector]=absolute(s1);
+            sector[2*numSector+1]=unbounded;
+            numSector++;
+        }
+    }
+    return intersect(ring,numRing,sector,numSector,x);
+}
+
+//
+// class PolygonRasteriser
+//
+
+PolygonRasteriser::PolygonRasteriser(const Point *points, int numPoints,
+        FillRule::FillRule_ rule, short int clipTop)
+    : numEdges(0), nextEdge(0), numActive(0), rule(rule), y(0), firstRow(0),
+      lastRow(-1)
+{
+    if(numPoints<3 || numPoints>maxVertices) return;
+    int minRow=numeric_limits<short>::max();
+    int maxRow=numeric_limits<short>::min();
+    for(int i=0;i<numPoints;i++)
+    {
+        Point a=points[i];
+        Point b=points[i+1<numPoints ? i+1 : 0];
+        //Horizontal edges cross no pixel center
+        if(a.y()==b.y()) continue;
+        PolygonEdge e;
+        e.winding=1;
+        if(a.y()>b.y())
+        {
+            swap(a,b);
+            e.winding=-1;
+        }
+        if(b.y()<=clipTop) continue;
+        e.dy=b.y()-a.y();
+        int dx=b.x()-a.x();
+        e.step=floorDiv(dx,e.dy);
+        e.rem=dx-e.step*e.dy;
+        e.top=max(a.y(),clipTop);
+        e.bottom=b.y();
+        //Start from the first visible row
+        long long num=static_cast<long long>(e.top-a.y())*dx;
+        long long whole=num/e.dy;
+        if(whole*e.dy>num) whole--;
+        e.x=a.x()+whole;
+        e.err=num-whole*e.dy;
+        minRow=min<int>(minRow,e.top);
+        maxRow=max<int>(maxRow,e.bottom-1);
+        //Insertion sort by top row
+        int j=numEdges++;
+        for(;j>0 && edges[j-1].top>e.top;j--) edges[j]=edges[j-1];
+        edges[j]=e;
+    }
+    if(numEdges==0) return;
+    firstRow=y=minRow;
+    lastRow=maxRow;
+}
+
+int PolygonRasteriser::nextRow(short int xmin, short int xmax,
+        ShapeSpan *spans)
+{
+    //Update the active edge list
+    while(nextEdge<numEdges && edges[nextEdge].top<=y)
+        active[numActive++]=nextEdge++;
+    int j=0;
+    for(int i=0;i<numActive;i++)
+        if(edges[active[i]].bottom>y) active[j++]=active[i];
+    numActive=j;
+
+    //The first pixel at or after the crossing is the first one inside
+    auto first=[this](int i)
+    {
+        const PolygonEdge& e=edges[active[i]];
+        return e.err>0 ? e.x+1 : e.x;
+    };
+    //Edges are already almost sorted from the previous row
+    for(int i=1;i<numActive;i++)
+    {
+        unsigned char a=active[i];
+        int x=first(i);
+        int k=i;
+        for(;k>0 && first(k-1)>x;k--) active[k]=active[k-1];
+        active[k]=a;
+    }
+
+    int n=0;
+    int winding=0;
+    int start=0;
+    for(int i=0;i<numActive;i++)
+    {
+        bool wasInside=winding!=0;
+        if(rule==FillRule::NonZero) winding+=edges[active[i]].winding;
+        else winding^=1;
+        bool inside=winding!=0;
+        if(inside==wasInside) continue;
+        if(inside) start=first(i);
+        else {
+            int x0=max<int>(start,xmin);
+            int x1=min<int>(first(i)-1,xmax);
+            if(x0>x1) continue;
+            //Coincident edges may produce contiguous spans
+            if(n>0 && spans[n-1].x1+1==x0) spans[n-1].x1=x1;
+            else {
+                spans[n].x0=x0;
+                spans[n].x1=x1;
+                spans[n].level=3;
+                n++;
+            }
+        }
+    }
+
+    //Step the active edges to the next row
+    for(int i=0;i<numActive;i++)
+    {
+        PolygonEdge& e=edges[active[i]];
+        int err=e.err+e.rem;
+        e.x+=e.step;
+        if(err>=e.dy)
+        {
+            err-=e.dy;
+            e.x++;
+        }
+        e.err=err;
+    }
+    y++;
+    return n;
+}
+
+} //namespace impl
+} //namespace mxgui
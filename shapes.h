@@ -0,0 +1,632 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "mxgui_settings.h"
+#include "point.h"
+#include "color.h"
+#include "font.h"
+#include <algorithm>
+
+namespace mxgui {
+
+/**
+ * This class just encapsulates the FillRule_ enum so that the enum names
+ * don't clobber the global namespace.
+ */
+class FillRule
+{
+public:
+    /**
+     * Rules to decide which parts of a self intersecting or concave polygon
+     * are inside it
+     */
+    enum FillRule_
+    {
+        NonZero, ///< Inside if the edges wind around the point
+        EvenOdd  ///< Inside if a ray from the point crosses an odd number of edges
+    };
+
+private:
+    FillRule(); //Just a wrapper class, disallow creating instances
+};
+
+namespace impl {
+
+/**
+ * \internal
+ * An horizontal span produced by a ShapeRasteriser
+ */
+struct ShapeSpan
+{
+    short int x0;        ///< First pixel of the span
+    short int x1;        ///< Last pixel of the span
+    unsigned char level; ///< Coverage, from 1 to 3 as the antialiasing palette
+};
+
+/**
+ * \internal
+ * Base class of the shape rasterisers. Shapes are described by the
+ * intervals they cover along an horizontal line, in fixed point with four
+ * fractional bits, and converted to spans one pixel row at a time.
+ * Without antialiasing a pixel is drawn if its center is inside the shape or
+ * on its edge, with antialiasing the coverage is accumulated over four
+ * sub-scanlines and quantized to the four levels of the antialiasing
+ * palette. Consecutive
+ * pixels with the same coverage are merged in a single span, so only the
+ * pixels along the edges cost more than the interior of the shape.
+ */
+class ShapeRasteriser
+{
+public:
+    static const int subScanlines=4; ///< Sub-scanlines when antialiased
+    static const int maxIntervals=4; ///< Max intervals along a line
+    /// Max spans in a pixel row, each interval endpoint in a sub-scanline can
+    /// add an edge pixel and a span of constant coverage after it
+    static const int maxSpans=subScanlines*maxIntervals*2*2;
+
+    /**
+     * Constructor
+     * \param top first pixel row of the shape
+     * \param bottom last pixel row of the shape
+     * \param antialiased true if edges are antialiased
+     */
+    ShapeRasteriser(short int top, short int bottom, bool antialiased)
+        : topRow(top), bottomRow(bottom), antialiased(antialiased) {}
+
+    /**
+     * Rasterise a row of pixels
+     * \param y row
+     * \param xmin spans are clipped to this first pixel
+     * \param xmax spans are clipped to this last pixel
+     * \param spans spans are written here, array of at least maxSpans
+     * \return the number of spans, left to right
+     */
+    int row(short int y, short int xmin, short int xmax, ShapeSpan *spans) const;
+
+    /**
+     * \return the first pixel row of the shape
+     */
+    short int top() const { return topRow; }
+
+    /**
+     * \return the last pixel row of the shape
+     */
+    short int bottom() const { return bottomRow; }
+
+    /**
+     * Destructor
+     */
+    virtual ~ShapeRasteriser();
+
+protected:
+    /**
+     * Compute the intervals covered by the shape along an horizontal line
+     * \param y line, in sixteenths of a pixel. Pixel row n spans from
+     * 16*n to 16*n+16 excluded
+     * \param x intervals are written here as pairs of begin and end, end is
+     * excluded, also in sixteenths of a pixel. Intervals must be sorted and
+     * not overlapping
+     * \return the number of intervals, at most maxIntervals
+     */
+    virtual int intervals(int y, int *x) const=0;
+
+private:
+    short int topRow, bottomRow;
+    bool antialiased;
+};
+
+/**
+ * \internal
+ * Rasteriser for filled and outlined circles and ellipses
+ */
+class EllipseRasteriser : public ShapeRasteriser
+{
+public:
+    /**
+     * Constructor
+     * \param c center
+     * \param rx horizontal radius
+     * \param ry vertical radius
+     * \param thickness thickness of the outline, 0 for a filled ellipse
+     * \param antialiased true if edges are antialiased
+     */
+    EllipseRasteriser(Point c, short int rx, short int ry, short int thickness,
+            bool antialiased);
+
+protected:
+    int intervals(int y, int *x) const override;
+
+private:
+    int cx, cy;   ///< Center, in sixteenths of a pixel
+    int ox, oy;   ///< Outer radii, in sixteenths of a pixel
+    int ix, iy;   ///< Inner radii, or 0 if the ellipse is filled
+};
+
+/**
+ * \internal
+ * Rasteriser for filled and outlined rectangles with rounded corners
+ */
+class RoundedRectangleRasteriser : public ShapeRasteriser
+{
+public:
+    /**
+     * Constructor
+     * \param a upper left corner
+     * \param b lower right corner
+     * \param r radius of the corners
+     * \param thickness thickness of the outline, 0 for a filled rectangle
+     * \param antialiased true if edges are antialiased
+     */
+    RoundedRectangleRasteriser(Point a, Point b, short int r,
+            short int thickness, bool antialiased);
+
+protected:
+    int intervals(int y, int *x) const override;
+
+private:
+    int ox0, oy0, ox1, oy1, oradius; ///< Outer shape, in sixteenths of a pixel
+    int ix0, iy0, ix1, iy1, iradius; ///< Inner shape, ix0>=ix1 if filled
+};
+
+/**
+ * \internal
+ * Rasteriser for arcs of a circle with a given thickness
+ */
+class ArcRasteriser : public ShapeRasteriser
+{
+public:
+    /**
+     * Constructor
+     * \param c center
+     * \param r outer radius
+     * \param thickness thickness of the arc
+     * \param startAngle start angle in degrees
+     * \param endAngle end angle in degrees
+     * \param antialiased true if edges are antialiased
+     */
+    ArcRasteriser(Point c, short int r, short int thickness,
+            short int startAngle, short int endAngle, bool antialiased);
+
+protected:
+    int intervals(int y, int *x) const override;
+
+private:
+    int cx, cy;     ///< Center, in sixteenths of a pixel
+    int outer;      ///< Outer radius, in sixteenths of a pixel
+    int inner;      ///< Inner radius, or 0 if the arc reaches the center
+    int ux0, uy0;   ///< Start direction, scaled by 1024
+    int ux1, uy1;   ///< End direction, scaled by 1024
+    enum { Full, Narrow, Wide } sweep; ///< 360, up to 180, more than 180
+};
+
+/**
+ * \internal
+ * An edge of a polygon, stepped one pixel row at a time with an exact integer
+ * DDA. The edge crosses the center of the current row at x+err/dy
+ */
+struct PolygonEdge
+{
+    int x;                  ///< Integer part of the crossing
+    int step;               ///< Integer part of the increment per row
+    unsigned short err;     ///< Fractional part of the crossing
+    unsigned short rem;     ///< Fractional part of the increment per row
+    unsigned short dy;      ///< Denominator of the fractional parts
+    short int top;          ///< First row crossed by the edge
+    short int bottom;       ///< Row after the last one crossed by the edge
+    signed char winding;    ///< 1 if the edge goes downwards, -1 if upwards
+};
+
+/**
+ * \internal
+ * Scanline rasteriser for polygons. Edges are kept in an edge table sorted
+ * by their first row, and moved to the active edge list when the scanline
+ * reaches them, so each row only costs as much as the edges crossing it.
+ * All storage is within the class, so no memory is allocated.
+ * Vertices are at the pixel centers, and a pixel is drawn if its center is
+ * inside the polygon, with the pixels exactly on the right and bottom edges
+ * excluded, so that polygons sharing an edge neither overlap nor leave gaps.
+ */
+class PolygonRasteriser
+{
+public:
+    static const int maxVertices=32;          ///< Max vertices of a polygon
+    static const int maxSpans=maxVertices/2;  ///< Max spans in a pixel row
+
+    /**
+     * Constructor
+     * \param points vertices of the polygon
+     * \param numPoints number of vertices, if greater than maxVertices the
+     * polygon is not drawn
+     * \param rule fill rule
+     * \param clipTop rows above this are skipped
+     */
+    PolygonRasteriser(const Point *points, int numPoints,
+            FillRule::FillRule_ rule, short int clipTop);
+
+    /**
+     * \return the first pixel row to draw
+     */
+    short int top() const { return firstRow; }
+
+    /**
+     * \return the last pixel row to draw
+     */
+    short int bottom() const { return lastRow; }
+
+    /**
+     * Rasterise the next row, starting from top()
+     * \param xmin spans are clipped to this first pixel
+     * \param xmax spans are clipped to this last pixel
+     * \param spans spans are written here, array of at least maxSpans
+     * \return the number of spans, left to right
+     */
+    int nextRow(short int xmin, short int xmax, ShapeSpan *spans);
+
+private:
+    PolygonEdge edges[maxVertices];      ///< Edge table, sorted by top row
+    unsigned char active[maxVertices];   ///< Active edges, sorted by x
+    unsigned char numEdges;              ///< Number of edges
+    unsigned char nextEdge;              ///< First edge not yet active
+    unsigned char numActive;             ///< Number of active edges
+    FillRule::FillRule_ rule;            ///< Fill rule
+    short int y;                         ///< Row that nextRow() will draw
+    short int firstRow, lastRow;         ///< Rows to draw
+};
+
+/**
+ * \internal
+ * Draw a polygon as horizontal spans through the clear() fill primitive,
+ * clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param polygon polygon to draw
+ * \param color fill color
+ */
+template<typename T>
+void drawPolygon(T& surface, PolygonRasteriser& polygon, Color color)
+{
+    using namespace std;
+    short int bottom=min<short>(surface.getHeight()-1,polygon.bottom());
+    short int xmax=surface.getWidth()-1;
+    ShapeSpan spans[PolygonRasteriser::maxSpans];
+    for(short int y=polygon.top();y<=bottom;y++)
+    {
+        int n=polygon.nextRow(0,xmax,spans);
+        for(int i=0;i<n;i++)
+            surface.clear(Point(spans[i].x0,y),Point(spans[i].x1,y),color);
+    }
+}
+
+/**
+ * \internal
+ * Draw a shape as horizontal spans through the clear() fill primitive,
+ * clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param shape shape to draw
+ * \param fg shape color
+ * \param bg color the antialiased edges are blended with
+ */
+template<typename T>
+void drawShape(T& surface, const ShapeRasteriser& shape, Color fg, Color bg)
+{
+    using namespace std;
+    Color palette[4];
+    Font::generatePalette(palette,fg,bg);
+    short int top=max<short>(0,shape.top());
+    short int bottom=min<short>(surface.getHeight()-1,shape.bottom());
+    short int xmax=surface.getWidth()-1;
+    ShapeSpan spans[ShapeRasteriser::maxSpans];
+    for(short int y=top;y<=bottom;y++)
+    {
+        int n=shape.row(y,0,xmax,spans);
+        for(int i=0;i<n;i++)
+            surface.clear(Point(spans[i].x0,y),Point(spans[i].x1,y),
+                          palette[spans[i].level]);
+    }
+}
+
+} //namespace impl
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled circle. The circle is drawn as horizontal spans through
+ * clear(), and clipped to the surface.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param r radius, the circle fits in a square of 2*r+1 pixels
+ * \param color fill color
+ */
+template<typename T>
+void fillCircle(T& surface, Point c, short int r, Color color)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,r,r,0,false),color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled circle with antialiased edges
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param r radius, the circle fits in a square of 2*r+1 pixels
+ * \param color fill color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void fillCircle(T& surface, Point c, short int r, Color color, Color bg)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,r,r,0,true),color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw the outline of a circle
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param r radius, the circle fits in a square of 2*r+1 pixels
+ * \param color line color
+ */
+template<typename T>
+void drawCircle(T& surface, Point c, short int r, Color color)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,r,r,1,false),color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw the outline of a circle with antialiased edges
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param r radius, the circle fits in a square of 2*r+1 pixels
+ * \param color line color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void drawCircle(T& surface, Point c, short int r, Color color, Color bg)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,r,r,1,true),color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled ellipse with the axes parallel to the screen
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param rx horizontal radius
+ * \param ry vertical radius
+ * \param color fill color
+ */
+template<typename T>
+void fillEllipse(T& surface, Point c, short int rx, short int ry, Color color)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,rx,ry,0,false),color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled ellipse with antialiased edges
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param rx horizontal radius
+ * \param ry vertical radius
+ * \param color fill color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void fillEllipse(T& surface, Point c, short int rx, short int ry, Color color,
+        Color bg)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,rx,ry,0,true),color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw the outline of an ellipse with the axes parallel to the screen
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param rx horizontal radius
+ * \param ry vertical radius
+ * \param color line color
+ */
+template<typename T>
+void drawEllipse(T& surface, Point c, short int rx, short int ry, Color color)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,rx,ry,1,false),color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw the outline of an ellipse with antialiased edges
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param rx horizontal radius
+ * \param ry vertical radius
+ * \param color line color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void drawEllipse(T& surface, Point c, short int rx, short int ry, Color color,
+        Color bg)
+{
+    impl::drawShape(surface,impl::EllipseRasteriser(c,rx,ry,1,true),color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw an arc of a circle. Angles are in degrees, 0 points to the right and
+ * angles grow clockwise, as the y axis of the screen points downwards.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param r outer radius
+ * \param thickness thickness of the arc, if greater than r a pie slice is
+ * drawn
+ * \param startAngle the arc is drawn clockwise starting from this angle
+ * \param endAngle up to this angle. If endAngle-startAngle>=360 a full ring
+ * is drawn
+ * \param color arc color
+ */
+template<typename T>
+void drawArc(T& surface, Point c, short int r, short int thickness,
+        short int startAngle, short int endAngle, Color color)
+{
+    impl::drawShape(surface,impl::ArcRasteriser(c,r,thickness,startAngle,
+        endAngle,false),color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw an arc of a circle with antialiased edges
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param c center
+ * \param r outer radius
+ * \param thickness thickness of the arc, if greater than r a pie slice is
+ * drawn
+ * \param startAngle the arc is drawn clockwise starting from this angle
+ * \param endAngle up to this angle. If endAngle-startAngle>=360 a full ring
+ * is drawn
+ * \param color arc color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void drawArc(T& surface, Point c, short int r, short int thickness,
+        short int startAngle, short int endAngle, Color color, Color bg)
+{
+    impl::drawShape(surface,impl::ArcRasteriser(c,r,thickness,startAngle,
+        endAngle,true),color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled rectangle with rounded corners
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param a upper left corner
+ * \param b lower right corner
+ * \param r radius of the corners, 0 draws a rectangle
+ * \param color fill color
+ */
+template<typename T>
+void fillRoundedRectangle(T& surface, Point a, Point b, short int r,
+        Color color)
+{
+    impl::drawShape(surface,impl::RoundedRectangleRasteriser(a,b,r,0,false),
+        color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled rectangle with rounded and antialiased corners
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param a upper left corner
+ * \param b lower right corner
+ * \param r radius of the corners, 0 draws a rectangle
+ * \param color fill color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void fillRoundedRectangle(T& surface, Point a, Point b, short int r,
+        Color color, Color bg)
+{
+    impl::drawShape(surface,impl::RoundedRectangleRasteriser(a,b,r,0,true),
+        color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw the outline of a rectangle with rounded corners
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param a upper left corner
+ * \param b lower right corner
+ * \param r radius of the corners, 0 draws a rectangle
+ * \param color line color
+ */
+template<typename T>
+void drawRoundedRectangle(T& surface, Point a, Point b, short int r,
+        Color color)
+{
+    impl::drawShape(surface,impl::RoundedRectangleRasteriser(a,b,r,1,false),
+        color,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw the outline of a rectangle with rounded and antialiased corners
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param a upper left corner
+ * \param b lower right corner
+ * \param r radius of the corners, 0 draws a rectangle
+ * \param color line color
+ * \param bg color of the background, edge pixels are blended with it
+ */
+template<typename T>
+void drawRoundedRectangle(T& surface, Point a, Point b, short int r,
+        Color color, Color bg)
+{
+    impl::drawShape(surface,impl::RoundedRectangleRasteriser(a,b,r,1,true),
+        color,bg);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled polygon, either convex or concave. The polygon is drawn as
+ * horizontal spans through clear(), and clipped to the surface. Pixels
+ * exactly on the right and bottom edges are not drawn, so polygons sharing
+ * an edge, such as the triangles of a mesh, neither overlap nor leave gaps.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param points vertices of the polygon, the last one is connected to the
+ * first one
+ * \param numPoints number of vertices, at most 32, larger polygons are not
+ * drawn
+ * \param color fill color
+ * \param rule fill rule for self intersecting polygons
+ */
+template<typename T>
+void fillPolygon(T& surface, const Point *points, int numPoints, Color color,
+        FillRule::FillRule_ rule=FillRule::NonZero)
+{
+    impl::PolygonRasteriser polygon(points,numPoints,rule,0);
+    impl::drawPolygon(surface,polygon,color);
+}
+
+/**
+ * \ingroup pub_iface
+ * Draw a filled triangle. As with fillPolygon() pixels exactly on the
+ * right and bottom edges are not drawn.
+ * \param surface a Display, DrawingContext or DrawingContextProxy
+ * \param a first vertex
+ * \param b second vertex
+ * \param c third vertex
+ * \param color fill color
+ */
+template<typename T>
+void fillTriangle(T& surface, Point a, Point b, Point c, Color color)
+{
+    const Point points[]={a,b,c};
+    impl::PolygonRasteriser polygon(points,3,FillRule::NonZero,0);
+    impl::drawPolygon(surface,polygon,color);
+}
+
+} //namespace mxgui
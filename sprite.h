@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "point.h"
+#include "color.h"
+#include <algorithm>
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface
+ * An image with transparent pixels, compiled statically with the code, for
+ * games, cursors and other non rectangular UI elements.
+ *
+ * Sprites are generated by the pngconverter tool with the --sprite option,
+ * which makes transparent the pixels that are transparent in the png, or
+ * with the --colorkey option, which makes transparent the pixels of a given
+ * color. Each line is stored as a sequence of runs, made of the number of
+ * transparent pixels to skip followed by the number of opaque pixels to
+ * copy, and only opaque pixels are stored. Transparent pixels thus cost
+ * nothing both in memory and when drawing, and opaque pixels are drawn one
+ * run at a time with scanLine().
+ *
+ * The run data of each line is the number of runs, followed by a skip and
+ * copy length pair for each run. The skip length of a run is relative to the
+ * end of the previous run.
+ *
+ * Sprites are immutable except they can be assigned with operator=
+ */
+template<typename T>
+class basic_sprite
+{
+public:
+    /**
+     * Construct a sprite
+     * \param height the sprite's height
+     * \param width the sprite's width
+     * \param runs the run data. Ownership of the data is still of the caller,
+     * as with basic_image
+     * \param pixels the opaque pixels, in the order they are drawn
+     */
+    basic_sprite(short int height, short int width,
+            const unsigned short *runs, const void *pixels)
+            : height(height), width(width), runs(runs),
+              pixels(reinterpret_cast<const T*>(pixels)) {}
+
+    /**
+     * \return the sprite's height
+     */
+    short int getHeight() const { return height; }
+
+    /**
+     * \return the sprite's width
+     */
+    short int getWidth() const { return width; }
+
+    /**
+     * Call a function for each run of opaque pixels within a clipping
+     * rectangle, from top to bottom and from left to right. Useful for
+     * display drivers that draw sprites in an optimized way.
+     * \param p point of the upper left corner where the sprite will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param f a callable with signature
+     * void (Point start, const T *pixels, short length)
+     * that is called for each horizontal run of opaque pixels
+     */
+    template<typename F>
+    void clippedDrawSpans(Point p, Point a, Point b, F&& f) const;
+
+    //Uses default copy constructor and operator=
+private:
+    short int height, width;
+    const unsigned short *runs;
+    const T *pixels;
+};
+
+template<typename T> template<typename F>
+void basic_sprite<T>::clippedDrawSpans(Point p, Point a, Point b,
+        F&& f) const
+{
+    using namespace std;
+    short xa=max(p.x(),a.x());
+    short xb=min<short>(p.x()+width-1,b.x());
+    short ya=max(p.y(),a.y());
+    short yb=min<short>(p.y()+height-1,b.y());
+    if(xa>xb || ya>yb) return; //Empty intersection
+
+    const unsigned short *r=runs;
+    const T *pix=pixels;
+    //Lines above the clipping rectangle are only walked through to find
+    //where the following lines start
+    for(short y=p.y();y<ya;y++)
+    {
+        unsigned short n=*r++;
+        for(unsigned short i=0;i<n;i++,r+=2) pix+=r[1];
+    }
+    for(short y=ya;y<=yb;y++)
+    {
+        unsigned short n=*r++;
+        short x=p.x();
+        for(unsigned short i=0;i<n;i++,r+=2)
+        {
+            x+=r[0];
+            short length=r[1];
+            short s=max(x,xa);
+            short e=min<short>(x+length-1,xb);
+            if(s<=e) f(Point(s,y),pix+(s-x),e-s+1);
+            x+=length;
+            pix+=length;
+        }
+    }
+}
+
+/// \ingroup pub_iface
+/// Define the Sprite class
+typedef basic_sprite<Color> Sprite;
+
+} //namespace mxgui
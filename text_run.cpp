@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "text_run.h"
+#include "misc_inst.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace mxgui {
+
+//
+// class TextRun
+//
+
+TextRun::TextRun() : font(defaultFont), offsets(1,0) {}
+
+void TextRun::assign(const Font& font, const char *s)
+{
+    this->font=font;
+    glyphs.clear();
+    offsets.assign(1,0);
+    glyphs.reserve(miosix::Unicode::countCodePoints(s));
+    offsets.reserve(glyphs.capacity()+1);
+    short int x=0;
+    while(char32_t c=miosix::Unicode::nextUtf8(s))
+    {
+        glyphs.push_back(font.getVirtualCodepoint(c));
+        x+=font.calculateLength(c);
+        offsets.push_back(x);
+    }
+}
+
+unsigned int TextRun::glyphAt(short int x) const
+{
+    if(x<0) return 0;
+    //First glyph ending after x
+    return upper_bound(offsets.begin()+1,offsets.end(),x)-offsets.begin()-1;
+}
+
+bool TextRun::visibleRange(Point p, Point a, Point b, unsigned int& first,
+        unsigned int& last) const
+{
+    if(b.x()<p.x() || a.x()>=p.x()+getWidth()) return false;
+    first=glyphAt(a.x()-p.x());
+    last=glyphAt(b.x()-p.x())+1;
+    return true;
+}
+
+} //namespace mxgui
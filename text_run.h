@@ -0,0 +1,206 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "font.h"
+#include <string>
+#include <vector>
+
+namespace mxgui {
+
+/**
+ * \ingroup pub_iface
+ * A string resolved once into the glyphs of a Font, for text that is drawn
+ * many times, such as static labels and menus. Writing a string decodes its
+ * UTF-8 and looks up the glyph of each character every time, and clipped
+ * writes also walk all the characters left of the clipping rectangle.
+ * A TextRun stores the glyphs and their x offsets instead, so it is drawn
+ * and measured in a time that only depends on the number of visible glyphs,
+ * with the first one found with a binary search.
+ *
+ * A TextRun is always drawn with the Font it was created with, and uses
+ * six bytes of RAM per character.
+ */
+class TextRun
+{
+public:
+    /**
+     * Default constructor, creates an empty run with the default font
+     */
+    TextRun();
+
+    /**
+     * Constructor
+     * \param font font used to draw the text
+     * \param s a nul terminated UTF-8 string
+     */
+    TextRun(const Font& font, const char *s) : font(font) { assign(font,s); }
+
+    /**
+     * Constructor
+     * \param font font used to draw the text
+     * \param s an UTF-8 string
+     */
+    TextRun(const Font& font, const std::string& s) : TextRun(font,s.c_str()) {}
+
+    /**
+     * Change the text and font of the run
+     * \param font font used to draw the text
+     * \param s a nul terminated UTF-8 string
+     */
+    void assign(const Font& font, const char *s);
+
+    /**
+     * \return the font used to draw the text
+     */
+    const Font& getFont() const { return font; }
+
+    /**
+     * \return the length in pixels of the text, the same value that
+     * Font::calculateLength() would return for the string
+     */
+    short int getWidth() const { return offsets.back(); }
+
+    /**
+     * \return the height of the text
+     */
+    short int getHeight() const { return font.getHeight(); }
+
+    /**
+     * \return the number of glyphs, one per unicode codepoint
+     */
+    unsigned int size() const { return glyphs.size(); }
+
+    /**
+     * \param i glyph index, from 0 to size()
+     * \return the x offset of glyph i from the start of the text, or the
+     * text length if i is size()
+     */
+    short int getOffset(unsigned int i) const { return offsets.at(i); }
+
+    /**
+     * Binary search the glyph covering a given x offset, useful to position
+     * a cursor where the text has been touched
+     * \param x x offset from the start of the text
+     * \return the index of the glyph covering x, 0 if x is negative or
+     * size() if x is beyond the end of the text
+     */
+    unsigned int glyphAt(short int x) const;
+
+    /**
+     * Draw the text on a surface
+     * \tparam pedantic if true, spend extra time calculating the exact number
+     * of pixel that will be drawn, only useful for displays with quirks in the
+     * hardware implementation of pixel_iterator
+     * \param surface an object that provides pixel iterators
+     * \param colors colors for drawing antialiased text
+     * \param p point of the upper left corner where the text will be drawn
+     */
+    template<typename T, bool pedantic=false>
+    void draw(T& surface, Color colors[4], Point p) const
+    {
+        unsigned int last=glyphAt(surface.getWidth()-p.x())+1;
+        font.drawGlyphs<T,pedantic>(surface,colors,p,glyphRange(0,last));
+    }
+
+    /**
+     * Draw part of the text on a surface
+     * \tparam pedantic if true, spend extra time calculating the exact number
+     * of pixel that will be drawn, only useful for displays with quirks in the
+     * hardware implementation of pixel_iterator
+     * \param surface an object that provides pixel iterators
+     * \param colors colors for drawing antialiased text
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     */
+    template<typename T, bool pedantic=false>
+    void clippedDraw(T& surface, Color colors[4],
+        Point p, Point a, Point b) const
+    {
+        unsigned int first, last;
+        if(!visibleRange(p,a,b,first,last)) return;
+        font.clippedDrawGlyphs<T,pedantic>(surface,colors,
+            Point(p.x()+offsets[first],p.y()),a,b,glyphRange(first,last));
+    }
+
+    /**
+     * Walk part of the text and call a functor for each vertical run of
+     * non background pixels, see Font::clippedDrawSpans()
+     * \param p point of the upper left corner where the text will be drawn.
+     * Negative coordinates are allowed, as long as the clipped view has
+     * positive or zero coordinates
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param span functor called as span(Point start, short length,
+     * unsigned char level) for each vertical run of pixels with the same
+     * level
+     */
+    template<typename F>
+    void clippedDrawSpans(Point p, Point a, Point b, F&& span) const
+    {
+        unsigned int first, last;
+        if(!visibleRange(p,a,b,first,last)) return;
+        font.clippedDrawSpansGlyphs(Point(p.x()+offsets[first],p.y()),a,b,
+            glyphRange(first,last),span);
+    }
+
+    //Uses default copy constructor and operator=
+private:
+    /**
+     * Find the glyphs that are at least partially within a clipping rectangle
+     * \param p point of the upper left corner where the text will be drawn
+     * \param a Upper left corner of clipping rectangle
+     * \param b Lower right corner of clipping rectangle
+     * \param first the first visible glyph is returned here
+     * \param last one past the last visible glyph is returned here
+     * \return false if no glyph is visible
+     */
+    bool visibleRange(Point p, Point a, Point b, unsigned int& first,
+            unsigned int& last) const;
+
+    /**
+     * \param first first glyph
+     * \param last one past the last glyph, clamped to size()
+     * \return the glyphs from first to last, to be drawn by Font
+     */
+    Font::ResolvedGlyphs glyphRange(unsigned int first, unsigned int last) const
+    {
+        last=std::min<unsigned int>(last,glyphs.size());
+        return Font::ResolvedGlyphs(glyphs.data()+first,glyphs.data()+last,
+                                    offsets[last]-offsets[first]);
+    }
+
+    Font font;                        ///< Font used to draw the text
+    std::vector<unsigned int> glyphs; ///< Virtual codepoint of each glyph
+    std::vector<short int> offsets;   ///< X offset of each glyph, and length
+};
+
+} //namespace mxgui
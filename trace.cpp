@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "trace.h"
+#include "pthread_lock.h"
+#include <cstdio>
+
+using namespace std;
+
+namespace mxgui {
+
+#ifdef MXGUI_ENABLE_TRACE
+
+//
+// class Tracer
+//
+
+Tracer& Tracer::instance()
+{
+    static Tracer singleton;
+    return singleton;
+}
+
+void Tracer::complete(const char *name, long long start, long long duration,
+                      int arg)
+{
+    if(enabled==false) return;
+    PthreadLock lock(mutex);
+    record('X',name,start,duration,arg);
+}
+
+void Tracer::instant(const char *name, int arg)
+{
+    if(enabled==false) return;
+    long long t=perfTime();
+    PthreadLock lock(mutex);
+    record('i',name,t,0,arg);
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    PthreadLock lock(mutex);
+    this->enabled=enabled;
+}
+
+void Tracer::clear()
+{
+    PthreadLock lock(mutex);
+    head=count=0;
+}
+
+void Tracer::dump(function<void (const char *)> out)
+{
+    bool wasEnabled;
+    unsigned int first, n;
+    {
+        PthreadLock lock(mutex);
+        wasEnabled=enabled;
+        enabled=false;
+        first=(head+traceBufferSize-count) % traceBufferSize;
+        n=count;
+    }
+    //Recording is paused, and record() checks it with the mutex locked, so
+    //records can be accessed without holding the mutex
+    char line[160];
+    out("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for(unsigned int i=0;i<n;i++)
+    {
+        const Record& r=records[(first+i) % traceBufferSize];
+        //Chrome trace timestamps are in microseconds
+        int len=snprintf(line,sizeof(line),
+            "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld.%03d,\"pid\":0,"
+            "\"tid\":%d",r.name,r.phase,r.start/1000,
+            static_cast<int>(r.start%1000),r.tid);
+        if(r.phase=='X')
+            len+=snprintf(line+len,sizeof(line)-len,",\"dur\":%lld.%03d",
+                r.duration/1000,static_cast<int>(r.duration%1000));
+        else len+=snprintf(line+len,sizeof(line)-len,",\"s\":\"t\"");
+        if(r.arg!=-1)
+            len+=snprintf(line+len,sizeof(line)-len,",\"args\":{\"arg\":%d}",
+                r.arg);
+        snprintf(line+len,sizeof(line)-len,"}%s\n",i+1<n ? "," : "");
+        out(line);
+    }
+    out("]}\n");
+    PthreadLock lock(mutex);
+    enabled=wasEnabled;
+}
+
+bool Tracer::dumpToFile(const char *filename)
+{
+    FILE *f=fopen(filename,"w");
+    if(f==NULL) return false;
+    dump([f](const char *s){ fputs(s,f); });
+    return fclose(f)==0;
+}
+
+Tracer::Tracer() : head(0), count(0), numThreads(0), enabled(true)
+{
+    pthread_mutex_init(&mutex,NULL);
+}
+
+void Tracer::record(char phase, const char *name, long long start,
+                    long long duration, int arg)
+{
+    //Checked again with the mutex locked, as dump() relies on this
+    if(enabled==false) return;
+    Record& r=records[head];
+    r.name=name;
+    r.start=start;
+    r.duration=duration;
+    r.arg=arg;
+    r.tid=threadId();
+    r.phase=phase;
+    head=(head+1) % traceBufferSize;
+    if(count<traceBufferSize) count++;
+}
+
+unsigned char Tracer::threadId()
+{
+    pthread_t self=pthread_self();
+    for(unsigned int i=0;i<numThreads;i++)
+        if(pthread_equal(threads[i],self)) return i;
+    //Too many threads, the ones exceeding the limit are shown as one
+    if(numThreads==maxThreads) return maxThreads;
+    threads[numThreads]=self;
+    return numThreads++;
+}
+
+#endif //MXGUI_ENABLE_TRACE
+
+} //namespace mxgui
@@ -0,0 +1,193 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <pthread.h>
+#include "mxgui_settings.h"
+#include "perf_counters.h"
+
+namespace mxgui {
+
+#ifdef MXGUI_ENABLE_TRACE
+
+/**
+ * \ingroup pub_iface
+ * Trace recorder. Only available if MXGUI_ENABLE_TRACE is defined in
+ * mxgui_settings.h. When enabled, mxgui records a timeline of drawing
+ * contexts, graphic primitives, window event loop activity and input events
+ * into a fixed size ring buffer, overwriting the oldest entries when full.
+ * The buffer can be dumped in the Chrome trace JSON format, which can be
+ * opened with chrome://tracing or https://ui.perfetto.dev
+ */
+class Tracer
+{
+public:
+    /**
+     * \return an instance of the trace recorder (singleton)
+     */
+    static Tracer& instance();
+
+    /**
+     * Record an event with a duration
+     * \param name event name, must be a string literal or otherwise outlive
+     * the trace recorder, as only the pointer is stored
+     * \param start event start time, as returned by perfTime()
+     * \param duration event duration in nanoseconds
+     * \param arg optional argument shown in the trace viewer, -1 means none
+     */
+    void complete(const char *name, long long start, long long duration,
+                  int arg=-1);
+
+    /**
+     * Record an event without a duration
+     * \param name event name, must be a string literal or otherwise outlive
+     * the trace recorder, as only the pointer is stored
+     * \param arg optional argument shown in the trace viewer, -1 means none
+     */
+    void instant(const char *name, int arg=-1);
+
+    /**
+     * Start or stop recording. Recording is enabled by default. Stopping the
+     * recording as soon as a frame hitch is detected allows to dump the
+     * events that led to it before they are overwritten
+     * \param enabled true to record events
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * \return true if events are being recorded
+     */
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * Discard all recorded events
+     */
+    void clear();
+
+    /**
+     * Dump the recorded events in Chrome trace JSON format, from the oldest to
+     * the newest. Recording is paused during the dump.
+     * \param out callback that is called multiple times with consecutive
+     * pieces of the JSON output as nul terminated strings, for example to
+     * send them through a serial port. The callback must not draw on a
+     * display or post events, as that would record new events
+     */
+    void dump(std::function<void (const char *)> out);
+
+    /**
+     * Dump the recorded events in Chrome trace JSON format to a file
+     * \param filename file name
+     * \return true on success
+     */
+    bool dumpToFile(const char *filename);
+
+private:
+    Tracer(const Tracer&)=delete;
+    Tracer& operator=(const Tracer&)=delete;
+
+    /**
+     * Constructor
+     */
+    Tracer();
+
+    /**
+     * Record an event. Needs the mutex locked
+     */
+    void record(char phase, const char *name, long long start,
+                long long duration, int arg);
+
+    /**
+     * \return a small integer identifying the calling thread.
+     * Needs the mutex locked
+     */
+    unsigned char threadId();
+
+    /**
+     * A recorded event
+     */
+    struct Record
+    {
+        const char *name;    ///< Event name
+        long long start;     ///< Start time in nanoseconds
+        long long duration;  ///< Duration in nanoseconds
+        int arg;             ///< Optional argument, -1 if none
+        unsigned char tid;   ///< Thread id, see threadId()
+        char phase;          ///< 'X' for complete events, 'i' for instant ones
+    };
+
+    static const unsigned int maxThreads=16;
+
+    pthread_mutex_t mutex;               ///< To serialize concurrent access
+    Record records[traceBufferSize];     ///< Ring buffer of events
+    unsigned int head;                   ///< Next record to be written
+    unsigned int count;                  ///< Number of valid records
+    pthread_t threads[maxThreads];       ///< Threads seen so far
+    unsigned int numThreads;             ///< Number of valid threads entries
+    volatile bool enabled;               ///< True if recording
+};
+
+/**
+ * \internal
+ * RAII class that records an event lasting as long as its scope
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *name, int arg=-1)
+        : name(name), arg(arg), start(perfTime()) {}
+
+    ~TraceScope()
+    {
+        Tracer::instance().complete(name,start,perfTime()-start,arg);
+    }
+
+private:
+    TraceScope(const TraceScope&)=delete;
+    TraceScope& operator=(const TraceScope&)=delete;
+
+    const char *name;
+    int arg;
+    long long start;
+};
+
+/// \internal Record the enclosing scope as a trace event. Arguments are not
+/// evaluated when tracing is disabled
+#define MXGUI_TRACE_SCOPE(...) TraceScope traceScope(__VA_ARGS__)
+
+/// \internal Record an instant trace event
+#define MXGUI_TRACE_INSTANT(...) Tracer::instance().instant(__VA_ARGS__)
+
+#else //MXGUI_ENABLE_TRACE
+
+#define MXGUI_TRACE_SCOPE(...)
+#define MXGUI_TRACE_INSTANT(...) do {} while(0)
+
+#endif //MXGUI_ENABLE_TRACE
+
+} //namespace mxgui
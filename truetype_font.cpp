@@ -0,0 +1,553 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include "truetype_font.h"
+#include "misc_inst.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace mxgui {
+
+#ifdef MXGUI_ENABLE_TRUETYPE
+
+/// A single unicode block spanning all codepoints, virtual codepoints of a
+/// TrueTypeFont are the codepoints themselves
+static const unsigned int allCodepoints[]={0,0x110000,0,1};
+
+/// Maximum nesting level of composite glyphs
+static const int maxCompositeDepth=8;
+
+/// Average bytes per column a cache slot is sized for. Glyphs that don't
+/// fit are still drawn, but rendered each time
+static const int slotBytesPerColumn=8;
+
+/**
+ * Compress a glyph in the Font compressed format
+ * \param levels glyph pixels in column major order, 0 to 3
+ * \param width glyph width
+ * \param height glyph height
+ * \param out compressed glyph is written here, at most width*height bytes
+ * \return the size of the compressed glyph
+ */
+static unsigned int compressGlyph(const unsigned char *levels, int width,
+        int height, unsigned char *out)
+{
+    unsigned int n=0;
+    int repeat=0;
+    for(int x=0;x<width;x++)
+    {
+        const unsigned char *column=levels+x*height;
+        if(x>0 && repeat<32 && memcmp(column,column-height,height)==0)
+        {
+            repeat++;
+            continue;
+        }
+        if(repeat>0) out[n++]=0x80 | (repeat-1);
+        repeat=0;
+        //A trailing background run is implicit, unless it is the only one
+        int end=height;
+        while(end>0 && column[end-1]==0) end--;
+        bool last=end>0 && end<height;
+        if(end==0) end=height;
+        for(int y=0;y<end;)
+        {
+            int length=1;
+            while(y+length<end && column[y+length]==column[y]) length++;
+            out[n++]=column[y]<<5 | (length-1);
+            y+=length;
+        }
+        if(last) out[n-1]|=0x80;
+    }
+    if(repeat>0) out[n++]=0x80 | (repeat-1);
+    return n;
+}
+
+//
+// class TrueTypeFont
+//
+
+TrueTypeFont::TrueTypeFont() : image(nullptr), f(nullptr), cacheHeight(0),
+        maxWidth(0), scratch(nullptr), cache(nullptr), tags(nullptr),
+        lastUsed(nullptr), hits(0), misses(0) {}
+
+TrueTypeFont::TrueTypeFont(const char *filename, unsigned int cacheSize)
+        : TrueTypeFont()
+{
+    open(filename,cacheSize);
+}
+
+TrueTypeFont::TrueTypeFont(const void *image, unsigned int size,
+        unsigned int cacheSize) : TrueTypeFont()
+{
+    open(image,size,cacheSize);
+}
+
+bool TrueTypeFont::open(const char *filename, unsigned int cacheSize)
+{
+    close();
+    f=fopen(filename,"rb");
+    if(f==nullptr) return false;
+    long fileSize;
+    if(fseek(f,0,SEEK_END)!=0 || (fileSize=ftell(f))<0)
+    {
+        close();
+        return false;
+    }
+    size=fileSize;
+    return parseTables(cacheSize);
+}
+
+bool TrueTypeFont::open(const void *image, unsigned int size,
+        unsigned int cacheSize)
+{
+    close();
+    if(image==nullptr) return false;
+    this->image=reinterpret_cast<const unsigned char*>(image);
+    this->size=size;
+    return parseTables(cacheSize);
+}
+
+void TrueTypeFont::close()
+{
+    if(f) fclose(f);
+    delete[] scratch;
+    delete[] cache;
+    delete[] tags;
+    delete[] lastUsed;
+    image=nullptr;
+    f=nullptr;
+    scratch=nullptr;
+    cache=nullptr;
+    tags=nullptr;
+    lastUsed=nullptr;
+    cacheHeight=maxWidth=0;
+    hits=misses=0;
+}
+
+Font TrueTypeFont::getFont(unsigned char height)
+{
+    if(!isOpen()) return defaultFont;
+    height=max<unsigned char>(1,min<unsigned char>(height,maxHeight));
+    reserve(height);
+    return Font(allCodepoints,2,nullptr,height,0,true,this);
+}
+
+bool TrueTypeFont::parseTables(unsigned int cacheSize)
+{
+    this->cacheSize=cacheSize;
+    unsigned int head=0, hhea=0, maxp=0;
+    glyf=loca=hmtx=cmap=0;
+    unsigned short numTables=read16(4);
+    for(int i=0;i<numTables;i++)
+    {
+        unsigned char tag[4];
+        if(!read(12+16*i,tag,4)) break;
+        unsigned int offset=read32(12+16*i+8);
+        if(memcmp(tag,"head",4)==0) head=offset;
+        else if(memcmp(tag,"hhea",4)==0) hhea=offset;
+        else if(memcmp(tag,"maxp",4)==0) maxp=offset;
+        else if(memcmp(tag,"glyf",4)==0) glyf=offset;
+        else if(memcmp(tag,"loca",4)==0) loca=offset;
+        else if(memcmp(tag,"hmtx",4)==0) hmtx=offset;
+        else if(memcmp(tag,"cmap",4)==0) cmap=offset;
+    }
+    if(!head || !hhea || !maxp || !glyf || !loca || !hmtx || !cmap)
+    {
+        close();
+        return false;
+    }
+    unitsPerEm=read16(head+18);
+    longLoca=read16(head+50)!=0;
+    ascender=read16(hhea+4);
+    descender=read16(hhea+6);
+    maxAdvance=read16(hhea+10);
+    numHMetrics=read16(hhea+34);
+    numGlyphs=read16(maxp+4);
+
+    //Prefer a format 12 subtable, as it also maps codepoints above 0xffff
+    unsigned int format4=0, format12=0;
+    unsigned short numSubtables=read16(cmap+2);
+    for(int i=0;i<numSubtables;i++)
+    {
+        unsigned short platform=read16(cmap+4+8*i);
+        unsigned short encoding=read16(cmap+4+8*i+2);
+        if(platform!=0 && (platform!=3 || (encoding!=1 && encoding!=10)))
+            continue;
+        unsigned int subtable=cmap+read32(cmap+4+8*i+4);
+        switch(read16(subtable))
+        {
+            case 4: if(!format4) format4=subtable; break;
+            case 12: if(!format12) format12=subtable; break;
+        }
+    }
+    cmapFormat12=format12!=0;
+    cmap=format12 ? format12 : format4;
+    if(!cmap || unitsPerEm==0 || numHMetrics==0 || numGlyphs==0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TrueTypeFont::read(unsigned int offset, unsigned char *buffer,
+        unsigned int size)
+{
+    if(offset>this->size || size>this->size-offset) return false;
+    if(image)
+    {
+        memcpy(buffer,image+offset,size);
+        return true;
+    }
+    if(fseek(f,offset,SEEK_SET)!=0) return false;
+    return fread(buffer,1,size,f)==size;
+}
+
+unsigned short TrueTypeFont::read16(unsigned int offset)
+{
+    unsigned char b[2];
+    if(!read(offset,b,2)) return 0;
+    return b[0]<<8 | b[1];
+}
+
+unsigned int TrueTypeFont::read32(unsigned int offset)
+{
+    unsigned char b[4];
+    if(!read(offset,b,4)) return 0;
+    return static_cast<unsigned int>(b[0])<<24 | b[1]<<16 | b[2]<<8 | b[3];
+}
+
+unsigned int TrueTypeFont::glyphIndex(char32_t codepoint)
+{
+    unsigned int result=0;
+    if(cmapFormat12)
+    {
+        //Groups of 12 bytes, first codepoint, last codepoint, first glyph
+        unsigned int numGroups=read32(cmap+12);
+        unsigned int lo=0, hi=numGroups;
+        while(lo<hi)
+        {
+            unsigned int mid=(lo+hi)/2;
+            if(read32(cmap+16+12*mid+4)<codepoint) lo=mid+1;
+            else hi=mid;
+        }
+        if(lo==numGroups) return 0;
+        unsigned int group=cmap+16+12*lo;
+        unsigned int start=read32(group);
+        if(codepoint<start) return 0;
+        result=read32(group+8)+codepoint-start;
+    } else {
+        //Segments as four parallel arrays of end codepoints, start
+        //codepoints, deltas and offsets into the glyph index array
+        unsigned int segCountX2=read16(cmap+6);
+        if(codepoint>0xffff || segCountX2==0) return 0;
+        unsigned int ends=cmap+14;
+        unsigned int lo=0, hi=segCountX2/2-1;
+        while(lo<hi)
+        {
+            unsigned int mid=(lo+hi)/2;
+            if(read16(ends+2*mid)<codepoint) lo=mid+1;
+            else hi=mid;
+        }
+        unsigned int start=read16(ends+segCountX2+2+2*lo);
+        if(codepoint<start || read16(ends+2*lo)<codepoint) return 0;
+        unsigned short delta=read16(ends+2*segCountX2+2+2*lo);
+        unsigned int rangeOffset=ends+3*segCountX2+2+2*lo;
+        unsigned short range=read16(rangeOffset);
+        if(range==0) result=(codepoint+delta) & 0xffff;
+        else {
+            result=read16(rangeOffset+range+2*(codepoint-start));
+            if(result) result=(result+delta) & 0xffff;
+        }
+    }
+    return result<numGlyphs ? result : 0;
+}
+
+unsigned short TrueTypeFont::advanceWidth(unsigned int glyph)
+{
+    return read16(hmtx+4*min<unsigned int>(glyph,numHMetrics-1));
+}
+
+void TrueTypeFont::addOutline(unsigned int glyph, const Transform& t,
+        Path& path, int depth)
+{
+    if(depth>maxCompositeDepth || glyph>=numGlyphs) return;
+    unsigned int start, end;
+    if(longLoca)
+    {
+        start=read32(loca+4*glyph);
+        end=read32(loca+4*glyph+4);
+    } else {
+        start=2*read16(loca+2*glyph);
+        end=2*read16(loca+2*glyph+2);
+    }
+    if(end<=start) return; //Glyphs with no outline, such as space
+    unsigned int length=end-start;
+    vector<unsigned char> buffer;
+    const unsigned char *data;
+    if(image)
+    {
+        if(glyf+start>size || length>size-glyf-start) return;
+        data=image+glyf+start;
+    } else {
+        buffer.resize(length);
+        if(!read(glyf+start,buffer.data(),length)) return;
+        data=buffer.data();
+    }
+    //Out of bounds reads return zero, malformed glyphs can't crash
+    auto byte=[=](unsigned int i)->unsigned char
+    {
+        return i<length ? data[i] : 0;
+    };
+    auto be16=[=](unsigned int i)->short
+    {
+        return i+1<length ? data[i]<<8 | data[i+1] : 0;
+    };
+    auto map=[&t](float x, float y, float& px, float& py)
+    {
+        px=t.xx*x+t.yx*y+t.dx;
+        py=t.xy*x+t.yy*y+t.dy;
+    };
+
+    short numContours=be16(0);
+    if(numContours<0)
+    {
+        //Composite glyph, made of other glyphs with a transform each
+        unsigned int pos=10;
+        unsigned short flags;
+        do {
+            flags=be16(pos);
+            unsigned short component=be16(pos+2);
+            pos+=4;
+            float ox, oy;
+            if(flags & 0x1) //Arguments are words
+            {
+                ox=be16(pos);
+                oy=be16(pos+2);
+                pos+=4;
+            } else {
+                ox=static_cast<signed char>(byte(pos));
+                oy=static_cast<signed char>(byte(pos+1));
+                pos+=2;
+            }
+            if((flags & 0x2)==0) ox=oy=0; //Point matching is not supported
+            float a=1.f, b=0.f, c=0.f, d=1.f; //F2Dot14 numbers
+            if(flags & 0x8) //One scale
+            {
+                a=d=be16(pos)/16384.f;
+                pos+=2;
+            } else if(flags & 0x40) { //X and Y scale
+                a=be16(pos)/16384.f;
+                d=be16(pos+2)/16384.f;
+                pos+=4;
+            } else if(flags & 0x80) { //Two by two matrix
+                a=be16(pos)/16384.f;
+                b=be16(pos+2)/16384.f;
+                c=be16(pos+4)/16384.f;
+                d=be16(pos+6)/16384.f;
+                pos+=8;
+            }
+            Transform u;
+            u.xx=t.xx*a+t.yx*b;
+            u.xy=t.xy*a+t.yy*b;
+            u.yx=t.xx*c+t.yx*d;
+            u.yy=t.xy*c+t.yy*d;
+            map(ox,oy,u.dx,u.dy);
+            addOutline(component,u,path,depth+1);
+        } while((flags & 0x20) && pos<length); //More components
+        return;
+    }
+
+    //Simple glyph, the end point of each contour, the instructions and then
+    //flags, x and y coordinates of the points, each delta encoded
+    unsigned int numPoints=numContours>0 ?
+        static_cast<unsigned short>(be16(10+2*(numContours-1)))+1 : 0;
+    unsigned int pos=10+2*numContours;
+    pos+=2+static_cast<unsigned short>(be16(pos));
+    vector<unsigned char> flags(numPoints);
+    for(unsigned int i=0;i<numPoints;i++)
+    {
+        unsigned char flag=byte(pos++);
+        flags[i]=flag;
+        if(flag & 0x8) //Repeat
+            for(int j=byte(pos++);j>0 && i+1<numPoints;j--) flags[++i]=flag;
+    }
+    vector<Point> points(numPoints);
+    short coord=0;
+    for(unsigned int i=0;i<numPoints;i++)
+    {
+        if(flags[i] & 0x2) //Short delta, sign in bit 4
+        {
+            unsigned char delta=byte(pos++);
+            coord+=flags[i] & 0x10 ? delta : -delta;
+        } else if((flags[i] & 0x10)==0) {
+            coord+=be16(pos);
+            pos+=2;
+        }
+        points[i]=Point(coord,0);
+    }
+    coord=0;
+    for(unsigned int i=0;i<numPoints;i++)
+    {
+        if(flags[i] & 0x4) //Short delta, sign in bit 5
+        {
+            unsigned char delta=byte(pos++);
+            coord+=flags[i] & 0x20 ? delta : -delta;
+        } else if((flags[i] & 0x20)==0) {
+            coord+=be16(pos);
+            pos+=2;
+        }
+        points[i]=Point(points[i].x(),coord);
+    }
+
+    //Points are either on the curve or quadratic control points, two
+    //consecutive control points imply an on curve point halfway
+    unsigned int first=0;
+    for(int i=0;i<numContours;i++)
+    {
+        unsigned int last=static_cast<unsigned short>(be16(10+2*i));
+        if(last>=numPoints || last<first) break;
+        auto onCurve=[&](unsigned int j) { return flags[j] & 0x1; };
+        float sx, sy, cx=0, cy=0, px, py;
+        unsigned int j=first;
+        if(onCurve(first)) map(points[first].x(),points[first].y(),sx,sy);
+        else if(onCurve(last)) map(points[last].x(),points[last].y(),sx,sy);
+        else map((points[first].x()+points[last].x())/2.f,
+                 (points[first].y()+points[last].y())/2.f,sx,sy);
+        unsigned int stop=onCurve(first) || !onCurve(last) ? last+1 : last;
+        if(onCurve(first)) j++;
+        path.moveTo(sx,sy);
+        bool control=false;
+        for(;j<stop;j++)
+        {
+            map(points[j].x(),points[j].y(),px,py);
+            if(onCurve(j))
+            {
+                if(control) path.quadTo(cx,cy,px,py);
+                else path.lineTo(px,py);
+                control=false;
+            } else {
+                if(control) path.quadTo(cx,cy,(cx+px)/2,(cy+py)/2);
+                cx=px;
+                cy=py;
+                control=true;
+            }
+        }
+        if(control) path.quadTo(cx,cy,sx,sy);
+        path.close();
+        first=last+1;
+    }
+}
+
+const unsigned char *TrueTypeFont::getGlyph(unsigned int virtualCodepoint,
+        unsigned char height)
+{
+    reserve(height);
+    //Codepoints not in the single block map to the missing glyph
+    virtualCodepoint=min<unsigned int>(virtualCodepoint,0x110000);
+
+    //Two way set associative cache, replacing the least recently used way
+    unsigned int tag=height<<21 | (virtualCodepoint+1);
+    unsigned int set=(virtualCodepoint+height) % numSets;
+    unsigned int *way=tags+2*set;
+    for(int i=0;i<2;i++)
+    {
+        if(way[i]!=tag) continue;
+        hits++;
+        lastUsed[set]=i;
+        return cache+(2*set+i)*slotSize;
+    }
+    misses++;
+    unsigned int glyphSize=renderGlyph(virtualCodepoint,height);
+    unsigned char *glyph=scratch+maxWidth*cacheHeight;
+    if(glyphSize>slotSize) return glyph;
+    int victim=lastUsed[set]^1;
+    unsigned char *slot=cache+(2*set+victim)*slotSize;
+    lastUsed[set]=victim;
+    way[victim]=tag;
+    memcpy(slot,glyph,glyphSize);
+    return slot;
+}
+
+unsigned int TrueTypeFont::renderGlyph(char32_t codepoint, unsigned char height)
+{
+    unsigned int glyph=codepoint<0x110000 ? glyphIndex(codepoint) : 0;
+    float s=scale(height);
+    int width=min<int>(lround(advanceWidth(glyph)*s),maxWidth);
+    unsigned char *levels=scratch;
+    memset(levels,0,width*height);
+    Path path;
+    Transform t={s,0.f,0.f,-s,0.f,ascender*s};
+    addOutline(glyph,t,path);
+    if(width>0 && !path.empty())
+    {
+        impl::PathRasteriser r(width,height);
+        r.fill(path);
+        r.finish(FillRule::NonZero);
+        short int y;
+        const impl::ShapeSpan *spans;
+        int n;
+        while((n=r.nextRow(y,spans))>=0)
+        {
+            if(y<0 || y>=height) continue;
+            for(int i=0;i<n;i++)
+                for(int x=spans[i].x0;x<=spans[i].x1;x++)
+                    levels[x*height+y]=spans[i].level;
+        }
+    }
+    unsigned char *out=scratch+maxWidth*cacheHeight;
+    out[0]=width;
+    return 1+compressGlyph(levels,width,height,out+1);
+}
+
+void TrueTypeFont::reserve(unsigned char height)
+{
+    if(height<=cacheHeight) return;
+    //Glyphs of all heights share the cache, sized for the largest one
+    cacheHeight=height;
+    maxWidth=max<int>(1,min<int>(lround(maxAdvance*scale(height)),255));
+    delete[] scratch;
+    delete[] cache;
+    delete[] tags;
+    delete[] lastUsed;
+    scratch=new unsigned char[2*maxWidth*height+1];
+    slotSize=1+maxWidth*min<int>(height,slotBytesPerColumn);
+    numSets=max<unsigned int>(1,min<unsigned int>(cacheSize/slotSize/2,0xffff));
+    cache=new unsigned char[2*numSets*slotSize];
+    tags=new unsigned int[2*numSets];
+    lastUsed=new unsigned char[numSets];
+    memset(tags,0,2*numSets*sizeof(unsigned int));
+    memset(lastUsed,0,numSets);
+}
+
+#endif //MXGUI_ENABLE_TRUETYPE
+
+} //namespace mxgui
@@ -0,0 +1,268 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Terraneo Federico                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   As a special exception, if other files instantiate templates or use   *
+ *   macros or inline functions from this file, or you compile this file   *
+ *   and link it with other works to produce a work based on this file,    *
+ *   this file does not by itself cause the resulting work to be covered   *
+ *   by the GNU General Public License. However the source code for this   *
+ *   file must still be made available in accordance with the GNU General  *
+ *   Public License. This exception does not invalidate any other reasons  *
+ *   why a work based on this file might be covered by the GNU General     *
+ *   Public License.                                                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#pragma once
+
+#include "mxgui_settings.h"
+#include "font.h"
+#include "path.h"
+#include <cstdio>
+
+namespace mxgui {
+
+#ifdef MXGUI_ENABLE_TRUETYPE
+
+/**
+ * \ingroup pub_iface
+ * A font rendered at runtime from a TrueType file, only available if
+ * MXGUI_ENABLE_TRUETYPE is defined in mxgui_settings.h.
+ * A single TrueType file provides fonts of any height, so applications that
+ * let the user choose the text size, or that use many sizes of the same
+ * face, need not store one bitmap font per size.
+ * The quadratic outlines of the glyf table are rendered with the
+ * antialiased path rasteriser the first time a glyph is drawn, and kept in
+ * a glyph cache of bounded size in the Font compressed format. Glyphs are
+ * then drawn exactly as those of the fonts generated by fontrendering.
+ *
+ * The file can either be read from a file, in which case only the table
+ * directory is kept in RAM and glyph outlines are read on demand, or
+ * directly from memory, such as a memory mapped external FLASH.
+ * Hinting instructions are ignored, and only the cmap subtable formats 4
+ * and 12 are supported.
+ *
+ * Font height is the distance between the ascender and descender of the
+ * face, glyphs up to 32 pixels high are supported, use Font::scaled() for
+ * larger text. All codepoints are considered in range, those that are not
+ * in the font are drawn with its missing glyph.
+ *
+ * The TrueTypeFont must outlive all the Font objects returned by getFont().
+ * The glyph cache is not protected by a mutex, so the fonts of a
+ * TrueTypeFont should be used by only one Display at a time.
+ */
+class TrueTypeFont : private GlyphSource
+{
+public:
+    /**
+     * Default constructor
+     */
+    TrueTypeFont();
+
+    /**
+     * Construct from a file name
+     * \param filename TrueType file name
+     * \param cacheSize size in bytes of the glyph cache
+     */
+    TrueTypeFont(const char *filename, unsigned int cacheSize);
+
+    /**
+     * Construct from a TrueType file already in memory
+     * \param image pointer to the TrueType file, that must remain valid and
+     * unchanged as long as the font is open
+     * \param size size in bytes of the TrueType file
+     * \param cacheSize size in bytes of the glyph cache
+     */
+    TrueTypeFont(const void *image, unsigned int size, unsigned int cacheSize);
+
+    /**
+     * Open a TrueType file
+     * \param filename TrueType file name
+     * \param cacheSize size in bytes of the glyph cache
+     * \return true on success
+     */
+    bool open(const char *filename, unsigned int cacheSize);
+
+    /**
+     * Open a TrueType file already in memory
+     * \param image pointer to the TrueType file, that must remain valid and
+     * unchanged as long as the font is open
+     * \param size size in bytes of the TrueType file
+     * \param cacheSize size in bytes of the glyph cache
+     * \return true on success
+     */
+    bool open(const void *image, unsigned int size, unsigned int cacheSize);
+
+    /**
+     * Close the TrueType file
+     */
+    void close();
+
+    /**
+     * \return true if the TrueType file is open
+     */
+    bool isOpen() const { return image!=nullptr || f!=nullptr; }
+
+    /**
+     * \param height font height in pixels, from 1 to 32
+     * \return a Font of the given height, or the default font if the
+     * TrueType file is not open
+     */
+    Font getFont(unsigned char height);
+
+    /**
+     * \return number of glyphs found in the cache
+     */
+    unsigned int getCacheHits() const { return hits; }
+
+    /**
+     * \return number of glyphs that had to be rendered
+     */
+    unsigned int getCacheMisses() const { return misses; }
+
+    /**
+     * Destructor
+     */
+    ~TrueTypeFont() { close(); }
+
+private:
+    TrueTypeFont(const TrueTypeFont&)=delete;
+    TrueTypeFont& operator=(const TrueTypeFont&)=delete;
+
+    /**
+     * An affine transform, from glyph outline units to pixels
+     */
+    struct Transform
+    {
+        float xx, xy, yx, yy; ///< Linear part, x'=xx*x+yx*y, y'=xy*x+yy*y
+        float dx, dy;         ///< Translation
+    };
+
+    /**
+     * Find the tables used and allocate the cache
+     * \param cacheSize size in bytes of the glyph cache
+     * \return true on success
+     */
+    bool parseTables(unsigned int cacheSize);
+
+    /**
+     * Read from the TrueType file
+     * \param offset where to read
+     * \param buffer the data read is written here
+     * \param size number of bytes to read
+     * \return true on success
+     */
+    bool read(unsigned int offset, unsigned char *buffer, unsigned int size);
+
+    /**
+     * \param offset where to read
+     * \return a 16 bit big endian number, or 0 on read errors
+     */
+    unsigned short read16(unsigned int offset);
+
+    /**
+     * \param offset where to read
+     * \return a 32 bit big endian number, or 0 on read errors
+     */
+    unsigned int read32(unsigned int offset);
+
+    /**
+     * \param codepoint unicode codepoint
+     * \return the glyph index, 0 being the missing glyph
+     */
+    unsigned int glyphIndex(char32_t codepoint);
+
+    /**
+     * \param glyph glyph index
+     * \return the advance width of the glyph, in outline units
+     */
+    unsigned short advanceWidth(unsigned int glyph);
+
+    /**
+     * Add the outline of a glyph to a path
+     * \param glyph glyph index
+     * \param t transform from outline units to pixels
+     * \param path the outline is added here
+     * \param depth nesting level of composite glyphs
+     */
+    void addOutline(unsigned int glyph, const Transform& t, Path& path,
+            int depth=0);
+
+    /**
+     * Get a glyph, rendering it if not in the cache.
+     * The returned pointer is valid till the next call
+     * \param virtualCodepoint the codepoint, as fonts of a TrueTypeFont have
+     * a single unicode block spanning all codepoints
+     * \param height font height
+     * \return a pointer to the glyph width, followed by the glyph data in
+     * the Font compressed format
+     */
+    const unsigned char *getGlyph(unsigned int virtualCodepoint,
+            unsigned char height) override;
+
+    /**
+     * Render a glyph and compress it in the scratch buffer
+     * \param codepoint glyph codepoint
+     * \param height font height
+     * \return the size of the compressed glyph, including its width
+     */
+    unsigned int renderGlyph(char32_t codepoint, unsigned char height);
+
+    /**
+     * Make sure the cache and scratch buffer have room for glyphs of a
+     * given height, reallocating them if needed
+     * \param height font height
+     */
+    void reserve(unsigned char height);
+
+    /**
+     * \param height font height
+     * \return the size of an outline unit in pixels
+     */
+    float scale(unsigned char height) const
+    {
+        int units=ascender-descender;
+        return static_cast<float>(height)/(units>0 ? units : unitsPerEm);
+    }
+
+    static const int maxHeight=32; ///< Largest supported height
+
+    const unsigned char *image; ///< TrueType file, if in memory
+    unsigned int size;          ///< Size of the TrueType file
+    FILE *f;                    ///< TrueType file, if read from a file
+    unsigned int glyf, loca, hmtx, cmap; ///< Where the tables start
+    unsigned short unitsPerEm;  ///< Outline units in the em square
+    short ascender, descender;  ///< Vertical metrics, from the hhea table
+    unsigned short maxAdvance;  ///< Largest advance width
+    unsigned short numHMetrics; ///< Number of entries in hmtx
+    unsigned short numGlyphs;   ///< Number of glyphs
+    bool longLoca;              ///< True if loca has 32 bit offsets
+    bool cmapFormat12;          ///< True if cmap is format 12, else 4
+    unsigned int cacheSize;     ///< Cache size requested by the user
+    unsigned char cacheHeight;  ///< Largest height the cache is sized for
+    unsigned char maxWidth;     ///< Largest glyph width at cacheHeight
+    unsigned char *scratch;     ///< Glyph rendering buffer
+    unsigned char *cache;       ///< Glyph cache, numSets*2 slots
+    unsigned int *tags;         ///< Height and codepoint+1 of each slot
+    unsigned char *lastUsed;    ///< Last used way of each set
+    unsigned short slotSize;    ///< Size of a cache slot
+    unsigned short numSets;     ///< Number of sets of two slots in the cache
+    unsigned int hits;          ///< Glyphs found in the cache
+    unsigned int misses;        ///< Glyphs rendered
+};
+
+#endif //MXGUI_ENABLE_TRUETYPE
+
+} //namespace mxgui